@@ -5,7 +5,12 @@
 
 #include <MaterialXCore/Document.h>
 
+#include <algorithm>
+#include <atomic>
+#include <limits>
 #include <mutex>
+#include <shared_mutex>
+#include <thread>
 
 MATERIALX_NAMESPACE_BEGIN
 
@@ -29,17 +34,27 @@ class Document::Cache
 {
   public:
     Cache() :
-        valid(false)
+        valid(false),
+        frozen(false),
+        definitionGeneration(nextDefinitionGeneration()),
+        nodeDefGeneration(0)
     {
     }
     ~Cache() { }
 
     void refresh()
     {
+        // Valid caches are read without locking, allowing concurrent readers
+        // of an unmodified document to proceed without contention.
+        if (valid.load(std::memory_order_acquire))
+        {
+            return;
+        }
+
         // Thread synchronization for multiple concurrent readers of a single document.
         std::lock_guard<std::mutex> guard(mutex);
 
-        if (!valid)
+        if (!valid.load(std::memory_order_relaxed))
         {
             // Clear the existing cache.
             portElementMap.clear();
@@ -49,80 +64,241 @@ class Document::Cache
             // Traverse the document to build a new cache.
             for (ElementPtr elem : doc.lock()->traverseTree())
             {
-                const string& nodeName = elem->getAttribute(PortElement::NODE_NAME_ATTRIBUTE);
-                const string& nodeGraphName = elem->getAttribute(PortElement::NODE_GRAPH_ATTRIBUTE);
-                const string& nodeString = elem->getAttribute(NodeDef::NODE_ATTRIBUTE);
-                const string& nodeDefString = elem->getAttribute(InterfaceElement::NODE_DEF_ATTRIBUTE);
+                addElement(elem);
+            }
 
-                if (!nodeName.empty())
+            valid.store(true, std::memory_order_release);
+        }
+    }
+
+    // Throw an exception if the document has been frozen against edits.
+    void requireEditable() const
+    {
+        if (frozen)
+        {
+            throw Exception("Cannot edit a frozen document");
+        }
+    }
+
+    // Record an edit to the definitions of the document, invalidating any
+    // memoized nodedef resolutions that depend on them.
+    void onEditDefinitions()
+    {
+        definitionGeneration.store(nextDefinitionGeneration(), std::memory_order_release);
+    }
+
+    // Generations are drawn from a single global sequence, so the greatest
+    // generation along a chain of data libraries changes whenever any
+    // document in the chain is edited or a library is replaced.
+    static uint64_t nextDefinitionGeneration()
+    {
+        static std::atomic<uint64_t> counter(0);
+        return ++counter;
+    }
+
+    // Add the given element, but not its descendants, to the lookup maps.
+    void addElement(ElementPtr elem)
+    {
+        const string& nodeName = elem->getAttribute(PortElement::NODE_NAME_ATTRIBUTE);
+        const string& nodeGraphName = elem->getAttribute(PortElement::NODE_GRAPH_ATTRIBUTE);
+        const string& nodeString = elem->getAttribute(NodeDef::NODE_ATTRIBUTE);
+        const string& nodeDefString = elem->getAttribute(InterfaceElement::NODE_DEF_ATTRIBUTE);
+
+        if (!nodeName.empty())
+        {
+            PortElementPtr portElem = elem->asA<PortElement>();
+            if (portElem)
+            {
+                portElementMap[portElem->getQualifiedName(nodeName)].push_back(portElem);
+            }
+        }
+        else
+        {
+            if (!nodeGraphName.empty())
+            {
+                PortElementPtr portElem = elem->asA<PortElement>();
+                if (portElem)
                 {
-                    PortElementPtr portElem = elem->asA<PortElement>();
-                    if (portElem)
-                    {
-                        portElementMap[portElem->getQualifiedName(nodeName)].push_back(portElem);
-                    }
+                    portElementMap[portElem->getQualifiedName(nodeGraphName)].push_back(portElem);
                 }
-                else
+            }
+        }
+        if (!nodeString.empty())
+        {
+            NodeDefPtr nodeDef = elem->asA<NodeDef>();
+            if (nodeDef)
+            {
+                nodeDefMap[nodeDef->getQualifiedName(nodeString)].push_back(nodeDef);
+            }
+        }
+        if (!nodeDefString.empty())
+        {
+            InterfaceElementPtr interface = elem->asA<InterfaceElement>();
+            if (interface)
+            {
+                if (interface->isA<NodeGraph>())
                 {
-                    if (!nodeGraphName.empty())
-                    {
-                        PortElementPtr portElem = elem->asA<PortElement>();
-                        if (portElem)
-                        {
-                            portElementMap[portElem->getQualifiedName(nodeGraphName)].push_back(portElem);
-                        }
-                    }
+                    implementationMap[interface->getQualifiedName(nodeDefString)].push_back(interface);
                 }
-                if (!nodeString.empty())
+                ImplementationPtr impl = interface->asA<Implementation>();
+                if (impl)
                 {
-                    NodeDefPtr nodeDef = elem->asA<NodeDef>();
-                    if (nodeDef)
+                    // Check for implementation which specifies a nodegraph as the implementation
+                    const string& nodeGraphString = impl->getNodeGraph();
+                    if (!nodeGraphString.empty())
                     {
-                        nodeDefMap[nodeDef->getQualifiedName(nodeString)].push_back(nodeDef);
+                        NodeGraphPtr nodeGraph = impl->getDocument()->getNodeGraph(nodeGraphString);
+                        if (nodeGraph)
+                            implementationMap[interface->getQualifiedName(nodeDefString)].push_back(nodeGraph);
                     }
-                }
-                if (!nodeDefString.empty())
-                {
-                    InterfaceElementPtr interface = elem->asA<InterfaceElement>();
-                    if (interface)
+                    else
                     {
-                        if (interface->isA<NodeGraph>())
-                        {
-                            implementationMap[interface->getQualifiedName(nodeDefString)].push_back(interface);
-                        }
-                        ImplementationPtr impl = interface->asA<Implementation>();
-                        if (impl)
-                        {
-                            // Check for implementation which specifies a nodegraph as the implementation
-                            const string& nodeGraphString = impl->getNodeGraph();
-                            if (!nodeGraphString.empty())
-                            {
-                                NodeGraphPtr nodeGraph = impl->getDocument()->getNodeGraph(nodeGraphString);
-                                if (nodeGraph)
-                                    implementationMap[interface->getQualifiedName(nodeDefString)].push_back(nodeGraph);
-                            }
-                            else
-                            {
-                                implementationMap[interface->getQualifiedName(nodeDefString)].push_back(interface);
-                            }
-                        }
+                        implementationMap[interface->getQualifiedName(nodeDefString)].push_back(interface);
                     }
                 }
             }
+        }
+    }
+
+    // Remove the given element, but not its descendants, from the lookup maps.
+    // This mirrors addElement, and must be called before any attribute that
+    // contributes to the lookup keys is modified.
+    void removeElement(ElementPtr elem)
+    {
+        const string& nodeName = elem->getAttribute(PortElement::NODE_NAME_ATTRIBUTE);
+        const string& nodeGraphName = elem->getAttribute(PortElement::NODE_GRAPH_ATTRIBUTE);
+        const string& nodeString = elem->getAttribute(NodeDef::NODE_ATTRIBUTE);
+        const string& nodeDefString = elem->getAttribute(InterfaceElement::NODE_DEF_ATTRIBUTE);
 
-            valid = true;
+        if (!nodeName.empty() || !nodeGraphName.empty())
+        {
+            if (elem->isA<PortElement>())
+            {
+                const string& portKey = !nodeName.empty() ? nodeName : nodeGraphName;
+                removeFromMap(portElementMap, elem->getQualifiedName(portKey), elem);
+            }
+        }
+        if (!nodeString.empty() && elem->isA<NodeDef>())
+        {
+            removeFromMap(nodeDefMap, elem->getQualifiedName(nodeString), elem);
+        }
+        if (!nodeDefString.empty())
+        {
+            const string implKey = elem->getQualifiedName(nodeDefString);
+            if (elem->isA<NodeGraph>())
+            {
+                removeFromMap(implementationMap, implKey, elem);
+            }
+            ImplementationPtr impl = elem->asA<Implementation>();
+            if (impl)
+            {
+                const string& nodeGraphString = impl->getNodeGraph();
+                if (!nodeGraphString.empty())
+                {
+                    NodeGraphPtr nodeGraph = impl->getDocument()->getNodeGraph(nodeGraphString);
+                    if (nodeGraph)
+                        removeFromMap(implementationMap, implKey, nodeGraph);
+                }
+                else
+                {
+                    removeFromMap(implementationMap, implKey, elem);
+                }
+            }
+        }
+    }
+
+  private:
+    template <class T> static void removeFromMap(std::unordered_map<string, std::vector<T>>& map, const string& key, ConstElementPtr elem)
+    {
+        auto it = map.find(key);
+        if (it == map.end())
+        {
+            return;
+        }
+        std::vector<T>& entries = it->second;
+        auto entry = std::find_if(entries.begin(), entries.end(), [&elem](const T& value) { return value == elem; });
+        if (entry != entries.end())
+        {
+            entries.erase(entry);
+        }
+        if (entries.empty())
+        {
+            map.erase(it);
         }
     }
 
   public:
     weak_ptr<Document> doc;
     std::mutex mutex;
-    bool valid;
+    std::atomic<bool> valid;
+    bool frozen;
     std::unordered_map<string, std::vector<PortElementPtr>> portElementMap;
     std::unordered_map<string, std::vector<NodeDefPtr>> nodeDefMap;
     std::unordered_map<string, std::vector<InterfaceElementPtr>> implementationMap;
+
+    // Memoized nodedef resolutions, keyed by node signature.
+    std::atomic<uint64_t> definitionGeneration;
+    std::shared_mutex nodeDefMutex;
+    uint64_t nodeDefGeneration;
+    std::unordered_map<string, NodeDefPtr> resolvedNodeDefs;
+
+    // Guards the content hashes cached on elements of the document.
+    std::mutex contentHashMutex;
 };
 
+namespace
+{
+
+// Return true if the given attribute contributes to the keys or values of the
+// document cache.
+bool isCachedAttribute(const string& attrib)
+{
+    return attrib == PortElement::NODE_NAME_ATTRIBUTE ||
+           attrib == PortElement::NODE_GRAPH_ATTRIBUTE ||
+           attrib == NodeDef::NODE_ATTRIBUTE ||
+           attrib == InterfaceElement::NODE_DEF_ATTRIBUTE;
+}
+
+// Return true if the given element is reachable from the root of its document,
+// as opposed to belonging to a subtree that has been removed.
+bool isAttached(ConstElementPtr elem)
+{
+    for (ConstElementPtr parent = elem->getParent(); parent; parent = elem->getParent())
+    {
+        if (parent->getChild(elem->getName()) != elem)
+        {
+            return false;
+        }
+        elem = parent;
+    }
+    return elem->isA<Document>();
+}
+
+// Return true if the given element is a nodedef or belongs to one, so that
+// its edits may alter the resolution of nodes to nodedefs.
+bool isDefinitionElement(ConstElementPtr elem)
+{
+    for (; elem; elem = elem->getParent())
+    {
+        if (elem->getCategory() == NodeDef::CATEGORY)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Return true if changes to the given element may alter the nodegraph
+// references of implementations, which are resolved by name at the
+// document scope.
+bool isDocumentNodeGraph(ConstElementPtr elem)
+{
+    ConstElementPtr parent = elem->getParent();
+    return parent && parent->isA<Document>() && elem->isA<NodeGraph>();
+}
+
+} // anonymous namespace
+
 //
 // Document methods
 //
@@ -141,6 +317,7 @@ void Document::initialize()
 {
     _root = getSelf();
     _cache->doc = getDocument();
+    _layerXIncludes.clear();
 
     clearContent();
     setVersionIntegers(MATERIALX_MAJOR_VERSION, MATERIALX_MINOR_VERSION);
@@ -298,15 +475,159 @@ std::pair<int, int> Document::getVersionIntegers() const
     return InterfaceElement::getVersionIntegers();
 }
 
+void Document::setDataLibrary(ConstDocumentPtr dataLibrary)
+{
+    _cache->requireEditable();
+    _dataLibraries.clear();
+    addDataLibrary(dataLibrary);
+}
+
+void Document::addDataLibrary(ConstDocumentPtr dataLibrary)
+{
+    _cache->requireEditable();
+    if (dataLibrary)
+    {
+        _dataLibraries.push_back(dataLibrary);
+    }
+    _cache->onEditDefinitions();
+}
+
+void Document::setDataLibraries(const vector<ConstDocumentPtr>& dataLibraries)
+{
+    _cache->requireEditable();
+    _dataLibraries.clear();
+    for (ConstDocumentPtr dataLibrary : dataLibraries)
+    {
+        if (dataLibrary)
+        {
+            _dataLibraries.push_back(dataLibrary);
+        }
+    }
+    _cache->onEditDefinitions();
+}
+
+void Document::addLayerXInclude(const string& href)
+{
+    _cache->requireEditable();
+    if (std::find(_layerXIncludes.begin(), _layerXIncludes.end(), href) == _layerXIncludes.end())
+    {
+        _layerXIncludes.push_back(href);
+    }
+}
+
+ElementPtr Document::getEditableChild(const string& name)
+{
+    ElementPtr child = getChild(name);
+    if (child && child->getParent() == getSelf())
+    {
+        return child;
+    }
+    if (child)
+    {
+        return copySharedChild(child);
+    }
+
+    ElementPtr layerChild = getChildOfType<Element>(name);
+    if (!layerChild)
+    {
+        return nullptr;
+    }
+    child = addChildOfCategory(layerChild->getCategory(), name);
+    child->copyContentFrom(layerChild);
+    if (!child->hasSourceUri())
+    {
+        child->setSourceUri(layerChild->getActiveSourceUri());
+    }
+    return child;
+}
+
+ElementPtr Document::getEditableDescendant(const string& namePath)
+{
+    const StringVec nameVec = splitString(namePath, NAME_PATH_SEPARATOR);
+    ElementPtr elem = !nameVec.empty() ? getEditableChild(nameVec[0]) : nullptr;
+    for (size_t i = 1; elem && i < nameVec.size(); i++)
+    {
+        elem = elem->getChild(nameVec[i]);
+    }
+    return elem;
+}
+
+ElementPtr Document::copySharedChild(ElementPtr sharedChild)
+{
+    // Replace the shared child with a copy owned by this document, preserving
+    // its position in the child order.
+    const string& name = sharedChild->getName();
+    int index = getChildIndex(name);
+    unregisterChildElement(sharedChild);
+    ElementPtr child = addChildOfCategory(sharedChild->getCategory(), name);
+    child->copyContentFrom(sharedChild);
+    if (!child->hasSourceUri())
+    {
+        child->setSourceUri(sharedChild->getActiveSourceUri());
+    }
+    setChildIndex(name, index);
+
+    // Shared elements resolve their connections within the shared document,
+    // so copy each shared top-level element with a port connected to the new
+    // copy, allowing the edit to be seen downstream.  Ports are found through
+    // the cache of the shared document, which remains valid while it is
+    // frozen.
+    for (PortElementPtr port : sharedChild->getDocument()->getMatchingPorts(sharedChild->getQualifiedName(name)))
+    {
+        ElementPtr topLevel = port;
+        while (topLevel->getParent() && !topLevel->getParent()->isA<Document>())
+        {
+            topLevel = topLevel->getParent();
+        }
+        if (topLevel->getParent() != getSelf() && getChild(topLevel->getName()) == topLevel)
+        {
+            copySharedChild(topLevel);
+        }
+    }
+
+    return child;
+}
+
+DocumentPtr Document::createShallowClone() const
+{
+    // Shared elements are edited in place by their ordinary mutators, so the
+    // source must be frozen for such edits to fail rather than reach every
+    // clone.
+    if (!isFrozen())
+    {
+        throw Exception("Cannot create a shallow clone of a document that is not frozen");
+    }
+
+    DocumentPtr doc = createDocument<Document>();
+    for (const string& attr : getAttributeNames())
+    {
+        doc->setAttribute(attr, getAttribute(attr));
+    }
+    doc->setSourceUri(getSourceUri());
+    doc->setDataLibraries(getDataLibraries());
+    for (const string& href : getLayerXIncludes())
+    {
+        doc->addLayerXInclude(href);
+    }
+
+    // Share the top-level elements of this document by reference.
+    for (ElementPtr child : getChildren())
+    {
+        doc->registerChildElement(child);
+    }
+    return doc;
+}
+
 vector<PortElementPtr> Document::getMatchingPorts(const string& nodeName) const
 {
     // Refresh the cache.
     _cache->refresh();
 
     // Return all port elements matching the given node name.
-    if (_cache->portElementMap.count(nodeName))
+    auto it = _cache->portElementMap.find(nodeName);
+    if (it != _cache->portElementMap.end())
     {
-        return _cache->portElementMap.at(nodeName);
+        return it->second;
     }
     else
     {
@@ -357,18 +678,27 @@ vector<OutputPtr> Document::getMaterialOutputs() const
 
 vector<NodeDefPtr> Document::getMatchingNodeDefs(const string& nodeName) const
 {
-    // Recurse to data library if present.
-    vector<NodeDefPtr> matchingNodeDefs = hasDataLibrary() ? 
-                                          getDataLibrary()->getMatchingNodeDefs(nodeName) :
-                                          vector<NodeDefPtr>();
+    // Recurse to data library layers if present.
+    vector<NodeDefPtr> matchingNodeDefs;
+    for (ConstDocumentPtr dataLibrary : _dataLibraries)
+    {
+        for (NodeDefPtr nodeDef : dataLibrary->getMatchingNodeDefs(nodeName))
+        {
+            if (!isShadowedLayerElement(nodeDef, dataLibrary))
+            {
+                matchingNodeDefs.push_back(nodeDef);
+            }
+        }
+    }
 
     // Refresh the cache.
     _cache->refresh();
 
     // Return all nodedefs matching the given node name.
-    if (_cache->nodeDefMap.count(nodeName))
+    auto it = _cache->nodeDefMap.find(nodeName);
+    if (it != _cache->nodeDefMap.end())
     {
-        matchingNodeDefs.insert(matchingNodeDefs.end(), _cache->nodeDefMap.at(nodeName).begin(), _cache->nodeDefMap.at(nodeName).end());
+        matchingNodeDefs.insert(matchingNodeDefs.end(), it->second.begin(), it->second.end());
     }
     
     return matchingNodeDefs;
@@ -376,35 +706,350 @@ vector<NodeDefPtr> Document::getMatchingNodeDefs(const string& nodeName) const
 
 vector<InterfaceElementPtr> Document::getMatchingImplementations(const string& nodeDef) const
 {
-    // Recurse to data library if present.
-    vector<InterfaceElementPtr> matchingImplementations = hasDataLibrary() ?
-                                                          getDataLibrary()->getMatchingImplementations(nodeDef) :
-                                                          vector<InterfaceElementPtr>();
-    
+    // Recurse to data library layers if present.
+    vector<InterfaceElementPtr> matchingImplementations;
+    for (ConstDocumentPtr dataLibrary : _dataLibraries)
+    {
+        for (InterfaceElementPtr impl : dataLibrary->getMatchingImplementations(nodeDef))
+        {
+            if (!isShadowedLayerElement(impl, dataLibrary))
+            {
+                matchingImplementations.push_back(impl);
+            }
+        }
+    }
+
     // Refresh the cache.
     _cache->refresh();
 
     // Return all implementations matching the given nodedef string.
-    if (_cache->implementationMap.count(nodeDef))
+    auto it = _cache->implementationMap.find(nodeDef);
+    if (it != _cache->implementationMap.end())
     {
-        matchingImplementations.insert(matchingImplementations.end(), _cache->implementationMap.at(nodeDef).begin(), _cache->implementationMap.at(nodeDef).end());
+        matchingImplementations.insert(matchingImplementations.end(), it->second.begin(), it->second.end());
     }
 
     return matchingImplementations;
 }
 
 bool Document::validate(string* message) const
+{
+    return GraphElement::validate(message);
+}
+
+bool Document::validate(const ValidationOptions& options, ValidationDiagnostics* diagnostics) const
+{
+    // Validate the document element itself on the calling thread, mirroring
+    // the order of the serial validator.
+    ValidationDiagnostics* previousDiagnostics = setValidationDiagnostics(diagnostics);
+    bool res = validateLocal(nullptr);
+    setValidationDiagnostics(previousDiagnostics);
+    if (!res && options.stopAtFirstError)
+    {
+        return false;
+    }
+
+    // Validate top-level elements across worker threads, each collecting
+    // diagnostics into its own buffer.  When stopping at the first error,
+    // elements after the earliest known failure are skipped, while all
+    // elements before it are still validated, so that the result does not
+    // depend on scheduling.
+    const vector<ElementPtr>& children = getChildren();
+    const size_t childCount = children.size();
+    vector<ValidationDiagnostics> childDiagnostics(childCount);
+    vector<char> childResults(childCount, 1);
+    std::atomic<size_t> firstFailure(std::numeric_limits<size_t>::max());
+    auto validateChild = [&](size_t index)
+    {
+        if (options.stopAtFirstError && index > firstFailure.load(std::memory_order_relaxed))
+        {
+            return;
+        }
+        ValidationDiagnostics* previous = setValidationDiagnostics(&childDiagnostics[index]);
+        childResults[index] = children[index]->validate() ? 1 : 0;
+        setValidationDiagnostics(previous);
+        if (!childResults[index])
+        {
+            size_t failure = firstFailure.load(std::memory_order_relaxed);
+            while (index < failure && !firstFailure.compare_exchange_weak(failure, index))
+            {
+            }
+        }
+    };
+
+    unsigned int workerCount = options.workerCount;
+    if (workerCount == 0)
+    {
+        workerCount = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    workerCount = (unsigned int) std::min((size_t) workerCount, childCount);
+    if (workerCount <= 1)
+    {
+        for (size_t i = 0; i < childCount; i++)
+        {
+            validateChild(i);
+        }
+    }
+    else
+    {
+        // Build the lookup cache before any worker reads from it.
+        _cache->refresh();
+
+        std::atomic<size_t> nextChild(0);
+        vector<std::thread> workers;
+        for (unsigned int i = 0; i < workerCount; i++)
+        {
+            workers.emplace_back([&nextChild, &validateChild, childCount]()
+            {
+                for (size_t index = nextChild++; index < childCount; index = nextChild++)
+                {
+                    validateChild(index);
+                }
+            });
+        }
+        for (std::thread& worker : workers)
+        {
+            worker.join();
+        }
+    }
+
+    // Merge results in document order.
+    size_t mergeCount = childCount;
+    if (options.stopAtFirstError && firstFailure.load() < childCount)
+    {
+        mergeCount = firstFailure.load() + 1;
+    }
+    for (size_t i = 0; i < mergeCount; i++)
+    {
+        res = childResults[i] && res;
+        if (diagnostics)
+        {
+            diagnostics->insert(diagnostics->end(), childDiagnostics[i].begin(), childDiagnostics[i].end());
+        }
+    }
+    return res;
+}
+
+bool Document::validateLocal(string* message) const
 {
     bool res = true;
     std::pair<int, int> expectedVersion(MATERIALX_MAJOR_VERSION, MATERIALX_MINOR_VERSION);
     validateRequire(getVersionIntegers() >= expectedVersion, res, message, "Unsupported document version");
     validateRequire(getVersionIntegers() <= expectedVersion, res, message, "Future document version");
-    return GraphElement::validate(message) && res;
+    return GraphElement::validateLocal(message) && res;
 }
 
 void Document::invalidateCache()
 {
+    _cache->requireEditable();
     _cache->valid = false;
+    _cache->onEditDefinitions();
+}
+
+void Document::freeze()
+{
+    _cache->refresh();
+    _cache->frozen = true;
+}
+
+void Document::unfreeze()
+{
+    _cache->frozen = false;
+}
+
+bool Document::isFrozen() const
+{
+    return _cache->frozen;
+}
+
+void Document::onAddElement(ElementPtr elem)
+{
+    _cache->requireEditable();
+    if (isDefinitionElement(elem))
+    {
+        _cache->onEditDefinitions();
+    }
+    if (!_cache->valid)
+    {
+        return;
+    }
+    if (isDocumentNodeGraph(elem))
+    {
+        invalidateCache();
+        return;
+    }
+    if (!isAttached(elem->getParent()))
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> guard(_cache->mutex);
+    for (ElementPtr descendant : elem->traverseTree())
+    {
+        _cache->addElement(descendant);
+    }
+}
+
+void Document::onRemoveElement(ElementPtr elem)
+{
+    _cache->requireEditable();
+    if (isDefinitionElement(elem))
+    {
+        _cache->onEditDefinitions();
+    }
+    if (!_cache->valid)
+    {
+        return;
+    }
+    if (isDocumentNodeGraph(elem))
+    {
+        invalidateCache();
+        return;
+    }
+    if (!isAttached(elem))
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> guard(_cache->mutex);
+    for (ElementPtr descendant : elem->traverseTree())
+    {
+        _cache->removeElement(descendant);
+    }
+}
+
+bool Document::onBeginAttributeEdit(ElementPtr elem, const string& attrib)
+{
+    _cache->requireEditable();
+    if (attrib == NAMESPACE_ATTRIBUTE || isDefinitionElement(elem))
+    {
+        _cache->onEditDefinitions();
+    }
+    if (!_cache->valid)
+    {
+        return false;
+    }
+
+    // Namespaces affect the qualified names of all descendants, so
+    // fall back to a full rebuild of the cache.
+    if (attrib == NAMESPACE_ATTRIBUTE)
+    {
+        invalidateCache();
+        return false;
+    }
+    if ((!attrib.empty() && !isCachedAttribute(attrib)) || !isAttached(elem))
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> guard(_cache->mutex);
+    _cache->removeElement(elem);
+    return true;
+}
+
+void Document::onEndAttributeEdit(ElementPtr elem)
+{
+    if (!_cache->valid)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> guard(_cache->mutex);
+    _cache->addElement(elem);
+}
+
+void Document::onRenameElement(ElementPtr elem)
+{
+    _cache->requireEditable();
+    if (isDefinitionElement(elem))
+    {
+        _cache->onEditDefinitions();
+    }
+    if (_cache->valid && isDocumentNodeGraph(elem))
+    {
+        invalidateCache();
+    }
+}
+
+void Document::onEditElement(ElementPtr elem)
+{
+    _cache->requireEditable();
+    if (isDefinitionElement(elem))
+    {
+        _cache->onEditDefinitions();
+    }
+}
+
+NodeDefPtr Document::getMemoizedNodeDef(const string& signature, const std::function<NodeDefPtr()>& resolve) const
+{
+    uint64_t generation = getDefinitionGeneration();
+    {
+        std::shared_lock<std::shared_mutex> lock(_cache->nodeDefMutex);
+        if (_cache->nodeDefGeneration == generation)
+        {
+            auto it = _cache->resolvedNodeDefs.find(signature);
+            if (it != _cache->resolvedNodeDefs.end())
+            {
+                return it->second;
+            }
+        }
+    }
+
+    // Resolve the nodedef without holding the lock, and store it unless a
+    // newer generation has been stored in the meantime.
+    NodeDefPtr nodeDef = resolve();
+    std::unique_lock<std::shared_mutex> lock(_cache->nodeDefMutex);
+    if (_cache->nodeDefGeneration < generation)
+    {
+        _cache->resolvedNodeDefs.clear();
+        _cache->nodeDefGeneration = generation;
+    }
+    if (_cache->nodeDefGeneration == generation)
+    {
+        _cache->resolvedNodeDefs.emplace(signature, nodeDef);
+    }
+    return nodeDef;
+}
+
+uint64_t Document::getDefinitionGeneration() const
+{
+    uint64_t generation = _cache->definitionGeneration.load(std::memory_order_acquire);
+    for (ConstDocumentPtr dataLibrary : _dataLibraries)
+    {
+        generation = std::max(generation, dataLibrary->getDefinitionGeneration());
+    }
+    return generation;
+}
+
+std::mutex& Document::getContentHashMutex() const
+{
+    return _cache->contentHashMutex;
+}
+
+bool Document::isShadowedLayerElement(ConstElementPtr elem, ConstDocumentPtr layer) const
+{
+    // Shadowing applies to the top-level ancestor of the element.
+    for (ConstElementPtr parent = elem->getParent(); parent && !parent->isA<Document>(); parent = parent->getParent())
+    {
+        elem = parent;
+    }
+    const string& name = elem->getName();
+    if (getChild(name))
+    {
+        return true;
+    }
+    for (ConstDocumentPtr dataLibrary : _dataLibraries)
+    {
+        if (dataLibrary == layer)
+        {
+            break;
+        }
+        if (dataLibrary->getChildOfType<Element>(name))
+        {
+            return true;
+        }
+    }
+    return false;
 }
 
 //
@@ -14,9 +14,12 @@
 #include <MaterialXCore/Look.h>
 #include <MaterialXCore/Node.h>
 
+#include <mutex>
+
 MATERIALX_NAMESPACE_BEGIN
 
 class Document;
+class ValidationOptions;
 
 /// A shared pointer to a Document
 using DocumentPtr = shared_ptr<Document>;
@@ -50,34 +53,109 @@ class MX_CORE_API Document : public GraphElement
     {
         DocumentPtr doc = createDocument<Document>();
         doc->copyContentFrom(getSelf());
-        doc->setDataLibrary(getDataLibrary());
+        doc->setDataLibraries(getDataLibraries());
+        for (const string& href : getLayerXIncludes())
+        {
+            doc->addLayerXInclude(href);
+        }
         return doc;
     }
 
+    /// Create a shallow clone of the document, which shares the content of
+    /// this document by reference rather than copying it.
+    ///
+    /// The clone copies the attributes and data libraries of this document,
+    /// and holds the top-level elements of this document as its own children,
+    /// so that traversal, lookups and serialization of the clone see its full
+    /// content.
+    ///
+    /// Shared elements continue to belong to this document, so their
+    /// getDocument and getParent methods return this document, and as this
+    /// document is frozen, their mutators throw an exception.  Edits are
+    /// applied through getEditableChild or getEditableDescendant, which
+    /// replace the top-level element containing the edit with a copy owned
+    /// by the clone, whose getDocument method returns the clone.  Shared
+    /// top-level elements with ports connected to a copied element are
+    /// copied as well, so that the edit is visible to the elements
+    /// downstream of it.
+    /// @throws Exception if this document is not frozen.
+    DocumentPtr createShallowClone() const;
+
     /// Get a list of source URIs referenced by the document
     StringSet getReferencedSourceUris() const;
 
     /// @name Data Libraries
     /// @{
 
-    /// Store a reference to a data library in this document.
-    void setDataLibrary(ConstDocumentPtr dataLibrary)
-    {
-        _dataLibrary = dataLibrary;
-    }
+    /// Store a reference to a data library in this document, replacing any
+    /// existing data library layers.  Passing a null pointer removes all
+    /// data library layers.
+    void setDataLibrary(ConstDocumentPtr dataLibrary);
+
+    /// Add a data library layer to this document.
+    ///
+    /// Data library layers are shared by reference rather than copied, and
+    /// their contents are visible through the lookup methods of this document,
+    /// including getChildOfType, getChildrenOfType, getMatchingNodeDefs,
+    /// getMatchingImplementations, and XInclude resolution when reading.
+    /// Elements of this document shadow layer elements of the same name, and
+    /// earlier layers shadow later ones.  Layers may be shared by many
+    /// documents, and should not be edited while referenced, which can be
+    /// enforced with Document::freeze.
+    void addDataLibrary(ConstDocumentPtr dataLibrary);
+
+    /// Set the data library layers of this document, in priority order.
+    void setDataLibraries(const vector<ConstDocumentPtr>& dataLibraries);
 
     /// Return true if this document has a data library.
     bool hasDataLibrary() const
     {
-        return (_dataLibrary != nullptr);
+        return !_dataLibraries.empty();
     }
 
-    /// Return the data library, if any, referenced by this document.
+    /// Return the first data library layer, if any, referenced by this document.
     ConstDocumentPtr getDataLibrary() const
     {
-        return _dataLibrary;
+        return _dataLibraries.empty() ? ConstDocumentPtr() : _dataLibraries[0];
+    }
+
+    /// Return all data library layers referenced by this document, in
+    /// priority order.
+    const vector<ConstDocumentPtr>& getDataLibraries() const
+    {
+        return _dataLibraries;
+    }
+
+    /// Record an XInclude reference whose contents were provided by a data
+    /// library layer rather than copied into this document when reading,
+    /// so that the reference may be written again when serializing.
+    void addLayerXInclude(const string& href);
+
+    /// Return the XInclude references provided by data library layers.
+    const StringVec& getLayerXIncludes() const
+    {
+        return _layerXIncludes;
     }
 
+    /// Return the top-level element with the given name in an editable form.
+    /// If the element is provided by a data library layer rather than by this
+    /// document, then it is first copied into this document, where it shadows
+    /// the shared layer element.  This allows a layer element to be edited
+    /// without copying the remainder of its layer.  If the element is shared
+    /// from the source of a shallow clone, then it is replaced in place with
+    /// a copy owned by this document.
+    /// @return The editable element, or nullptr if no element with the given
+    ///    name is found.
+    ElementPtr getEditableChild(const string& name);
+
+    /// Return the descendant element with the given name path in an editable
+    /// form.  If the top-level ancestor of the element is provided by a data
+    /// library layer or shared from the source of a shallow clone, then only
+    /// that top-level element is copied into this document.
+    /// @return The editable element, or nullptr if no element with the given
+    ///    name path is found.
+    ElementPtr getEditableDescendant(const string& namePath);
+
     /// Import the given data library into this document.
     /// The contents of the data library are copied into this one, and
     /// are assigned the source URI of the library.
@@ -679,6 +757,19 @@ class MX_CORE_API Document : public GraphElement
     /// @return True if the document passes all tests, false otherwise.
     bool validate(string* message = nullptr) const override;
 
+    /// Validate that the given document is consistent with the MaterialX
+    /// specification, distributing the top-level elements of the document
+    /// across worker threads.
+    ///
+    /// Each worker records its findings separately, and findings are merged
+    /// in document order, so that the returned diagnostics match those of
+    /// the serial validator for any number of workers.
+    /// @param options The options for this validation.
+    /// @param diagnostics An optional output vector, to which a structured
+    ///    diagnostic will be appended for each error.
+    /// @return True if the document passes all tests, false otherwise.
+    bool validate(const ValidationOptions& options, ValidationDiagnostics* diagnostics = nullptr) const;
+
     /// @}
     /// @name Utility
     /// @{
@@ -686,6 +777,20 @@ class MX_CORE_API Document : public GraphElement
     /// Invalidate cached data for optimized lookups within the given document.
     void invalidateCache();
 
+    /// Freeze the document against further edits.  The cached data for
+    /// optimized lookups is built eagerly, and lookups from concurrent
+    /// threads then proceed without locking.  Any subsequent edit of a frozen
+    /// document throws an exception, including edits of names, categories,
+    /// attributes, source URIs, and the addition, removal or reordering of
+    /// child elements.
+    void freeze();
+
+    /// Unfreeze the document, allowing further edits.
+    void unfreeze();
+
+    /// Return true if the document has been frozen against edits.
+    bool isFrozen() const;
+
     /// @}
 
     //
@@ -695,19 +800,95 @@ class MX_CORE_API Document : public GraphElement
     [[deprecated]] NodeDefPtr addNodeDefFromGraph(NodeGraphPtr nodeGraph, const string& nodeDefName, const string& node, const string& version,
                                                   bool isDefaultVersion, const string& nodeGroup, const string& newGraphName);
 
+  protected:
+    bool validateLocal(string* message) const override;
+
   public:
     static const string CATEGORY;
     static const string CMS_ATTRIBUTE;
     static const string CMS_CONFIG_ATTRIBUTE;
 
+  private:
+    friend class Element;
+    friend class Node;
+
+    // Incrementally update cached lookup data in response to the addition
+    // or removal of the given element and its descendants.  Additions are
+    // reported before the element is registered with its parent.
+    void onAddElement(ElementPtr elem);
+    void onRemoveElement(ElementPtr elem);
+
+    // Incrementally update cached lookup data in response to an edit of the
+    // given attribute, where an empty attribute name denotes an edit of all
+    // attributes.  If the begin call returns true, then the end call must be
+    // made once the edit is complete.
+    bool onBeginAttributeEdit(ElementPtr elem, const string& attrib);
+    void onEndAttributeEdit(ElementPtr elem);
+
+    // Update cached lookup data in response to the renaming of the given element.
+    void onRenameElement(ElementPtr elem);
+
+    // Update cached lookup data in response to any other edit of the given
+    // element, such as a change of its category, source URI or child order.
+    void onEditElement(ElementPtr elem);
+
+    // Return the memoized nodedef for the given node signature, calling the
+    // given function to resolve it on a cache miss.  Memoized nodedefs are
+    // discarded whenever the definitions in this document or its data
+    // library are edited.
+    NodeDefPtr getMemoizedNodeDef(const string& signature, const std::function<NodeDefPtr()>& resolve) const;
+
+    // Return a value that changes whenever the definitions in this document
+    // or its data library are edited.
+    uint64_t getDefinitionGeneration() const;
+
+    // Return the mutex guarding the cached content hashes of elements in
+    // this document.
+    std::mutex& getContentHashMutex() const;
+
+    // Return true if the given element, found through the given data library
+    // layer, is shadowed by an element of this document or of a layer with
+    // higher priority.
+    bool isShadowedLayerElement(ConstElementPtr elem, ConstDocumentPtr layer) const;
+
+    // Replace the given top-level element, shared from the document of a
+    // shallow clone, with a copy owned by this document, along with the
+    // shared elements connected downstream of it.
+    ElementPtr copySharedChild(ElementPtr sharedChild);
+
   private:
     class Cache;
 
   private:
-    ConstDocumentPtr _dataLibrary;
+    vector<ConstDocumentPtr> _dataLibraries;
+    StringVec _layerXIncludes;
     std::unique_ptr<Cache> _cache;
 };
 
+/// @class ValidationOptions
+/// A set of options for validating a document in parallel.
+class MX_CORE_API ValidationOptions
+{
+  public:
+    ValidationOptions() :
+        workerCount(1),
+        stopAtFirstError(false)
+    {
+    }
+    ~ValidationOptions() { }
+
+    /// The number of worker threads across which top-level elements are
+    /// distributed.  Zero selects the hardware concurrency of the system.
+    /// Default is 1.
+    unsigned int workerCount;
+
+    /// If true, then validation stops after the first element that fails,
+    /// and only the errors up to and including that element are reported.
+    /// Errors are reported for whole top-level elements, so the first
+    /// failing element may contribute several diagnostics.  Default is false.
+    bool stopAtFirstError;
+};
+
 /// Create a new Document.
 /// @relates Document
 MX_CORE_API DocumentPtr createDocument();
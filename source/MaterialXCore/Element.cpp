@@ -9,6 +9,8 @@
 #include <MaterialXCore/Util.h>
 
 #include <iterator>
+#include <mutex>
+#include <unordered_set>
 
 MATERIALX_NAMESPACE_BEGIN
 
@@ -42,6 +44,63 @@ const string ValueElement::UNIFORM_ATTRIBUTE = "uniform";
 
 Element::CreatorMap Element::_creatorMap;
 
+namespace
+{
+
+// The destination, if any, for structured diagnostics on the calling thread.
+thread_local ValidationDiagnostics* validationDiagnostics = nullptr;
+
+// Return a nonzero hash of the given equivalence criteria.
+size_t getEquivalenceOptionsHash(const ElementEquivalenceOptions& options)
+{
+    size_t hash = 0;
+    hashCombine(hash, options.performValueComparisons);
+    hashCombine(hash, (int) options.floatFormat);
+    hashCombine(hash, options.floatPrecision);
+    for (const string& attr : options.attributeExclusionList)
+    {
+        hashCombine(hash, attr);
+    }
+    return hash ? hash : 1;
+}
+
+// Return a hash of the name, category, and attributes of the given element,
+// excluding its descendants.
+size_t getLocalContentHash(const Element& elem, const ElementEquivalenceOptions& options)
+{
+    size_t hash = 0;
+    hashCombine(hash, elem.getName());
+    hashCombine(hash, elem.getCategory());
+
+    // Ignore attribute ordering by sorting names.
+    StringVec attributeNames = elem.getAttributeNames();
+    std::sort(attributeNames.begin(), attributeNames.end());
+    for (const string& attr : attributeNames)
+    {
+        if (options.attributeExclusionList.count(attr))
+        {
+            continue;
+        }
+        hashCombine(hash, attr);
+        hashCombine(hash, elem.getAttributeHash(attr, options));
+    }
+    return hash;
+}
+
+// Return true if the children of the given element are matched by name
+// rather than by position in functional equivalence.
+bool hasUnorderedChildren(const Element& elem)
+{
+    if (dynamic_cast<const Document*>(&elem))
+    {
+        return true;
+    }
+    const NodeGraph* nodeGraph = dynamic_cast<const NodeGraph*>(&elem);
+    return nodeGraph && !nodeGraph->getNodeDef();
+}
+
+} // anonymous namespace
+
 //
 // Element methods
 //
@@ -55,12 +114,10 @@ bool Element::operator==(const Element& rhs) const
     }
 
     // Compare attributes.
-    if (getAttributeNames() != rhs.getAttributeNames())
-        return false;
-    for (const string& attr : rhs.getAttributeNames())
+    if (_attributeNames != rhs._attributeNames ||
+        _attributeValues != rhs._attributeValues)
     {
-        if (getAttribute(attr) != rhs.getAttribute(attr))
-            return false;
+        return false;
     }
 
     // Compare children.
@@ -81,6 +138,17 @@ bool Element::operator!=(const Element& rhs) const
     return !(*this == rhs);
 }
 
+void Element::setCategory(const string& category)
+{
+    // A change of category may add or remove a definition, so the
+    // document is notified both before and after the change.
+    DocumentPtr doc = getDocument();
+    doc->onEditElement(getSelf());
+    _category = category;
+    doc->onEditElement(getSelf());
+    invalidateContentHash();
+}
+
 void Element::setName(const string& name)
 {
     ElementPtr parent = getParent();
@@ -89,7 +157,7 @@ void Element::setName(const string& name)
         throw Exception("Element name is not unique at the given scope: " + name);
     }
 
-    getDocument()->invalidateCache();
+    getDocument()->onRenameElement(getSelf());
 
     if (parent)
     {
@@ -97,6 +165,7 @@ void Element::setName(const string& name)
         parent->_childMap[name] = getSelf();
     }
     _name = name;
+    invalidateContentHash();
 }
 
 string Element::getNamePath(ConstElementPtr relativeTo) const
@@ -135,19 +204,62 @@ ElementPtr Element::getDescendant(const string& namePath) const
 
 void Element::registerChildElement(ElementPtr child)
 {
-    getDocument()->invalidateCache();
+    getDocument()->onAddElement(child);
 
     _childMap[child->getName()] = child;
     _childOrder.push_back(child);
+    invalidateContentHash();
 }
 
 void Element::unregisterChildElement(ElementPtr child)
 {
-    getDocument()->invalidateCache();
+    getDocument()->onRemoveElement(child);
 
     _childMap.erase(child->getName());
-    _childOrder.erase(
-        std::find(_childOrder.begin(), _childOrder.end(), child));
+
+    // Search from the back, where recently added children are found.
+    vector<ElementPtr>::reverse_iterator it = std::find(_childOrder.rbegin(), _childOrder.rend(), child);
+    _childOrder.erase(std::next(it).base());
+    invalidateContentHash();
+}
+
+void Element::replaceChildren(const std::unordered_map<ElementPtr, vector<ElementPtr>>& replacements)
+{
+    getDocument()->onEditElement(getSelf());
+
+    std::unordered_set<ElementPtr> movedChildren;
+    for (const auto& pair : replacements)
+    {
+        movedChildren.insert(pair.second.begin(), pair.second.end());
+    }
+
+    // Build the new child order, with replaced children gathered at the end
+    // in reverse order, so that each is found immediately when unregistered.
+    vector<ElementPtr> childOrder;
+    vector<ElementPtr> replacedChildren;
+    childOrder.reserve(_childOrder.size() + replacements.size());
+    for (ElementPtr child : _childOrder)
+    {
+        auto it = replacements.find(child);
+        if (it != replacements.end())
+        {
+            childOrder.insert(childOrder.end(), it->second.begin(), it->second.end());
+            replacedChildren.push_back(child);
+        }
+        else if (!movedChildren.count(child))
+        {
+            childOrder.push_back(child);
+        }
+    }
+    childOrder.insert(childOrder.end(), replacedChildren.rbegin(), replacedChildren.rend());
+    _childOrder = std::move(childOrder);
+    invalidateContentHash();
+    onChildOrderEdit();
+
+    for (ElementPtr child : replacedChildren)
+    {
+        unregisterChildElement(child);
+    }
 }
 
 int Element::getChildIndex(const string& name) const
@@ -175,8 +287,11 @@ void Element::setChildIndex(const string& name, int index)
         throw Exception("Invalid child index");
     }
 
+    getDocument()->onEditElement(getSelf());
     _childOrder.erase(it);
     _childOrder.insert(_childOrder.begin() + (size_t) index, child);
+    invalidateContentHash();
+    onChildOrderEdit();
 }
 
 void Element::removeChild(const string& name)
@@ -190,27 +305,47 @@ void Element::removeChild(const string& name)
     unregisterChildElement(it->second);
 }
 
-void Element::setAttribute(const string& attrib, const string& value)
+void Element::setAttribute(const string& attrib, string value)
 {
-    getDocument()->invalidateCache();
+    DocumentPtr doc = getDocument();
+    bool reindex = doc->onBeginAttributeEdit(getSelf(), attrib);
 
-    if (!_attributeMap.count(attrib))
+    StringVec::iterator it = std::find(_attributeNames.begin(), _attributeNames.end(), attrib);
+    if (it != _attributeNames.end())
+    {
+        _attributeValues[it - _attributeNames.begin()] = std::move(value);
+    }
+    else
     {
-        _attributeOrder.push_back(attrib);
+        _attributeNames.push_back(attrib);
+        _attributeValues.push_back(std::move(value));
+    }
+    invalidateContentHash();
+    onAttributeEdit(attrib);
+
+    if (reindex)
+    {
+        doc->onEndAttributeEdit(getSelf());
     }
-    _attributeMap[attrib] = value;
 }
 
 void Element::removeAttribute(const string& attrib)
 {
-    StringMap::iterator it = _attributeMap.find(attrib);
-    if (it != _attributeMap.end())
+    StringVec::iterator it = std::find(_attributeNames.begin(), _attributeNames.end(), attrib);
+    if (it != _attributeNames.end())
     {
-        getDocument()->invalidateCache();
+        DocumentPtr doc = getDocument();
+        bool reindex = doc->onBeginAttributeEdit(getSelf(), attrib);
 
-        _attributeMap.erase(it);
-        _attributeOrder.erase(
-            std::find(_attributeOrder.begin(), _attributeOrder.end(), attrib));
+        _attributeValues.erase(_attributeValues.begin() + (it - _attributeNames.begin()));
+        _attributeNames.erase(it);
+        invalidateContentHash();
+        onAttributeEdit(attrib);
+
+        if (reindex)
+        {
+            doc->onEndAttributeEdit(getSelf());
+        }
     }
 }
 
@@ -280,15 +415,22 @@ ElementPtr Element::changeChildCategory(ElementPtr child, const string& category
 
 template <class T> shared_ptr<T> Element::getChildOfType(const string& name) const
 {
-    ElementPtr child;
-    ConstDocumentPtr doc = asA<Document>();
-    if (doc && doc->hasDataLibrary())
-    {
-        child = doc->getDataLibrary()->getChild(name);
-    }
+    // Elements of a document shadow those of its data library layers.
+    ElementPtr child = getChild(name);
     if (!child)
     {
-        child = getChild(name);
+        ConstDocumentPtr doc = asA<Document>();
+        if (doc)
+        {
+            for (ConstDocumentPtr dataLibrary : doc->getDataLibraries())
+            {
+                child = dataLibrary->getChildOfType<Element>(name);
+                if (child)
+                {
+                    break;
+                }
+            }
+        }
     }
     return child ? child->asA<T>() : shared_ptr<T>();
 }
@@ -297,9 +439,18 @@ template <class T> vector<shared_ptr<T>> Element::getChildrenOfType(const string
 {
     vector<shared_ptr<T>> children;
     ConstDocumentPtr doc = asA<Document>();
-    if (doc && doc->hasDataLibrary())
+    if (doc)
     {
-        children = doc->getDataLibrary()->getChildrenOfType<T>(category);
+        for (ConstDocumentPtr dataLibrary : doc->getDataLibraries())
+        {
+            for (shared_ptr<T> child : dataLibrary->getChildrenOfType<T>(category))
+            {
+                if (!doc->isShadowedLayerElement(child, dataLibrary))
+                {
+                    children.push_back(child);
+                }
+            }
+        }
     }
     for (ElementPtr child : _childOrder)
     {
@@ -333,6 +484,12 @@ ConstElementPtr Element::getRoot() const
     return root;
 }
 
+void Element::setSourceUri(const string& sourceUri)
+{
+    getDocument()->onEditElement(getSelf());
+    _sourceUri = sourceUri;
+}
+
 DocumentPtr Element::getDocument()
 {
     return getRoot()->asA<Document>();
@@ -497,6 +654,98 @@ bool Element::isAttributeEquivalent(ConstElementPtr rhs, const string& attribute
     return true;
 }
 
+size_t Element::getContentHash(const ElementEquivalenceOptions& options) const
+{
+    size_t optionsKey = getEquivalenceOptionsHash(options);
+    ConstDocumentPtr doc = std::dynamic_pointer_cast<const Document>(_root.lock());
+    if (!doc)
+    {
+        return computeContentHash(options, optionsKey, getRoot());
+    }
+
+    // The children of node graphs are hashed by name or by position depending
+    // on whether a nodedef is found for the graph, so cached hashes are keyed
+    // by the definition generation of the document as well.
+    hashCombine(optionsKey, doc->getDefinitionGeneration());
+    optionsKey = optionsKey ? optionsKey : 1;
+
+    // Cached hashes are shared by all readers of the document, so they are
+    // computed and stored under its lock.
+    std::lock_guard<std::mutex> guard(doc->getContentHashMutex());
+    return computeContentHash(options, optionsKey, doc);
+}
+
+size_t Element::getContentHash() const
+{
+    return getContentHash(ElementEquivalenceOptions());
+}
+
+size_t Element::getAttributeHash(const string& attributeName, const ElementEquivalenceOptions& /*options*/) const
+{
+    return std::hash<string>()(getAttribute(attributeName));
+}
+
+size_t Element::computeContentHash(const ElementEquivalenceOptions& options, size_t optionsKey, const ConstElementPtr& cacheRoot) const
+{
+    // Elements shared from another document, as in a shallow clone, are
+    // hashed without reading or writing their cached hashes.
+    bool cacheable = (this == cacheRoot.get()) ||
+                     (!_root.owner_before(cacheRoot) && !cacheRoot.owner_before(_root));
+    if (cacheable && _contentHashKey == optionsKey)
+    {
+        return _contentHash;
+    }
+
+    size_t hash = getLocalContentHash(*this, options);
+
+    // Children of compound graphs are compared by name rather than by
+    // position, so their hashes are combined independently of order.
+    bool unordered = hasUnorderedChildren(*this);
+    size_t unorderedHash = 0;
+    for (const ElementPtr& child : _childOrder)
+    {
+        if (child->getCategory() == CommentElement::CATEGORY)
+        {
+            continue;
+        }
+        size_t childHash = child->computeContentHash(options, optionsKey, cacheRoot);
+        if (unordered)
+        {
+            unorderedHash += childHash;
+        }
+        else
+        {
+            hashCombine(hash, childHash);
+        }
+    }
+    if (unordered)
+    {
+        hashCombine(hash, unorderedHash);
+    }
+
+    if (cacheable)
+    {
+        _contentHash = hash;
+        _contentHashKey = optionsKey;
+    }
+    return hash;
+}
+
+void Element::invalidateContentHash()
+{
+    // A cached hash on an element implies cached hashes on its descendants,
+    // so the walk stops at the first ancestor without a cached hash.
+    if (!_contentHashKey)
+    {
+        return;
+    }
+    _contentHashKey = 0;
+    for (ElementPtr parent = getParent(); parent && parent->_contentHashKey; parent = parent->getParent())
+    {
+        parent->_contentHashKey = 0;
+    }
+}
+
 TreeIterator Element::traverseTree() const
 {
     return TreeIterator(getSelfNonConst());
@@ -517,6 +766,12 @@ ElementPtr Element::getUpstreamElement(size_t index) const
     return getUpstreamEdge(index).getUpstreamElement();
 }
 
+std::pair<Element*, Element*> Element::getUpstreamEdgeElements(size_t index) const
+{
+    Edge edge = getUpstreamEdge(index);
+    return { edge.getConnectingElement().get(), edge.getUpstreamElement().get() };
+}
+
 InheritanceIterator Element::traverseInheritance() const
 {
     return InheritanceIterator(getSelf());
@@ -524,11 +779,24 @@ InheritanceIterator Element::traverseInheritance() const
 
 void Element::copyContentFrom(const ConstElementPtr& source)
 {
-    getDocument()->invalidateCache();
+    // Namespace changes affect the qualified names of all descendants.
+    DocumentPtr doc = getDocument();
+    if (hasNamespace() || source->hasNamespace())
+    {
+        doc->invalidateCache();
+    }
+    bool reindex = doc->onBeginAttributeEdit(getSelf(), EMPTY_STRING);
 
     _sourceUri = source->_sourceUri;
-    _attributeMap = source->_attributeMap;
-    _attributeOrder = source->_attributeOrder;
+    _attributeNames = source->_attributeNames;
+    _attributeValues = source->_attributeValues;
+    invalidateContentHash();
+    onAttributeEdit(EMPTY_STRING);
+
+    if (reindex)
+    {
+        doc->onEndAttributeEdit(getSelf());
+    }
 
     for (auto child : source->getChildren())
     {
@@ -552,13 +820,25 @@ void Element::clearContent()
     getDocument()->invalidateCache();
 
     _sourceUri.clear();
-    _attributeMap.clear();
-    _attributeOrder.clear();
+    _attributeNames.clear();
+    _attributeValues.clear();
     _childMap.clear();
     _childOrder.clear();
+    invalidateContentHash();
+    onAttributeEdit(EMPTY_STRING);
 }
 
 bool Element::validate(string* message) const
+{
+    bool res = validateLocal(message);
+    for (auto child : getChildren())
+    {
+        res = child->validate(message) && res;
+    }
+    return res;
+}
+
+bool Element::validateLocal(string* message) const
 {
     bool res = true;
     validateRequire(isValidName(getName()), res, message, "Invalid element name");
@@ -567,10 +847,6 @@ bool Element::validate(string* message) const
         bool validInherit = getInheritsFrom() && getInheritsFrom()->getCategory() == getCategory();
         validateRequire(validInherit, res, message, "Invalid element inheritance");
     }
-    for (auto child : getChildren())
-    {
-        res = child->validate(message) && res;
-    }
     validateRequire(!hasInheritanceCycle(), res, message, "Cycle in element inheritance chain");
     return res;
 }
@@ -629,9 +905,20 @@ void Element::validateRequire(bool expression, bool& res, string* message, const
         {
             *message += errorDesc + ": " + asString() + "\n";
         }
+        if (validationDiagnostics)
+        {
+            validationDiagnostics->push_back({ getNamePath(), errorDesc, errorDesc + ": " + asString() });
+        }
     }
 }
 
+ValidationDiagnostics* Element::setValidationDiagnostics(ValidationDiagnostics* diagnostics)
+{
+    ValidationDiagnostics* previous = validationDiagnostics;
+    validationDiagnostics = diagnostics;
+    return previous;
+}
+
 //
 // TypedElement methods
 //
@@ -660,20 +947,42 @@ string ValueElement::getResolvedValueString(StringResolverPtr resolver) const
 
 ValuePtr ValueElement::getValue() const
 {
+    ConstValuePtr cachedValue = std::atomic_load(&_cachedValue);
+    if (cachedValue)
+        return cachedValue->copy();
     if (!hasValue())
         return ValuePtr();
 
-    return Value::createValueFromStrings(getValueString(), getType(), getDocument()->getTypeDef(getType()));
+    TypeDefPtr typeDef = getDocument()->getTypeDef(getType());
+    ValuePtr value = Value::createValueFromStrings(getValueString(), getType(), typeDef);
+
+    // Aggregate values depend on the members of their type definitions, which
+    // may be edited independently of this element, so are not cached.
+    if (value && (!typeDef || typeDef->getMembers().empty()))
+    {
+        std::atomic_store(&_cachedValue, ConstValuePtr(value->copy()));
+    }
+    return value;
 }
 
 ValuePtr ValueElement::getResolvedValue(StringResolverPtr resolver) const
 {
     if (!hasValue())
         return ValuePtr();
+    if (!StringResolver::isResolvedType(getType()))
+        return getValue();
 
     return Value::createValueFromStrings(getResolvedValueString(resolver), getType(), getDocument()->getTypeDef(getType()));
 }
 
+void ValueElement::onAttributeEdit(const string& attrib)
+{
+    if (attrib.empty() || attrib == VALUE_ATTRIBUTE || attrib == TYPE_ATTRIBUTE)
+    {
+        std::atomic_store(&_cachedValue, ConstValuePtr());
+    }
+}
+
 ValuePtr ValueElement::getDefaultValue() const
 {
     ConstElementPtr parent = getParent();
@@ -782,6 +1091,28 @@ bool ValueElement::isAttributeEquivalent(ConstElementPtr rhs, const string& attr
     return true;
 }
 
+size_t ValueElement::getAttributeHash(const string& attributeName, const ElementEquivalenceOptions& options) const
+{
+    if (options.performValueComparisons)
+    {
+        bool isUiAttribute = attributeName == UI_MIN_ATTRIBUTE || attributeName == UI_MAX_ATTRIBUTE ||
+                             attributeName == UI_SOFT_MIN_ATTRIBUTE || attributeName == UI_SOFT_MAX_ATTRIBUTE ||
+                             attributeName == UI_STEP_ATTRIBUTE;
+        if (attributeName == VALUE_ATTRIBUTE || isUiAttribute)
+        {
+            // Hash values in their formatted form, matching the comparison
+            // of formatted values in isAttributeEquivalent.
+            ScopedFloatFormatting fmt(options.floatFormat, options.floatPrecision);
+            ValuePtr value = isUiAttribute ? Value::createValueFromStrings(getAttribute(attributeName), getType()) : getValue();
+            if (value)
+            {
+                return std::hash<string>()(value->getValueString());
+            }
+        }
+    }
+    return Element::getAttributeHash(attributeName, options);
+}
+
 bool ValueElement::validate(string* message) const
 {
     bool res = true;
@@ -882,11 +1213,11 @@ string StringResolver::resolve(const string& str, const string& type) const
 {
     if (type == FILENAME_TYPE_STRING)
     {
-        return _filePrefix + replaceSubstrings(str, _filenameMap);
+        return _filePrefix + _filenameReplacer.apply(str);
     }
     if (type == GEOMNAME_TYPE_STRING)
     {
-        return _geomPrefix + replaceSubstrings(str, _geomNameMap);
+        return _geomPrefix + _geomNameReplacer.apply(str);
     }
     return str;
 }
@@ -911,6 +1242,172 @@ bool targetStringsMatch(const string& target1, const string& target2)
     return !matches.empty();
 }
 
+namespace
+{
+
+void diffElementTrees(ConstElementPtr lhs, ConstElementPtr rhs, const ElementEquivalenceOptions& options, ElementDiff& diff)
+{
+    if (lhs->getContentHash(options) == rhs->getContentHash(options))
+    {
+        return;
+    }
+
+    bool modified = getLocalContentHash(*lhs, options) != getLocalContentHash(*rhs, options);
+
+    // Match children by name, recursing into children present in both trees.
+    StringVec lhsNames, rhsNames;
+    for (ElementPtr lhsChild : lhs->getChildren())
+    {
+        if (lhsChild->getCategory() == CommentElement::CATEGORY)
+        {
+            continue;
+        }
+        ElementPtr rhsChild = rhs->getChild(lhsChild->getName());
+        if (!rhsChild || rhsChild->getCategory() != lhsChild->getCategory())
+        {
+            diff.removed.push_back(lhsChild->getNamePath());
+            continue;
+        }
+        lhsNames.push_back(lhsChild->getName());
+        diffElementTrees(lhsChild, rhsChild, options, diff);
+    }
+    for (ElementPtr rhsChild : rhs->getChildren())
+    {
+        if (rhsChild->getCategory() == CommentElement::CATEGORY)
+        {
+            continue;
+        }
+        ElementPtr lhsChild = lhs->getChild(rhsChild->getName());
+        if (!lhsChild || lhsChild->getCategory() != rhsChild->getCategory())
+        {
+            diff.added.push_back(rhsChild->getNamePath());
+            continue;
+        }
+        rhsNames.push_back(rhsChild->getName());
+    }
+
+    // Report reordered children where order is significant.
+    if (!hasUnorderedChildren(*lhs) && lhsNames != rhsNames)
+    {
+        modified = true;
+    }
+    if (modified)
+    {
+        diff.modified.push_back(lhs->getNamePath());
+    }
+}
+
+// Return a string resolver for the scope of the given element, extending the
+// resolver for the scope of its parent.
+StringResolverPtr createScopedResolver(StringResolverPtr parentScope, ConstElementPtr elem)
+{
+    ConstInterfaceElementPtr interfaceElem = elem->asA<InterfaceElement>();
+    if (!elem->hasFilePrefix() && !elem->hasGeomPrefix() && !interfaceElem)
+    {
+        return parentScope;
+    }
+
+    StringResolverPtr scope = std::make_shared<StringResolver>(*parentScope);
+    if (elem->hasFilePrefix())
+    {
+        scope->setFilePrefix(elem->getFilePrefix());
+    }
+    if (elem->hasGeomPrefix())
+    {
+        scope->setGeomPrefix(elem->getGeomPrefix());
+    }
+    if (interfaceElem)
+    {
+        // Tokens override those of enclosing scopes, with the first active
+        // token of each name taking precedence.
+        StringSet scopeKeys;
+        for (TokenPtr token : interfaceElem->getActiveTokens())
+        {
+            string key = "[" + token->getName() + "]";
+            if (scopeKeys.insert(key).second)
+            {
+                scope->setFilenameSubstitution(key, token->getResolvedValueString());
+            }
+        }
+    }
+    return scope;
+}
+
+} // anonymous namespace
+
+ElementDiff diffElements(ConstElementPtr lhs, ConstElementPtr rhs, const ElementEquivalenceOptions& options)
+{
+    ElementDiff diff;
+    diffElementTrees(lhs, rhs, options, diff);
+    return diff;
+}
+
+vector<std::pair<ValueElementPtr, string>> resolveFilenames(ConstElementPtr root, const string& geom)
+{
+    // Construct the resolver for the scope enclosing the root, applying
+    // geometry tokens and the scopes of all ancestors of the root.
+    StringResolverPtr baseScope = StringResolver::create();
+    if (!geom.empty())
+    {
+        for (GeomInfoPtr geomInfo : root->getDocument()->getGeomInfos())
+        {
+            if (!geomStringsMatch(geom, geomInfo->getActiveGeom()))
+                continue;
+            for (TokenPtr token : geomInfo->getTokens())
+            {
+                baseScope->setFilenameSubstitution("<" + token->getName() + ">", token->getResolvedValueString());
+            }
+        }
+    }
+    vector<ConstElementPtr> ancestors;
+    for (ConstElementPtr parent = root->getParent(); parent; parent = parent->getParent())
+    {
+        ancestors.push_back(parent);
+    }
+    for (auto it = ancestors.rbegin(); it != ancestors.rend(); ++it)
+    {
+        baseScope = createScopedResolver(baseScope, *it);
+    }
+
+    // Traverse the tree, constructing the resolver for each scope on demand.
+    vector<std::pair<ValueElementPtr, string>> resolved;
+    vector<ElementPtr> path;
+    vector<StringResolverPtr> scopes;
+    for (TreeIterator it = root->traverseTree().begin(); it != TreeIterator::end(); ++it)
+    {
+        ElementPtr elem = it.getElement();
+        size_t depth = it.getElementDepth();
+        path.resize(depth + 1);
+        scopes.resize(depth + 1);
+        path[depth] = elem;
+        scopes[depth] = nullptr;
+
+        ValueElementPtr valueElem = elem->asA<ValueElement>();
+        if (!valueElem || valueElem->getType() != FILENAME_TYPE_STRING)
+        {
+            continue;
+        }
+
+        // Find the nearest constructed scope, then extend it to this element.
+        size_t scopeDepth = depth;
+        while (scopeDepth > 0 && !scopes[scopeDepth - 1])
+        {
+            scopeDepth--;
+        }
+        StringResolverPtr scope = scopeDepth > 0 ? scopes[scopeDepth - 1] : baseScope;
+        for (; scopeDepth < depth; scopeDepth++)
+        {
+            scope = createScopedResolver(scope, path[scopeDepth]);
+            scopes[scopeDepth] = scope;
+        }
+
+        // Apply any prefixes of the filename element itself.
+        scope = createScopedResolver(scope, valueElem);
+        resolved.emplace_back(valueElem, scope->resolve(valueElem->getValueString(), FILENAME_TYPE_STRING));
+    }
+    return resolved;
+}
+
 string prettyPrint(ConstElementPtr elem)
 {
     string text;
@@ -72,6 +72,10 @@ using ElementMap = std::unordered_map<string, ElementPtr>;
 using ElementPredicate = std::function<bool(ConstElementPtr)>;
 
 class ElementEquivalenceOptions;
+class ValidationDiagnostic;
+
+/// A vector of validation diagnostics
+using ValidationDiagnostics = vector<ValidationDiagnostic>;
 
 /// @class Element
 /// The base class for MaterialX elements.
@@ -99,6 +103,7 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
     using ConstDocumentPtr = shared_ptr<const Document>;
 
     template <class T> friend class ElementRegistry;
+    friend class GraphIterator;
 
   public:
     /// Return true if the given element tree, including all descendants,
@@ -113,10 +118,7 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
     /// @{
 
     /// Set the element's category string.
-    void setCategory(const string& category)
-    {
-        _category = category;
-    }
+    void setCategory(const string& category);
 
     /// Return the element's category string.  The category of a MaterialX
     /// element represents its role within the document, with common examples
@@ -476,26 +478,26 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
     /// @{
 
     /// Set the value string of the given attribute.
-    void setAttribute(const string& attrib, const string& value);
+    void setAttribute(const string& attrib, string value);
 
     /// Return true if the given attribute is present.
     bool hasAttribute(const string& attrib) const
     {
-        return _attributeMap.count(attrib) != 0;
+        return std::find(_attributeNames.begin(), _attributeNames.end(), attrib) != _attributeNames.end();
     }
 
     /// Return the value string of the given attribute.  If the given attribute
     /// is not present, then an empty string is returned.
     const string& getAttribute(const string& attrib) const
     {
-        StringMap::const_iterator it = _attributeMap.find(attrib);
-        return (it != _attributeMap.end()) ? it->second : EMPTY_STRING;
+        StringVec::const_iterator it = std::find(_attributeNames.begin(), _attributeNames.end(), attrib);
+        return (it != _attributeNames.end()) ? _attributeValues[it - _attributeNames.begin()] : EMPTY_STRING;
     }
 
     /// Return a vector of stored attribute names, in the order they were set.
     const StringVec& getAttributeNames() const
     {
-        return _attributeOrder;
+        return _attributeNames;
     }
 
     /// Set the value of an implicitly typed attribute.  Since an attribute
@@ -622,6 +624,34 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
                                        const ElementEquivalenceOptions& options, 
                                        string* message = nullptr) const;
 
+    /// Return a hash of the given element tree, including all descendants,
+    /// that is consistent with isEquivalent under the given criteria, so that
+    /// equivalent element trees have equal hashes.
+    ///
+    /// Values that cannot be parsed for their type are hashed as strings,
+    /// whereas isEquivalent skips their comparison.
+    ///
+    /// Hashes are computed bottom-up and cached on each element, and cached
+    /// hashes are invalidated when an element or any of its descendants is
+    /// edited, or when the definitions visible to its document change.
+    /// Hashes may be computed from multiple threads at once, provided that
+    /// the document is not edited concurrently.
+    /// @param options Equivalence criteria
+    /// @return A hash of the element tree.
+    size_t getContentHash(const ElementEquivalenceOptions& options) const;
+
+    /// Return a hash of the given element tree, using the default
+    /// equivalence criteria.
+    size_t getContentHash() const;
+
+    /// Return a hash of the given attribute of this element, consistent with
+    /// isAttributeEquivalent under the given criteria.
+    /// @param attributeName Name of attribute to hash
+    /// @param options Equivalence criteria
+    /// @return A hash of the attribute value.
+    virtual size_t getAttributeHash(const string& attributeName,
+                                    const ElementEquivalenceOptions& options) const;
+
     /// @}
     /// @name Traversal
     /// @{
@@ -648,6 +678,8 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
 
     /// Traverse the dataflow graph from the given element to each of its
     /// upstream sources in depth-first order, using pre-order visitation.
+    /// The document must outlive the traversal, and elements must not be
+    /// removed from the graph while it is being traversed.
     /// @throws ExceptionFoundCycle if a cycle is encountered.
     /// @return A GraphIterator object.
     /// @details Example usage with an implicit iterator:
@@ -716,10 +748,7 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
     ///    this element originates.  This string may be used by serialization
     ///    and deserialization routines to maintain hierarchies of include
     ///    references.
-    void setSourceUri(const string& sourceUri)
-    {
-        _sourceUri = sourceUri;
-    }
+    void setSourceUri(const string& sourceUri);
 
     /// Return true if this element has a source URI.
     bool hasSourceUri() const
@@ -805,10 +834,18 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
         return child ? child : scope->getChildOfType<T>(name);
     }
 
+    // Validate the requirements that apply to this element itself, without
+    // descending into its children.
+    virtual bool validateLocal(string* message) const;
+
     // Enforce a requirement within a validate method, updating the validation
     // state and optional output text if the requirement is not met.
     void validateRequire(bool expression, bool& res, string* message, const string& errorDesc) const;
 
+    // Record the requirements that fail within validate methods on the calling
+    // thread in the given diagnostics, returning the previous destination.
+    static ValidationDiagnostics* setValidationDiagnostics(ValidationDiagnostics* diagnostics);
+
   public:
     static const string NAME_ATTRIBUTE;
     static const string FILE_PREFIX_ATTRIBUTE;
@@ -824,6 +861,34 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
     virtual void registerChildElement(ElementPtr child);
     virtual void unregisterChildElement(ElementPtr child);
 
+    // Replace each of the given children with its sequence of replacement
+    // children, which must already be children of this element.  Replacements
+    // are moved to the position of the child they replace, and replaced
+    // children are removed, in time linear in the number of children.
+    void replaceChildren(const std::unordered_map<ElementPtr, vector<ElementPtr>>& replacements);
+
+    // Invalidate the cached content hashes of this element and its ancestors.
+    void invalidateContentHash();
+
+    // Called after the given attribute of this element is set or removed,
+    // where an empty name denotes a change to all attributes.
+    virtual void onAttributeEdit(const string&) { }
+
+    // Called after the children of this element are reordered.
+    virtual void onChildOrderEdit() { }
+
+    // Return the connecting and upstream elements of the upstream edge with
+    // the given index, without constructing an Edge, for use in graph
+    // traversal.  The upstream element is null if no such edge exists.
+    virtual std::pair<Element*, Element*> getUpstreamEdgeElements(size_t index) const;
+
+    // Return the content hash of this element for the given criteria, whose
+    // own hash is given as the cache key.  Hashes are cached only on elements
+    // belonging to the given root, so that elements shared with another
+    // document are never written under a lock that the other document does
+    // not hold.
+    size_t computeContentHash(const ElementEquivalenceOptions& options, size_t optionsKey, const ConstElementPtr& cacheRoot) const;
+
     // Return a non-const copy of our self pointer, for use in constructing
     // graph traversal objects that require non-const storage.
     ElementPtr getSelfNonConst() const
@@ -839,12 +904,21 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
     ElementMap _childMap;
     vector<ElementPtr> _childOrder;
 
-    StringMap _attributeMap;
-    StringVec _attributeOrder;
+    // Attribute names and values are stored as parallel vectors in the order
+    // they were set.  Elements carry only a handful of attributes, so linear
+    // searches over short names outperform hashed lookups, and avoid the
+    // per-attribute node allocations of a hash map.
+    StringVec _attributeNames;
+    StringVec _attributeValues;
 
     weak_ptr<Element> _parent;
     weak_ptr<Element> _root;
 
+    // The cached content hash of this element, and a hash of the criteria
+    // with which it was computed, where a zero key denotes no cached hash.
+    mutable size_t _contentHash = 0;
+    mutable size_t _contentHashKey = 0;
+
   private:
     template <class T> static ElementPtr createElement(ElementPtr parent, const string& name)
     {
@@ -1033,6 +1107,11 @@ class MX_CORE_API ValueElement : public TypedElement
     /// Return the typed value of an element as a generic value object, which
     /// may be queried to access its data.
     ///
+    /// The parsed value is cached on the element until its value or type
+    /// attribute is next edited, and each call returns a new copy of the
+    /// cached value, which the caller may modify freely.
+    /// This method may be called concurrently from multiple threads.
+    ///
     /// @return A shared pointer to the typed value of this element, or an
     ///    empty shared pointer if no value is present.
     ValuePtr getValue() const;
@@ -1129,6 +1208,16 @@ class MX_CORE_API ValueElement : public TypedElement
                                const ElementEquivalenceOptions& options, 
                                string* message = nullptr) const override;
 
+    /// Return a hash of the given attribute of this element, consistent with
+    /// isAttributeEquivalent under the given criteria.  Values and UI range
+    /// attributes are hashed in their formatted form, using the float format
+    /// and precision of the criteria.
+    /// @param attributeName Name of attribute to hash
+    /// @param options Equivalence criteria
+    /// @return A hash of the attribute value.
+    size_t getAttributeHash(const string& attributeName,
+                            const ElementEquivalenceOptions& options) const override;
+
     /// @}
     /// @name Validation
     /// @{
@@ -1157,6 +1246,15 @@ class MX_CORE_API ValueElement : public TypedElement
     static const string UNIT_ATTRIBUTE;
     static const string UNITTYPE_ATTRIBUTE;
     static const string UNIFORM_ATTRIBUTE;
+
+  protected:
+    void onAttributeEdit(const string& attrib) override;
+
+  private:
+    // The parsed value of this element, cached on first access, and accessed
+    // through atomic operations to support concurrent readers.  The cached
+    // value is never modified, and is copied for each caller.
+    mutable ConstValuePtr _cachedValue;
 };
 
 /// @class Token
@@ -1236,7 +1334,9 @@ class MX_CORE_API GenericElement : public Element
 /// and material.
 ///
 /// Calling the StringResolver::resolve method applies all modifiers to a
-/// particular string value.
+/// particular string value.  Substring substitutions are compiled as they are
+/// set, so that each call to StringResolver::resolve applies them in a single
+/// pass over the input string.
 ///
 /// Methods such as StringResolver::setFilePrefix may be used to edit the
 /// stored string modifiers before calling StringResolver::resolve.
@@ -1298,6 +1398,7 @@ class MX_CORE_API StringResolver
     void setFilenameSubstitution(const string& key, const string& value)
     {
         _filenameMap[key] = value;
+        _filenameReplacer.addSubstitution(key, value);
     }
 
     /// Add filename token substitutions for a given element
@@ -1317,6 +1418,7 @@ class MX_CORE_API StringResolver
     void setGeomNameSubstitution(const string& key, const string& value)
     {
         _geomNameMap[key] = value;
+        _geomNameReplacer.addSubstitution(key, value);
     }
 
     /// Return the map of geometry name substring substitutions.
@@ -1349,6 +1451,8 @@ class MX_CORE_API StringResolver
     string _geomPrefix;
     StringMap _filenameMap;
     StringMap _geomNameMap;
+    SubstringReplacer _filenameReplacer;
+    SubstringReplacer _geomNameReplacer;
 };
 
 /// @class ElementEquivalenceOptions
@@ -1387,6 +1491,54 @@ class MX_CORE_API ElementEquivalenceOptions
     StringSet attributeExclusionList;
 };
 
+/// @class ValidationDiagnostic
+/// A single requirement that failed during the validation of an element.
+class MX_CORE_API ValidationDiagnostic
+{
+  public:
+    /// The name path of the element that failed validation.
+    string elementPath;
+
+    /// A description of the requirement that was not met.
+    string rule;
+
+    /// The full validation message, as it would be written by Element::validate.
+    string message;
+
+    bool operator==(const ValidationDiagnostic& rhs) const
+    {
+        return elementPath == rhs.elementPath && rule == rhs.rule && message == rhs.message;
+    }
+    bool operator!=(const ValidationDiagnostic& rhs) const
+    {
+        return !(*this == rhs);
+    }
+};
+
+/// @class ElementDiff
+/// The differences between two element trees, as returned by diffElements.
+class MX_CORE_API ElementDiff
+{
+  public:
+    /// Return true if no differences were found.
+    bool empty() const
+    {
+        return added.empty() && removed.empty() && modified.empty();
+    }
+
+    /// The name paths of elements in the second tree with no counterpart in
+    /// the first.  Descendants of added elements are not listed.
+    StringVec added;
+
+    /// The name paths of elements in the first tree with no counterpart in
+    /// the second.  Descendants of removed elements are not listed.
+    StringVec removed;
+
+    /// The name paths of elements present in both trees whose name,
+    /// attributes, or order of children differ.
+    StringVec modified;
+};
+
 /// @class ExceptionOrphanedElement
 /// An exception that is thrown when an ElementPtr is used after its owning
 /// Document has gone out of scope.
@@ -1422,6 +1574,23 @@ MX_CORE_API bool targetStringsMatch(const string& target1, const string& target2
 /// element in depth-first order.
 MX_CORE_API string prettyPrint(ConstElementPtr elem);
 
+/// Return the differences between two element trees, under the given
+/// equivalence criteria.  Children are matched by name, and subtrees with
+/// equal content hashes are skipped, so the cost of a diff is proportional
+/// to the changed regions of the trees.
+MX_CORE_API ElementDiff diffElements(ConstElementPtr lhs, ConstElementPtr rhs,
+                                     const ElementEquivalenceOptions& options = ElementEquivalenceOptions());
+
+/// Resolve the values of all filename elements in the given element tree,
+/// returning each filename element paired with its resolved value.  String
+/// resolvers are constructed once per element scope and shared by all of its
+/// filename elements, and the results are identical to those of
+/// ValueElement::getResolvedValueString for each element.
+/// @param root The root of the element tree to be resolved.
+/// @param geom An optional geometry name, whose geometry tokens are applied
+///    to all filenames in the tree.
+MX_CORE_API vector<std::pair<ValueElementPtr, string>> resolveFilenames(ConstElementPtr root, const string& geom = EMPTY_STRING);
+
 MATERIALX_NAMESPACE_END
 
 #endif
@@ -0,0 +1,353 @@
+//
+// Copyright Contributors to the MaterialX Project
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <MaterialXCore/GeomBinding.h>
+
+#include <algorithm>
+#include <functional>
+
+MATERIALX_NAMESPACE_BEGIN
+
+namespace
+{
+
+void sortUnique(vector<size_t>& vec)
+{
+    std::sort(vec.begin(), vec.end());
+    vec.erase(std::unique(vec.begin(), vec.end()), vec.end());
+}
+
+// Call the given function for each non-empty component of a geometry path,
+// following the conventions of GeomPath.
+template <class F> void forEachPathComponent(const string& path, F func)
+{
+    size_t pos = 0;
+    while (pos < path.size())
+    {
+        size_t next = path.find(GEOM_PATH_SEPARATOR, pos);
+        if (next == string::npos)
+        {
+            next = path.size();
+        }
+        if (next > pos && !func(pos, next - pos))
+        {
+            return;
+        }
+        pos = next + GEOM_PATH_SEPARATOR.size();
+    }
+}
+
+} // anonymous namespace
+
+//
+// GeomBindingResolver data
+//
+
+enum class GeomBindingResolver::BindingType
+{
+    Material,
+    Property,
+    PropertySet,
+    Visibility
+};
+
+struct GeomBindingResolver::TrieNode
+{
+    std::unordered_map<string, std::unique_ptr<TrieNode>> children;
+
+    // Bindings whose geometry path ends at this node.
+    vector<size_t> bindings;
+
+    // Collections that include or exclude the path of this node.
+    vector<size_t> includes;
+    vector<size_t> excludes;
+
+    // Collections that include the path of this node or any descendant,
+    // sorted and unique.
+    vector<size_t> subtreeIncludes;
+};
+
+struct GeomBindingResolver::Binding
+{
+    ElementPtr elem;
+    BindingType type;
+    vector<VariantAssignPtr> variantAssigns;
+};
+
+struct GeomBindingResolver::CompiledCollection
+{
+    // This collection and all collections in its include chain.
+    vector<size_t> closure;
+
+    // All collections whose closure contains this collection.
+    vector<size_t> containers;
+
+    // Bindings that reference this collection.
+    vector<size_t> bindings;
+};
+
+//
+// GeomBindingResolver methods
+//
+
+GeomBindingResolver::GeomBindingResolver() :
+    _root(std::make_unique<TrieNode>())
+{
+}
+
+GeomBindingResolver::~GeomBindingResolver()
+{
+}
+
+GeomBindingResolverPtr GeomBindingResolver::create(ConstDocumentPtr doc, ConstLookPtr look)
+{
+    GeomBindingResolverPtr resolver(new GeomBindingResolver());
+
+    vector<LookPtr> looks = doc->getLooks();
+    for (LookPtr docLook : looks)
+    {
+        if (look && docLook != look)
+        {
+            continue;
+        }
+        vector<MaterialAssignPtr> materialAssigns = look ? docLook->getActiveMaterialAssigns() : docLook->getMaterialAssigns();
+        vector<PropertyAssignPtr> propertyAssigns = look ? docLook->getActivePropertyAssigns() : docLook->getPropertyAssigns();
+        vector<PropertySetAssignPtr> propertySetAssigns = look ? docLook->getActivePropertySetAssigns() : docLook->getPropertySetAssigns();
+        vector<VisibilityPtr> visibilities = look ? docLook->getActiveVisibilities() : docLook->getVisibilities();
+
+        for (MaterialAssignPtr matAssign : materialAssigns)
+        {
+            resolver->addBinding(matAssign, BindingType::Material, matAssign->getActiveGeom(), matAssign->getCollection());
+            resolver->_bindings.back().variantAssigns = matAssign->getActiveVariantAssigns();
+        }
+        for (PropertyAssignPtr propAssign : propertyAssigns)
+        {
+            resolver->addBinding(propAssign, BindingType::Property, propAssign->getGeom(), propAssign->getCollection());
+        }
+        for (PropertySetAssignPtr propSetAssign : propertySetAssigns)
+        {
+            resolver->addBinding(propSetAssign, BindingType::PropertySet, propSetAssign->getActiveGeom(), propSetAssign->getCollection());
+        }
+        for (VisibilityPtr visibility : visibilities)
+        {
+            resolver->addBinding(visibility, BindingType::Visibility, visibility->getActiveGeom(), visibility->getCollection());
+        }
+    }
+
+    // Record the collections whose closures contain each collection.
+    for (size_t i = 0; i < resolver->_collections.size(); i++)
+    {
+        for (size_t included : resolver->_collections[i].closure)
+        {
+            resolver->_collections[included].containers.push_back(i);
+        }
+    }
+
+    // Gather included collections from the leaves of the trie upwards.
+    std::function<void(TrieNode&)> gatherIncludes = [&gatherIncludes](TrieNode& node)
+    {
+        node.subtreeIncludes = node.includes;
+        for (auto& child : node.children)
+        {
+            gatherIncludes(*child.second);
+            node.subtreeIncludes.insert(node.subtreeIncludes.end(),
+                                        child.second->subtreeIncludes.begin(),
+                                        child.second->subtreeIncludes.end());
+        }
+        sortUnique(node.subtreeIncludes);
+    };
+    gatherIncludes(*resolver->_root);
+
+    return resolver;
+}
+
+void GeomBindingResolver::addBinding(ElementPtr elem, BindingType type, const string& geom, CollectionPtr collection)
+{
+    size_t index = _bindings.size();
+    _bindings.push_back({ elem, type, {} });
+
+    for (const string& path : splitString(geom, ARRAY_VALID_SEPARATORS))
+    {
+        insertPath(path)->bindings.push_back(index);
+    }
+    if (collection)
+    {
+        StringSet visiting;
+        size_t collIndex = compileCollection(collection, visiting);
+        _collections[collIndex].bindings.push_back(index);
+    }
+}
+
+size_t GeomBindingResolver::compileCollection(CollectionPtr collection, StringSet& visiting)
+{
+    const string namePath = collection->getNamePath();
+    auto it = _collectionIndices.find(namePath);
+    if (it != _collectionIndices.end())
+    {
+        return it->second;
+    }
+    if (visiting.count(namePath))
+    {
+        throw ExceptionFoundCycle("Encountered a cycle in collection: " + collection->getName());
+    }
+
+    // Compile included collections first, so that the closure of this
+    // collection is complete.
+    visiting.insert(namePath);
+    vector<size_t> closure;
+    for (CollectionPtr included : collection->getIncludeCollections())
+    {
+        size_t includedIndex = compileCollection(included, visiting);
+        const vector<size_t>& includedClosure = _collections[includedIndex].closure;
+        closure.insert(closure.end(), includedClosure.begin(), includedClosure.end());
+    }
+    visiting.erase(namePath);
+
+    size_t index = _collections.size();
+    closure.push_back(index);
+    sortUnique(closure);
+    _collections.push_back({ closure, {}, {} });
+    _collectionIndices[namePath] = index;
+
+    for (const string& path : splitString(collection->getActiveIncludeGeom(), ARRAY_VALID_SEPARATORS))
+    {
+        insertPath(path)->includes.push_back(index);
+    }
+    for (const string& path : splitString(collection->getActiveExcludeGeom(), ARRAY_VALID_SEPARATORS))
+    {
+        insertPath(path)->excludes.push_back(index);
+    }
+    return index;
+}
+
+GeomBindingResolver::TrieNode* GeomBindingResolver::insertPath(const string& geom)
+{
+    TrieNode* node = _root.get();
+    forEachPathComponent(geom, [&node, &geom](size_t pos, size_t length)
+    {
+        std::unique_ptr<TrieNode>& child = node->children[geom.substr(pos, length)];
+        if (!child)
+        {
+            child = std::make_unique<TrieNode>();
+        }
+        node = child.get();
+        return true;
+    });
+    return node;
+}
+
+void GeomBindingResolver::resolvePath(const string& path, vector<size_t>& matches,
+                                      vector<size_t>& includes, vector<size_t>& excludes,
+                                      string& token) const
+{
+    auto visitNode = [&](const TrieNode* node)
+    {
+        matches.insert(matches.end(), node->bindings.begin(), node->bindings.end());
+        includes.insert(includes.end(), node->includes.begin(), node->includes.end());
+        excludes.insert(excludes.end(), node->excludes.begin(), node->excludes.end());
+    };
+
+    // Visit each node along the given path, which represent the paths that
+    // contain it.
+    const TrieNode* node = _root.get();
+    bool complete = true;
+    visitNode(node);
+    forEachPathComponent(path, [&](size_t pos, size_t length)
+    {
+        token.assign(path, pos, length);
+        auto it = node->children.find(token);
+        if (it == node->children.end())
+        {
+            complete = false;
+            return false;
+        }
+        node = it->second.get();
+        visitNode(node);
+        return true;
+    });
+
+    // Collection includes also match paths contained by the given path.
+    if (complete)
+    {
+        includes.insert(includes.end(), node->subtreeIncludes.begin(), node->subtreeIncludes.end());
+    }
+}
+
+GeomBindings GeomBindingResolver::resolve(const string& geom) const
+{
+    vector<size_t> matches;
+    vector<size_t> includes;
+    vector<size_t> excludes;
+    string token;
+    for (const string& path : splitString(geom, ARRAY_VALID_SEPARATORS))
+    {
+        resolvePath(path, matches, includes, excludes, token);
+    }
+
+    // As in Collection::matchesGeomString, a collection matches if it is
+    // not excluded by any of the given paths, and if any collection in its
+    // closure both includes one of the paths and is not excluded.
+    if (!includes.empty())
+    {
+        sortUnique(includes);
+        sortUnique(excludes);
+        auto isExcluded = [&excludes](size_t index)
+        {
+            return std::binary_search(excludes.begin(), excludes.end(), index);
+        };
+        for (size_t included : includes)
+        {
+            if (isExcluded(included))
+            {
+                continue;
+            }
+            for (size_t container : _collections[included].containers)
+            {
+                if (!isExcluded(container))
+                {
+                    const vector<size_t>& bindings = _collections[container].bindings;
+                    matches.insert(matches.end(), bindings.begin(), bindings.end());
+                }
+            }
+        }
+    }
+    sortUnique(matches);
+
+    GeomBindings result;
+    for (size_t index : matches)
+    {
+        const Binding& binding = _bindings[index];
+        switch (binding.type)
+        {
+            case BindingType::Material:
+                result.materialAssigns.push_back(std::static_pointer_cast<MaterialAssign>(binding.elem));
+                result.variantAssigns.insert(result.variantAssigns.end(), binding.variantAssigns.begin(), binding.variantAssigns.end());
+                break;
+            case BindingType::Property:
+                result.propertyAssigns.push_back(std::static_pointer_cast<PropertyAssign>(binding.elem));
+                break;
+            case BindingType::PropertySet:
+                result.propertySetAssigns.push_back(std::static_pointer_cast<PropertySetAssign>(binding.elem));
+                break;
+            case BindingType::Visibility:
+                result.visibilities.push_back(std::static_pointer_cast<Visibility>(binding.elem));
+                break;
+        }
+    }
+    return result;
+}
+
+vector<GeomBindings> GeomBindingResolver::resolve(const StringVec& geoms) const
+{
+    vector<GeomBindings> results;
+    results.reserve(geoms.size());
+    for (const string& geom : geoms)
+    {
+        results.push_back(resolve(geom));
+    }
+    return results;
+}
+
+MATERIALX_NAMESPACE_END
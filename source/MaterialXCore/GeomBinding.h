@@ -0,0 +1,105 @@
+//
+// Copyright Contributors to the MaterialX Project
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#ifndef MATERIALX_GEOMBINDING_H_
+#define MATERIALX_GEOMBINDING_H_
+
+/// @file
+/// Geometry binding resolution
+
+#include <MaterialXCore/Export.h>
+
+#include <MaterialXCore/Document.h>
+
+MATERIALX_NAMESPACE_BEGIN
+
+class GeomBindingResolver;
+
+/// A shared pointer to a GeomBindingResolver
+using GeomBindingResolverPtr = shared_ptr<GeomBindingResolver>;
+/// A shared pointer to a const GeomBindingResolver
+using ConstGeomBindingResolverPtr = shared_ptr<const GeomBindingResolver>;
+
+/// @class GeomBindings
+/// The set of look assignments that apply to a geometry, with each vector
+/// in document order.
+class MX_CORE_API GeomBindings
+{
+  public:
+    /// Material assignments whose geometry or collection matches.
+    vector<MaterialAssignPtr> materialAssigns;
+
+    /// Property assignments whose geometry or collection matches.
+    vector<PropertyAssignPtr> propertyAssigns;
+
+    /// Property set assignments whose geometry or collection matches.
+    vector<PropertySetAssignPtr> propertySetAssigns;
+
+    /// Visibility elements whose geometry or collection matches.
+    vector<VisibilityPtr> visibilities;
+
+    /// Variant assignments of the matching material assignments.
+    vector<VariantAssignPtr> variantAssigns;
+};
+
+/// @class GeomBindingResolver
+/// A compiled index of the geometry bindings in a document.
+///
+/// The geometry paths of all look assignments and collections are stored
+/// in a prefix trie, with collection includes pre-flattened, so that the
+/// assignments for a geometry are resolved in time proportional to the depth
+/// of its path.  Matching follows the rules of geomStringsMatch and
+/// Collection::matchesGeomString.
+///
+/// A resolver is a snapshot of the document at the time of its creation,
+/// and should be recreated after looks or collections are edited.
+class MX_CORE_API GeomBindingResolver
+{
+  public:
+    ~GeomBindingResolver();
+
+    /// Create a resolver for the given document.
+    /// @param doc The document whose bindings are indexed.
+    /// @param look If provided, then only the active assignments of this
+    ///    look are indexed.  Otherwise, the assignments of all looks in the
+    ///    document are indexed.
+    /// @throws ExceptionFoundCycle if a cycle is found in the include chain
+    ///    of an assigned collection.
+    static GeomBindingResolverPtr create(ConstDocumentPtr doc, ConstLookPtr look = nullptr);
+
+    /// Return the assignments that apply to the given geometry string.
+    /// @param geom A geometry path, or a comma-separated list of geometry
+    ///    paths, for which assignments are returned.
+    GeomBindings resolve(const string& geom) const;
+
+    /// Return the assignments that apply to each geometry string in the
+    /// given vector, in the same order.
+    vector<GeomBindings> resolve(const StringVec& geoms) const;
+
+  private:
+    enum class BindingType;
+    struct TrieNode;
+    struct Binding;
+    struct CompiledCollection;
+
+    GeomBindingResolver();
+
+    void addBinding(ElementPtr elem, BindingType type, const string& geom, CollectionPtr collection);
+    size_t compileCollection(CollectionPtr collection, StringSet& visiting);
+    TrieNode* insertPath(const string& geom);
+    void resolvePath(const string& path, vector<size_t>& matches,
+                     vector<size_t>& includes, vector<size_t>& excludes,
+                     string& token) const;
+
+  private:
+    std::unique_ptr<TrieNode> _root;
+    vector<Binding> _bindings;
+    vector<CompiledCollection> _collections;
+    std::unordered_map<string, size_t> _collectionIndices;
+};
+
+MATERIALX_NAMESPACE_END
+
+#endif
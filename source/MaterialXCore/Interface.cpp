@@ -95,19 +95,15 @@ OutputPtr PortElement::getConnectedOutput() const
         {
             nodeGraph = resolveNameReference<NodeGraph>(getNodeGraphString());
         }
-        if (nodeGraph)
+        if (nodeGraph && nodeGraph->getOutputCount() > 0)
         {
-            std::vector<OutputPtr> outputs = nodeGraph->getOutputs();
-            if (!outputs.empty())
+            if (outputString.empty())
             {
-                if (outputString.empty())
-                {
-                    result = outputs[0];
-                }
-                else
-                {
-                    result = nodeGraph->getOutput(outputString);
-                }
+                result = nodeGraph->getOutputs()[0];
+            }
+            else
+            {
+                result = nodeGraph->getOutput(outputString);
             }
         }
     }
@@ -120,19 +116,15 @@ OutputPtr PortElement::getConnectedOutput() const
         {
             node = resolveNameReference<Node>(nodeName);
         }
-        if (node)
+        if (node && node->getOutputCount() > 0)
         {
-            std::vector<OutputPtr> outputs = node->getOutputs();
-            if (!outputs.empty())
+            if (outputString.empty())
             {
-                if (outputString.empty())
-                {
-                    result = outputs[0];
-                }
-                else
-                {
-                    result = node->getOutput(outputString);
-                }
+                result = node->getOutputs()[0];
+            }
+            else
+            {
+                result = node->getOutput(outputString);
             }
         }
     }
@@ -330,6 +322,15 @@ Edge Output::getUpstreamEdge(size_t index) const
     return NULL_EDGE;
 }
 
+std::pair<Element*, Element*> Output::getUpstreamEdgeElements(size_t index) const
+{
+    if (index < getUpstreamEdgeCount())
+    {
+        return { nullptr, getConnectedNode().get() };
+    }
+    return { nullptr, nullptr };
+}
+
 bool Output::hasUpstreamCycle() const
 {
     try
@@ -301,6 +301,9 @@ class MX_CORE_API Output : public PortElement
   public:
     static const string CATEGORY;
     static const string DEFAULT_INPUT_ATTRIBUTE;
+
+  protected:
+    std::pair<Element*, Element*> getUpstreamEdgeElements(size_t index) const override;
 };
 
 /// @class InterfaceElement
@@ -9,6 +9,7 @@
 #include <MaterialXCore/Material.h>
 
 #include <deque>
+#include <iterator>
 
 MATERIALX_NAMESPACE_BEGIN
 
@@ -74,40 +75,64 @@ NodeDefPtr Node::getNodeDef(const string& target, bool allowRoughMatch) const
     {
         return resolveNameReference<NodeDef>(getNodeDefString());
     }
-    vector<NodeDefPtr> nodeDefs = getDocument()->getMatchingNodeDefs(getQualifiedName(getCategory()));
-    vector<NodeDefPtr> secondary = getDocument()->getMatchingNodeDefs(getCategory());
-    vector<NodeDefPtr> roughMatches;
-    nodeDefs.insert(nodeDefs.end(), secondary.begin(), secondary.end());
-    for (NodeDefPtr nodeDef : nodeDefs)
+
+    // The matching nodedef depends only on the signature of this node and
+    // on the definitions in the document, so it is memoized by signature.
+    ConstDocumentPtr doc = getDocument();
+    const string qualifiedCategory = getQualifiedName(getCategory());
+    string signature = qualifiedCategory;
+    for (const string* field : { &getType(), &target, &getVersionString() })
     {
-        if (!targetStringsMatch(nodeDef->getTarget(), target) ||
-            !nodeDef->isVersionCompatible(getVersionString()) ||
-            nodeDef->getType() != getType())
-        {
-            continue;
-        }
-        if (!hasExactInputMatch(nodeDef))
+        signature += '\0';
+        signature += *field;
+    }
+    signature += '\0';
+    signature += allowRoughMatch ? 'r' : 'e';
+    for (InputPtr input : getActiveInputs())
+    {
+        signature += '\0';
+        signature += input->getName();
+        signature += ':';
+        signature += input->getType();
+    }
+
+    return doc->getMemoizedNodeDef(signature, [&]()
+    {
+        vector<NodeDefPtr> nodeDefs = doc->getMatchingNodeDefs(qualifiedCategory);
+        vector<NodeDefPtr> secondary = doc->getMatchingNodeDefs(getCategory());
+        vector<NodeDefPtr> roughMatches;
+        nodeDefs.insert(nodeDefs.end(), secondary.begin(), secondary.end());
+        for (NodeDefPtr nodeDef : nodeDefs)
         {
-            if (allowRoughMatch)
+            if (!targetStringsMatch(nodeDef->getTarget(), target) ||
+                !nodeDef->isVersionCompatible(getVersionString()) ||
+                nodeDef->getType() != getType())
             {
-                roughMatches.push_back(nodeDef);
+                continue;
+            }
+            if (!hasExactInputMatch(nodeDef))
+            {
+                if (allowRoughMatch)
+                {
+                    roughMatches.push_back(nodeDef);
+                }
+                continue;
             }
-            continue;
+            return nodeDef;
         }
-        return nodeDef;
-    }
-    if (!roughMatches.empty())
-    {
-        return roughMatches[0];
-    }
-    return NodeDefPtr();
+        if (!roughMatches.empty())
+        {
+            return roughMatches[0];
+        }
+        return NodeDefPtr();
+    });
 }
 
 Edge Node::getUpstreamEdge(size_t index) const
 {
-    if (index < getUpstreamEdgeCount())
+    if (index < _inputs.size())
     {
-        InputPtr input = getInputs()[index];
+        const InputPtr& input = _inputs[index];
         ElementPtr upstreamNode = input->getConnectedNode();
         if (upstreamNode)
         {
@@ -118,6 +143,16 @@ Edge Node::getUpstreamEdge(size_t index) const
     return NULL_EDGE;
 }
 
+std::pair<Element*, Element*> Node::getUpstreamEdgeElements(size_t index) const
+{
+    if (index < _inputs.size())
+    {
+        Input* input = _inputs[index].get();
+        return { input, input->getConnectedNode().get() };
+    }
+    return { nullptr, nullptr };
+}
+
 OutputPtr Node::getNodeDefOutput(ElementPtr connectingElement)
 {
     string outputName;
@@ -172,18 +207,20 @@ OutputPtr Node::getNodeDefOutput(ElementPtr connectingElement)
 
 vector<PortElementPtr> Node::getDownstreamPorts() const
 {
-    vector<PortElementPtr> downstreamPorts;
-    for (PortElementPtr port : getDocument()->getMatchingPorts(getQualifiedName(getName())))
+    // The document cache maintains the ports referencing each qualified node
+    // name as edits are made, so only candidate ports are visited here.
+    vector<PortElementPtr> downstreamPorts = getDocument()->getMatchingPorts(getQualifiedName(getName()));
+    downstreamPorts.erase(std::remove_if(downstreamPorts.begin(), downstreamPorts.end(), [this](const PortElementPtr& port)
     {
-        if (port->getConnectedNode() == getSelf())
+        return port->getConnectedNode().get() != this;
+    }), downstreamPorts.end());
+    if (downstreamPorts.size() > 1)
+    {
+        std::sort(downstreamPorts.begin(), downstreamPorts.end(), [](const ConstElementPtr& a, const ConstElementPtr& b)
         {
-            downstreamPorts.push_back(port);
-        }
+            return a->getName() > b->getName();
+        });
     }
-    std::sort(downstreamPorts.begin(), downstreamPorts.end(), [](const ConstElementPtr& a, const ConstElementPtr& b)
-    {
-        return a->getName() > b->getName();
-    });
     return downstreamPorts;
 }
 
@@ -209,6 +246,102 @@ bool Node::validate(string* message) const
     return InterfaceElement::validate(message) && res;
 }
 
+namespace
+{
+
+// A precomputed instantiation template for a graph implementation, recording
+// its nodes, internal edges, and interface bindings once for all instances.
+class SubgraphTemplate
+{
+  public:
+    explicit SubgraphTemplate(NodeGraphPtr nodeGraph) :
+        nodes(nodeGraph->getNodes())
+    {
+        std::unordered_map<ConstNodePtr, size_t> nodeIndices;
+        for (size_t i = 0; i < nodes.size(); i++)
+        {
+            nodeIndices[nodes[i]] = i;
+        }
+
+        edges.resize(nodes.size());
+        feedsOutput.resize(nodes.size(), false);
+        interfaceInputs.resize(nodes.size());
+        for (size_t i = 0; i < nodes.size(); i++)
+        {
+            for (InputPtr input : nodes[i]->getInputs())
+            {
+                auto it = nodeIndices.find(input->getConnectedNode());
+                if (it != nodeIndices.end())
+                {
+                    edges[it->second].emplace_back(i, input->getName());
+                }
+                if (input->hasInterfaceName())
+                {
+                    interfaceInputs[i].push_back(input->getName());
+                }
+            }
+        }
+        for (OutputPtr output : nodeGraph->getOutputs())
+        {
+            auto it = nodeIndices.find(output->getConnectedNode());
+            if (it != nodeIndices.end())
+            {
+                feedsOutput[it->second] = true;
+            }
+            size_t nodeIndex = (it != nodeIndices.end()) ? it->second : nodes.size();
+            outputNodes[output->getName()] = std::make_pair(output->getNodeName(), nodeIndex);
+        }
+    }
+
+    // The nodes of the graph.
+    vector<NodePtr> nodes;
+
+    // For each node, the index and input name of each downstream node input.
+    vector<vector<std::pair<size_t, string>>> edges;
+
+    // For each node, whether it is connected to a graph output.
+    vector<bool> feedsOutput;
+
+    // For each node, the names of its inputs bound to the graph interface.
+    vector<StringVec> interfaceInputs;
+
+    // For each graph output, its node name and the index of its node, or the
+    // node count if the node is not part of the graph.
+    std::unordered_map<string, std::pair<string, size_t>> outputNodes;
+};
+
+// Allocates unique child names within a graph element, remembering the last
+// name allocated for each requested name, so that repeated requests resume
+// from the previous candidate rather than rescanning the sequence of names.
+class ChildNameAllocator
+{
+  public:
+    explicit ChildNameAllocator(const GraphElement& graph) :
+        _graph(graph)
+    {
+    }
+
+    string allocate(const string& name)
+    {
+        string& candidate = _candidates[name];
+        if (candidate.empty())
+        {
+            candidate = name.empty() ? "_" : createValidName(name);
+        }
+        while (_graph.getChild(candidate))
+        {
+            candidate = incrementName(candidate);
+        }
+        return candidate;
+    }
+
+  private:
+    const GraphElement& _graph;
+    StringMap _candidates;
+};
+
+} // anonymous namespace
+
 //
 // GraphElement methods
 //
@@ -228,6 +361,9 @@ NodePtr GraphElement::addMaterialNode(const string& name, ConstNodePtr shaderNod
 
 void GraphElement::flattenSubgraphs(const string& target, NodePredicate filter)
 {
+    std::unordered_map<NodeGraphPtr, SubgraphTemplate> templateMap;
+    ChildNameAllocator nameAllocator(*this);
+
     vector<NodePtr> nodeQueue = getNodes();
     while (!nodeQueue.empty())
     {
@@ -235,7 +371,7 @@ void GraphElement::flattenSubgraphs(const string& target, NodePredicate filter)
         // and graph implementations for these nodes.
         using PortElementVec = vector<PortElementPtr>;
         std::vector<NodePtr> processNodeVec;
-        std::unordered_map<NodePtr, NodeGraphPtr> graphImplMap;
+        std::unordered_map<NodePtr, const SubgraphTemplate*> graphImplMap;
         std::unordered_map<NodePtr, ConstInterfaceElementPtr> declarationMap;
         std::unordered_map<NodePtr, PortElementVec> downstreamPortMap;
         for (NodePtr node : nodeQueue)
@@ -246,104 +382,97 @@ void GraphElement::flattenSubgraphs(const string& target, NodePredicate filter)
             }
 
             InterfaceElementPtr implement = node->getImplementation(target);
-            if (implement && implement->isA<NodeGraph>())
+            NodeGraphPtr implGraph = implement ? implement->asA<NodeGraph>() : nullptr;
+            if (implGraph)
             {
+                auto it = templateMap.find(implGraph);
+                if (it == templateMap.end())
+                {
+                    it = templateMap.emplace(implGraph, SubgraphTemplate(implGraph)).first;
+                }
                 processNodeVec.push_back(node);
-                graphImplMap[node] = implement->asA<NodeGraph>();
+                graphImplMap[node] = &it->second;
                 declarationMap[node] = node->getDeclaration(target);
                 downstreamPortMap[node] = node->getDownstreamPorts();
-                for (NodePtr sourceSubNode : implement->asA<NodeGraph>()->getNodes())
-                {
-                    downstreamPortMap[sourceSubNode] = sourceSubNode->getDownstreamPorts();
-                }
             }
         }
         nodeQueue.clear();
 
         // Iterate through nodes with graph implementations.
+        std::unordered_map<ElementPtr, vector<ElementPtr>> replacementMap;
         for (NodePtr processNode : processNodeVec)
         {
-            NodeGraphPtr sourceSubGraph = graphImplMap[processNode];
-            std::unordered_map<NodePtr, NodePtr> subNodeMap;
+            const SubgraphTemplate& subgraph = *graphImplMap[processNode];
+            vector<ElementPtr>& destSubNodes = replacementMap[processNode];
+            destSubNodes.reserve(subgraph.nodes.size());
 
             // Create a new instance of each original subnode.
-            for (NodePtr sourceSubNode : sourceSubGraph->getNodes())
+            for (NodePtr sourceSubNode : subgraph.nodes)
             {
-                string origName = sourceSubNode->getName();
-                string destName = createValidChildName(origName);
+                string destName = nameAllocator.allocate(sourceSubNode->getName());
                 NodePtr destSubNode = addNode(sourceSubNode->getCategory(), destName);
-
                 destSubNode->copyContentFrom(sourceSubNode);
-                setChildIndex(destSubNode->getName(), getChildIndex(processNode->getName()));
-
-                // Store the mapping between subgraphs.
-                subNodeMap[sourceSubNode] = destSubNode;
+                destSubNodes.push_back(destSubNode);
 
                 // Add the subnode to the queue, allowing processing of nested subgraphs.
                 nodeQueue.push_back(destSubNode);
             }
 
             // Update properties of generated subnodes.
-            for (const auto& subNodePair : subNodeMap)
+            for (size_t i = 0; i < subgraph.nodes.size(); i++)
             {
-                NodePtr sourceSubNode = subNodePair.first;
-                NodePtr destSubNode = subNodePair.second;
+                NodePtr destSubNode = destSubNodes[i]->asA<Node>();
+                const string& destName = destSubNode->getName();
 
                 // Update node connections.
-                for (PortElementPtr sourcePort : downstreamPortMap[sourceSubNode])
+                if (destName != subgraph.nodes[i]->getName())
                 {
-                    if (sourcePort->isA<Input>())
+                    for (const auto& edge : subgraph.edges[i])
                     {
-                        auto it = subNodeMap.find(sourcePort->getParent()->asA<Node>());
-                        if (it != subNodeMap.end())
+                        InputPtr processNodeInput = destSubNodes[edge.first]->asA<Node>()->getInput(edge.second);
+                        if (processNodeInput)
                         {
-                            InputPtr processNodeInput = it->second->getInput(sourcePort->getName());
-                            if (processNodeInput)
-                            {
-                                processNodeInput->setNodeName(destSubNode->getName());
-                            }
+                            processNodeInput->setNodeName(destName);
                         }
                     }
-                    else if (sourcePort->isA<Output>())
+                }
+                if (subgraph.feedsOutput[i])
+                {
+                    for (PortElementPtr processNodePort : downstreamPortMap[processNode])
                     {
-                        for (PortElementPtr processNodePort : downstreamPortMap[processNode])
-                        {
-                            processNodePort->setNodeName(destSubNode->getName());
-                        }
+                        processNodePort->setNodeName(destName);
                     }
                 }
 
                 // Transfer interface properties.
-                for (InputPtr destInput : destSubNode->getInputs())
+                for (const string& inputName : subgraph.interfaceInputs[i])
                 {
-                    if (destInput->hasInterfaceName())
+                    InputPtr destInput = destSubNode->getInput(inputName);
+                    InputPtr sourceInput = processNode->getInput(destInput->getInterfaceName());
+                    if (sourceInput)
                     {
-                        InputPtr sourceInput = processNode->getInput(destInput->getInterfaceName());
-                        if (sourceInput)
-                        {
-                            destInput->copyContentFrom(sourceInput);
-                        }
-                        else
+                        destInput->copyContentFrom(sourceInput);
+                    }
+                    else
+                    {
+                        ConstInterfaceElementPtr declaration = declarationMap[processNode];
+                        InputPtr declInput = declaration ? declaration->getActiveInput(destInput->getInterfaceName()) : nullptr;
+                        if (declInput)
                         {
-                            ConstInterfaceElementPtr declaration = declarationMap[processNode];
-                            InputPtr declInput = declaration ? declaration->getActiveInput(destInput->getInterfaceName()) : nullptr;
-                            if (declInput)
+                            if (declInput->hasValueString())
                             {
-                                if (declInput->hasValueString())
-                                {
-                                    destInput->setValueString(declInput->getValueString());
-                                }
-                                if (declInput->hasDefaultGeomPropString())
+                                destInput->setValueString(declInput->getValueString());
+                            }
+                            if (declInput->hasDefaultGeomPropString())
+                            {
+                                ConstGeomPropDefPtr geomPropDef = getDocument()->getGeomPropDef(declInput->getDefaultGeomPropString());
+                                if (geomPropDef)
                                 {
-                                    ConstGeomPropDefPtr geomPropDef = getDocument()->getGeomPropDef(declInput->getDefaultGeomPropString());
-                                    if (geomPropDef)
-                                    {
-                                        destInput->setConnectedNode(addGeomNode(geomPropDef, "geomNode"));
-                                    }
+                                    destInput->setConnectedNode(addGeomNode(geomPropDef, "geomNode"));
                                 }
                             }
-                            destInput->removeAttribute(ValueElement::INTERFACE_NAME_ATTRIBUTE);
                         }
+                        destInput->removeAttribute(ValueElement::INTERFACE_NAME_ATTRIBUTE);
                     }
                 }
             }
@@ -353,25 +482,24 @@ void GraphElement::flattenSubgraphs(const string& target, NodePredicate filter)
             {
                 if (downstreamPort->hasOutputString())
                 {
-                    OutputPtr subGraphOutput = sourceSubGraph->getOutput(downstreamPort->getOutputString());
-                    if (subGraphOutput)
+                    auto it = subgraph.outputNodes.find(downstreamPort->getOutputString());
+                    if (it != subgraph.outputNodes.end())
                     {
-                        string destName = subGraphOutput->getNodeName();
-                        NodePtr sourceSubNode = sourceSubGraph->getNode(destName);
-                        NodePtr destNode = sourceSubNode ? subNodeMap[sourceSubNode] : nullptr;
-                        if (destNode)
+                        string destName = it->second.first;
+                        if (it->second.second < destSubNodes.size())
                         {
-                            destName = destNode->getName();
+                            destName = destSubNodes[it->second.second]->getName();
                         }
                         downstreamPort->setNodeName(destName);
                         downstreamPort->setOutputString(EMPTY_STRING);
                     }
                 }
             }
-
-            // The processed node has been replaced, so remove it from the graph.
-            removeNode(processNode->getName());
         }
+
+        // The processed nodes have been replaced, so move their subnodes into
+        // place and remove them from the graph.
+        replaceChildren(replacementMap);
     }
 }
 
@@ -623,6 +751,50 @@ void Node::addInputsFromNodeDef()
     }
 }
 
+void Node::clearContent()
+{
+    _inputs.clear();
+    InterfaceElement::clearContent();
+}
+
+void Node::registerChildElement(ElementPtr child)
+{
+    InterfaceElement::registerChildElement(child);
+    InputPtr input = child->asA<Input>();
+    if (input)
+    {
+        _inputs.push_back(input);
+    }
+}
+
+void Node::unregisterChildElement(ElementPtr child)
+{
+    InterfaceElement::unregisterChildElement(child);
+    InputPtr input = child->asA<Input>();
+    if (input)
+    {
+        // Search from the back, where recently added inputs are found.
+        vector<InputPtr>::reverse_iterator it = std::find(_inputs.rbegin(), _inputs.rend(), input);
+        if (it != _inputs.rend())
+        {
+            _inputs.erase(std::next(it).base());
+        }
+    }
+}
+
+void Node::onChildOrderEdit()
+{
+    _inputs.clear();
+    for (const ElementPtr& child : getChildren())
+    {
+        InputPtr input = child->asA<Input>();
+        if (input)
+        {
+            _inputs.push_back(input);
+        }
+    }
+}
+
 InputPtr NodeGraph::addInterfaceName(const string& inputPath, const string& interfaceName)
 {
     NodeDefPtr nodeDef = getNodeDef();
@@ -154,6 +154,9 @@ class MX_CORE_API Node : public InterfaceElement
     /// Add inputs based on the corresponding associated node definition.
     void addInputsFromNodeDef();
 
+    /// Clear all attributes and descendants from this element.
+    void clearContent() override;
+
     /// @}
     /// @name Validation
     /// @{
@@ -166,6 +169,17 @@ class MX_CORE_API Node : public InterfaceElement
 
   public:
     static const string CATEGORY;
+
+  protected:
+    void registerChildElement(ElementPtr child) override;
+    void unregisterChildElement(ElementPtr child) override;
+    void onChildOrderEdit() override;
+    std::pair<Element*, Element*> getUpstreamEdgeElements(size_t index) const override;
+
+  private:
+    // The inputs of this node in child order, maintained as children are
+    // added, removed and reordered, so that upstream edges are found by index.
+    vector<InputPtr> _inputs;
 };
 
 /// @class GraphElement
@@ -48,9 +48,10 @@ TreeIterator& TreeIterator::operator++()
 
     if (!_prune && _elem && !_elem->getChildren().empty())
     {
-        // Traverse to the first child of this element.
-        _stack.emplace_back(_elem, 0);
-        _elem = _elem->getChildren()[0];
+        // Traverse to the first child of this element, moving ownership of
+        // the element into its stack frame.
+        _stack.emplace_back(std::move(_elem), 0);
+        _elem = _stack.back().first->getChildren()[0];
         return *this;
     }
     _prune = false;
@@ -84,14 +85,20 @@ TreeIterator& TreeIterator::operator++()
 
 size_t GraphIterator::getNodeDepth() const
 {
+    // The current path consists of the elements on the stack, followed by
+    // the current upstream element.
     size_t nodeDepth = 0;
-    for (ElementPtr elem : _pathElems)
+    for (const StackFrame& frame : _stack)
     {
-        if (elem->isA<Node>())
+        if (frame.first->isA<Node>())
         {
             nodeDepth++;
         }
     }
+    if (_upstreamElem && _upstreamElem->isA<Node>())
+    {
+        nodeDepth++;
+    }
     return nodeDepth;
 }
 
@@ -112,10 +119,8 @@ GraphIterator& GraphIterator::operator++()
     {
         // Traverse to the first upstream edge of this element.
         _stack.emplace_back(_upstreamElem, 0);
-        Edge nextEdge = _upstreamElem->getUpstreamEdge(0);
-        if (nextEdge && nextEdge.getUpstreamElement() && !skipOrMarkAsVisited(nextEdge))
+        if (traverseUpstreamEdge(_upstreamElem, 0))
         {
-            extendPathUpstream(nextEdge.getUpstreamElement(), nextEdge.getConnectingElement());
             return *this;
         }
     }
@@ -139,10 +144,8 @@ GraphIterator& GraphIterator::operator++()
         StackFrame& parentFrame = _stack.back();
         if (parentFrame.second + 1 < parentFrame.first->getUpstreamEdgeCount())
         {
-            Edge nextEdge = parentFrame.first->getUpstreamEdge(++parentFrame.second);
-            if (nextEdge && nextEdge.getUpstreamElement() && !skipOrMarkAsVisited(nextEdge))
+            if (traverseUpstreamEdge(parentFrame.first, ++parentFrame.second))
             {
-                extendPathUpstream(nextEdge.getUpstreamElement(), nextEdge.getConnectingElement());
                 return *this;
             }
             continue;
@@ -156,31 +159,57 @@ GraphIterator& GraphIterator::operator++()
     return *this;
 }
 
-void GraphIterator::extendPathUpstream(ElementPtr upstreamElem, ElementPtr connectingElem)
+bool GraphIterator::traverseUpstreamEdge(Element* downstreamElem, size_t index)
+{
+    // Query the edge by raw pointer, deferring the construction of shared
+    // pointers until the traversal is dereferenced.
+    std::pair<Element*, Element*> edge = downstreamElem->getUpstreamEdgeElements(index);
+    if (!edge.second)
+    {
+        return false;
+    }
+
+    EdgeKey key;
+    key.down = downstreamElem;
+    key.connect = edge.first;
+    key.up = edge.second;
+    if (skipOrMarkAsVisited(key))
+    {
+        return false;
+    }
+
+    extendPathUpstream(edge.second, edge.first);
+    return true;
+}
+
+void GraphIterator::extendPathUpstream(Element* upstreamElem, Element* connectingElem)
 {
     // Check for cycles.
-    if (_pathElems.count(upstreamElem))
+    if (!_pathElems.insert(upstreamElem))
     {
         throw ExceptionFoundCycle("Encountered cycle at element: " + upstreamElem->asString());
     }
 
     // Extend the current path to the new element.
-    _pathElems.insert(upstreamElem);
     _upstreamElem = upstreamElem;
     _connectingElem = connectingElem;
 }
 
-void GraphIterator::returnPathDownstream(ElementPtr upstreamElem)
+void GraphIterator::returnPathDownstream(Element* upstreamElem)
 {
     _pathElems.erase(upstreamElem);
-    _upstreamElem = ElementPtr();
-    _connectingElem = ElementPtr();
+    _upstreamElem = nullptr;
+    _connectingElem = nullptr;
+}
+
+bool GraphIterator::skipOrMarkAsVisited(const EdgeKey& key)
+{
+    return !_visitedEdges.insert(key);
 }
 
-bool GraphIterator::skipOrMarkAsVisited(const Edge& edge)
+ElementPtr GraphIterator::getSharedElement(Element* elem)
 {
-    auto [it, inserted] = _visitedEdges.emplace(edge);
-    return !inserted;
+    return elem ? elem->getSelfNonConst() : ElementPtr();
 }
 
 //
@@ -210,11 +239,10 @@ InheritanceIterator& InheritanceIterator::operator++()
         if (super)
         {
             // Check for cycles.
-            if (_pathElems.count(super))
+            if (!_pathElems.insert(super.get()))
             {
                 throw ExceptionFoundCycle("Encountered cycle at element: " + super->asString());
             }
-            _pathElems.insert(super);
         }
         _elem = super;
     }
@@ -18,6 +18,122 @@ class Element;
 using ElementPtr = shared_ptr<Element>;
 using ConstElementPtr = shared_ptr<const Element>;
 
+/// @class FlatHashSet
+/// A set of small, trivially copyable keys, stored in a single open-addressed
+/// table with linear probing.  A value-initialized key denotes an empty slot,
+/// and cannot itself be stored.  Clearing the set retains its storage, so that
+/// a set may be reused without further allocation.
+template <class Key, class Hash = std::hash<Key>> class FlatHashSet
+{
+  public:
+    /// Insert the given key, returning true if it was not already present.
+    bool insert(const Key& key)
+    {
+        if ((_size + 1) * 4 > _slots.size() * 3)
+        {
+            rehash(std::max(_slots.size() * 2, (size_t) 16));
+        }
+        size_t index = find(key);
+        if (_slots[index] == key)
+        {
+            return false;
+        }
+        _slots[index] = key;
+        _size++;
+        return true;
+    }
+
+    /// Return true if the given key is present.
+    bool contains(const Key& key) const
+    {
+        return !_slots.empty() && _slots[find(key)] == key;
+    }
+
+    /// Remove the given key, if present.
+    void erase(const Key& key)
+    {
+        if (_slots.empty())
+        {
+            return;
+        }
+        size_t index = find(key);
+        if (!(_slots[index] == key))
+        {
+            return;
+        }
+
+        // Shift subsequent keys of the probe sequence back into the gap.
+        const size_t mask = _slots.size() - 1;
+        size_t gap = index;
+        for (size_t next = (gap + 1) & mask; !(_slots[next] == Key()); next = (next + 1) & mask)
+        {
+            size_t home = getHomeSlot(_slots[next]);
+            if (((next - home) & mask) >= ((next - gap) & mask))
+            {
+                _slots[gap] = _slots[next];
+                gap = next;
+            }
+        }
+        _slots[gap] = Key();
+        _size--;
+    }
+
+    /// Remove all keys, retaining storage.
+    void clear()
+    {
+        std::fill(_slots.begin(), _slots.end(), Key());
+        _size = 0;
+    }
+
+    /// Return the number of keys in the set.
+    size_t size() const
+    {
+        return _size;
+    }
+
+  private:
+    // Return the preferred slot for the given key, scrambling its hash so
+    // that aligned pointer keys are spread across the table.
+    size_t getHomeSlot(const Key& key) const
+    {
+        size_t hash = Hash()(key) * (size_t) 0x9E3779B97F4A7C15ull;
+        hash ^= hash >> (sizeof(size_t) * 4);
+        return hash & (_slots.size() - 1);
+    }
+
+    // Return the slot holding the given key, or the empty slot at which it
+    // would be inserted.
+    size_t find(const Key& key) const
+    {
+        const size_t mask = _slots.size() - 1;
+        size_t index = getHomeSlot(key);
+        while (!(_slots[index] == key) && !(_slots[index] == Key()))
+        {
+            index = (index + 1) & mask;
+        }
+        return index;
+    }
+
+    void rehash(size_t slotCount)
+    {
+        vector<Key> slots(slotCount, Key());
+        std::swap(slots, _slots);
+        _size = 0;
+        for (const Key& key : slots)
+        {
+            if (!(key == Key()))
+            {
+                _slots[find(key)] = key;
+                _size++;
+            }
+        }
+    }
+
+  private:
+    vector<Key> _slots;
+    size_t _size = 0;
+};
+
 /// @class Edge
 /// An edge between two connected Elements, returned during graph traversal.
 ///
@@ -97,6 +213,8 @@ class MX_CORE_API TreeIterator
     ~TreeIterator() { }
 
   private:
+    // Stack frames own their parent elements, so that removing an ancestor
+    // of the current element during traversal leaves the path valid.
     using StackFrame = std::pair<ElementPtr, size_t>;
 
   public:
@@ -187,22 +305,53 @@ class MX_CORE_API TreeIterator
 /// @class GraphIterator
 /// An iterator object representing the state of an upstream graph traversal.
 ///
+/// The iterator walks elements by raw pointer, and holds a reference only to
+/// the element at which traversal begins, so the document containing the
+/// graph must outlive the traversal, and elements must not be removed from
+/// the graph while it is traversed.
+///
 /// @sa Element::traverseGraph
 class MX_CORE_API GraphIterator
 {
   public:
     explicit GraphIterator(ElementPtr elem) :
-        _upstreamElem(elem),
+        _root(elem),
+        _upstreamElem(elem.get()),
+        _connectingElem(nullptr),
         _prune(false),
         _holdCount(0)
     {
-        _pathElems.insert(elem);
+        if (elem)
+        {
+            _pathElems.insert(elem.get());
+        }
     }
     ~GraphIterator() { }
 
   private:
-    using ElementSet = std::set<ElementPtr>;
-    using StackFrame = std::pair<ElementPtr, size_t>;
+    struct EdgeKey
+    {
+        const Element* down = nullptr;
+        const Element* connect = nullptr;
+        const Element* up = nullptr;
+
+        bool operator==(const EdgeKey& rhs) const
+        {
+            return down == rhs.down && connect == rhs.connect && up == rhs.up;
+        }
+    };
+    struct EdgeKeyHash
+    {
+        size_t operator()(const EdgeKey& key) const
+        {
+            size_t hash = std::hash<const Element*>()(key.down);
+            hash = hash * 31 + std::hash<const Element*>()(key.connect);
+            return hash * 31 + std::hash<const Element*>()(key.up);
+        }
+    };
+    using ElementSet = FlatHashSet<const Element*>;
+    using EdgeSet = FlatHashSet<EdgeKey, EdgeKeyHash>;
+    using StackFrame = std::pair<Element*, size_t>;
 
   public:
     bool operator==(const GraphIterator& rhs) const
@@ -234,19 +383,19 @@ class MX_CORE_API GraphIterator
     /// Return the downstream element of the current edge.
     ElementPtr getDownstreamElement() const
     {
-        return !_stack.empty() ? _stack.back().first : ElementPtr();
+        return !_stack.empty() ? getSharedElement(_stack.back().first) : ElementPtr();
     }
 
     /// Return the connecting element, if any, of the current edge.
     ElementPtr getConnectingElement() const
     {
-        return _connectingElem;
+        return getSharedElement(_connectingElem);
     }
 
     /// Return the upstream element of the current edge.
     ElementPtr getUpstreamElement() const
     {
-        return _upstreamElem;
+        return getSharedElement(_upstreamElem);
     }
 
     /// Return the index of the current edge within the range of upstream edges
@@ -314,16 +463,19 @@ class MX_CORE_API GraphIterator
     /// @}
 
   private:
-    void extendPathUpstream(ElementPtr upstreamElem, ElementPtr connectingElem);
-    void returnPathDownstream(ElementPtr upstreamElem);
-    bool skipOrMarkAsVisited(const Edge&);
+    bool traverseUpstreamEdge(Element* downstreamElem, size_t index);
+    void extendPathUpstream(Element* upstreamElem, Element* connectingElem);
+    void returnPathDownstream(Element* upstreamElem);
+    bool skipOrMarkAsVisited(const EdgeKey& key);
+    static ElementPtr getSharedElement(Element* elem);
 
   private:
-    ElementPtr _upstreamElem;
-    ElementPtr _connectingElem;
+    ElementPtr _root;
+    Element* _upstreamElem;
+    Element* _connectingElem;
     ElementSet _pathElems;
     vector<StackFrame> _stack;
-    std::set<Edge> _visitedEdges;
+    EdgeSet _visitedEdges;
     bool _prune;
     size_t _holdCount;
 };
@@ -339,12 +491,15 @@ class MX_CORE_API InheritanceIterator
         _elem(elem),
         _holdCount(0)
     {
-        _pathElems.insert(elem);
+        if (elem)
+        {
+            _pathElems.insert(elem.get());
+        }
     }
     ~InheritanceIterator() { }
 
   private:
-    using ConstElementSet = std::set<ConstElementPtr>;
+    using ConstElementSet = FlatHashSet<const Element*>;
 
   public:
     bool operator==(const InheritanceIterator& rhs) const
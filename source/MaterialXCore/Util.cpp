@@ -118,6 +118,119 @@ string replaceSubstrings(string str, const StringMap& stringMap)
     return str;
 }
 
+//
+// SubstringReplacer methods
+//
+
+SubstringReplacer::SubstringReplacer() :
+    _nodes(1)
+{
+}
+
+SubstringReplacer::SubstringReplacer(const StringMap& stringMap) :
+    _nodes(1)
+{
+    for (const auto& pair : stringMap)
+    {
+        addSubstitution(pair.first, pair.second);
+    }
+}
+
+void SubstringReplacer::addSubstitution(const string& key, const string& value)
+{
+    if (key.empty())
+    {
+        return;
+    }
+
+    // Extend the trie along the characters of the key.
+    size_t node = 0;
+    for (char c : key)
+    {
+        size_t child = getChild(node, c);
+        if (!child)
+        {
+            child = _nodes.size();
+            _nodes.emplace_back();
+            _nodes[node].children.emplace_back(c, child);
+        }
+        node = child;
+    }
+
+    if (_nodes[node].valueIndex == NO_VALUE)
+    {
+        _nodes[node].valueIndex = _values.size();
+        _values.push_back(value);
+    }
+    else
+    {
+        _values[_nodes[node].valueIndex] = value;
+    }
+}
+
+string SubstringReplacer::apply(const string& str) const
+{
+    if (_values.empty())
+    {
+        return str;
+    }
+
+    string res;
+    size_t copyStart = 0;
+    size_t pos = 0;
+    while (pos < str.size())
+    {
+        // Find the longest key beginning at this position.
+        size_t matchValue = NO_VALUE;
+        size_t matchEnd = pos;
+        size_t node = 0;
+        for (size_t end = pos; end < str.size(); end++)
+        {
+            node = getChild(node, str[end]);
+            if (!node)
+            {
+                break;
+            }
+            if (_nodes[node].valueIndex != NO_VALUE)
+            {
+                matchValue = _nodes[node].valueIndex;
+                matchEnd = end + 1;
+            }
+        }
+
+        if (matchValue == NO_VALUE)
+        {
+            pos++;
+            continue;
+        }
+
+        // Copy any unmatched characters, followed by the substituted value.
+        res.append(str, copyStart, pos - copyStart);
+        res += _values[matchValue];
+        pos = matchEnd;
+        copyStart = pos;
+    }
+
+    if (!copyStart)
+    {
+        return str;
+    }
+    res.append(str, copyStart, string::npos);
+    return res;
+}
+
+size_t SubstringReplacer::getChild(size_t node, char c) const
+{
+    for (const auto& child : _nodes[node].children)
+    {
+        if (child.first == c)
+        {
+            return child.second;
+        }
+    }
+    return 0;
+}
+
 string stringToLower(string str)
 {
     std::transform(str.begin(), str.end(), str.begin(), [](unsigned char c)
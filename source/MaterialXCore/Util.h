@@ -42,6 +42,48 @@ MX_CORE_API string joinStrings(const StringVec& strVec, const string& sep);
 /// Apply the given substring substitutions to the input string.
 MX_CORE_API string replaceSubstrings(string str, const StringMap& stringMap);
 
+/// @class SubstringReplacer
+/// A compiled set of substring substitutions, which are applied to an input
+/// string in a single left-to-right pass.  Where substitution keys overlap at
+/// a given position, the longest key takes precedence, and substituted values
+/// are not themselves subject to further substitution.
+class MX_CORE_API SubstringReplacer
+{
+  public:
+    SubstringReplacer();
+    explicit SubstringReplacer(const StringMap& stringMap);
+
+    /// Add a substitution of the given key with the given value, replacing
+    /// any existing substitution for the key.  Empty keys are ignored.
+    void addSubstitution(const string& key, const string& value);
+
+    /// Return true if no substitutions have been added.
+    bool empty() const
+    {
+        return _values.empty();
+    }
+
+    /// Apply all substitutions to the given string, returning the result.
+    string apply(const string& str) const;
+
+  private:
+    struct Node
+    {
+        vector<std::pair<char, size_t>> children;
+        size_t valueIndex = NO_VALUE;
+    };
+
+    static const size_t NO_VALUE = (size_t) -1;
+
+    // Return the child of the given trie node for the given character,
+    // or zero if no such child exists.
+    size_t getChild(size_t node, char c) const;
+
+  private:
+    vector<Node> _nodes;
+    vector<string> _values;
+};
+
 /// Return a copy of the given string with letters converted to lower case.
 MX_CORE_API string stringToLower(string str);
 
@@ -7,6 +7,9 @@
 #include <MaterialXCore/Document.h>
 #include <MaterialXCore/Value.h>
 
+#include <algorithm>
+#include <cctype>
+#include <charconv>
 #include <iomanip>
 #include <sstream>
 #include <type_traits>
@@ -14,12 +17,14 @@
 MATERIALX_NAMESPACE_BEGIN
 
 Value::CreatorMap Value::_creatorMap;
-Value::FloatFormat Value::_floatFormat = Value::FloatFormatDefault;
-int Value::_floatPrecision = 6;
 
 namespace
 {
 
+// Float formatting state of the calling thread.
+thread_local Value::FloatFormat floatFormat = Value::FloatFormatDefault;
+thread_local int floatPrecision = 6;
+
 template <class T> using enable_if_mx_vector_t =
     typename std::enable_if<std::is_base_of<VectorBase, T>::value, T>::type;
 template <class T> using enable_if_mx_matrix_t =
@@ -30,7 +35,10 @@ template <class T> class is_std_vector<vector<T>> : public std::true_type { };
 template <class T> using enable_if_std_vector_t =
     typename std::enable_if<is_std_vector<T>::value, T>::type;
 
-template <class T> void stringToData(const string& str, T& data)
+template <class T> using enable_if_arithmetic_t =
+    typename std::enable_if<std::is_arithmetic<T>::value, T>::type;
+
+template <class T> void streamToData(const string& str, T& data)
 {
     std::stringstream ss(str);
     ss.imbue(std::locale::classic());
@@ -40,6 +48,110 @@ template <class T> void stringToData(const string& str, T& data)
     }
 }
 
+// Parse a number from the given character range, following the conventions
+// of formatted stream input in the classic locale, and returning false if
+// no valid number is found.
+template <class T> bool parseNumber(const char* begin, const char* end, enable_if_arithmetic_t<T>& data)
+{
+#if defined(__cpp_lib_to_chars)
+    // Skip leading whitespace and an optional plus sign, which are accepted
+    // by stream input but not by from_chars.
+    while (begin != end && std::isspace((unsigned char) *begin))
+    {
+        begin++;
+    }
+    bool plusSign = (begin != end && *begin == '+');
+    if (plusSign)
+    {
+        begin++;
+    }
+
+    // Require a digit or decimal point, rejecting the infinity and NaN
+    // spellings that are accepted by from_chars alone.
+    const char* first = (!plusSign && begin != end && *begin == '-') ? begin + 1 : begin;
+    if (first == end || !(std::isdigit((unsigned char) *first) || (std::is_floating_point<T>::value && *first == '.')))
+    {
+        return false;
+    }
+
+    std::from_chars_result result = std::from_chars(begin, end, data);
+    if (result.ec == std::errc::result_out_of_range && std::is_floating_point<T>::value)
+    {
+        // Defer to stream input for out-of-range floating-point values.
+        streamToData(string(begin, end), data);
+        return true;
+    }
+    if (result.ec != std::errc())
+    {
+        return false;
+    }
+
+    // Stream input consumes an exponent marker following the mantissa, and
+    // fails if it is not followed by a valid exponent.
+    if (std::is_floating_point<T>::value && result.ptr != end && (*result.ptr == 'e' || *result.ptr == 'E') &&
+        std::find_if(begin, result.ptr, [](char c) { return c == 'e' || c == 'E'; }) == result.ptr)
+    {
+        return false;
+    }
+    return true;
+#else
+    try
+    {
+        streamToData(string(begin, end), data);
+    }
+    catch (ExceptionTypeError&)
+    {
+        return false;
+    }
+    return true;
+#endif
+}
+
+// Parse each separated token of the given string with the given function,
+// returning false if the token count does not match or a token is invalid.
+template <class F> bool parseTokens(const string& str, size_t count, F parseToken)
+{
+    const char* pos = str.data();
+    const char* end = pos + str.size();
+    auto isSeparator = [](char c)
+    {
+        return ARRAY_VALID_SEPARATORS.find(c) != string::npos;
+    };
+
+    size_t index = 0;
+    while (true)
+    {
+        while (pos != end && isSeparator(*pos))
+        {
+            pos++;
+        }
+        if (pos == end)
+        {
+            break;
+        }
+        const char* tokenEnd = pos;
+        while (tokenEnd != end && !isSeparator(*tokenEnd))
+        {
+            tokenEnd++;
+        }
+        if (index >= count || !parseToken(index, pos, tokenEnd))
+        {
+            return false;
+        }
+        index++;
+        pos = tokenEnd;
+    }
+    return index == count;
+}
+
+template <class T> void stringToData(const string& str, T& data)
+{
+    if (!parseNumber<T>(str.data(), str.data() + str.size(), data))
+    {
+        throw ExceptionTypeError("Type mismatch in generic stringToData: " + str);
+    }
+}
+
 template <> void stringToData(const string& str, bool& data)
 {
     if (str == VALUE_STRING_TRUE)
@@ -57,30 +169,27 @@ template <> void stringToData(const string& str, string& data)
 
 template <class T> void stringToData(const string& str, enable_if_mx_vector_t<T>& data)
 {
-    StringVec tokens = splitString(str, ARRAY_VALID_SEPARATORS);
-    if (tokens.size() != data.numElements())
+    using S = typename std::decay<decltype(data[0])>::type;
+    bool valid = parseTokens(str, data.numElements(), [&data](size_t index, const char* begin, const char* end)
     {
-        throw ExceptionTypeError("Type mismatch in vector stringToData: " + str);
-    }
-    for (size_t i = 0; i < data.numElements(); i++)
+        return parseNumber<S>(begin, end, data[index]);
+    });
+    if (!valid)
     {
-        stringToData(tokens[i], data[i]);
+        throw ExceptionTypeError("Type mismatch in vector stringToData: " + str);
     }
 }
 
 template <class T> void stringToData(const string& str, enable_if_mx_matrix_t<T>& data)
 {
-    StringVec tokens = splitString(str, ARRAY_VALID_SEPARATORS);
-    if (tokens.size() != data.numRows() * data.numColumns())
+    using S = typename std::decay<decltype(data[0][0])>::type;
+    bool valid = parseTokens(str, data.numRows() * data.numColumns(), [&data](size_t index, const char* begin, const char* end)
     {
-        throw ExceptionTypeError("Type mismatch in matrix stringToData: " + str);
-    }
-    for (size_t i = 0; i < data.numRows(); i++)
+        return parseNumber<S>(begin, end, data[index / data.numColumns()][index % data.numColumns()]);
+    });
+    if (!valid)
     {
-        for (size_t j = 0; j < data.numColumns(); j++)
-        {
-            stringToData(tokens[i * data.numRows() + j], data[i][j]);
-        }
+        throw ExceptionTypeError("Type mismatch in matrix stringToData: " + str);
     }
 }
 
@@ -97,7 +206,7 @@ template <class T> void stringToData(const string& str, enable_if_std_vector_t<T
     }
 }
 
-template <class T> void dataToString(const T& data, string& str)
+template <class T> void streamFromData(const T& data, string& str)
 {
     std::stringstream ss;
     ss.imbue(std::locale::classic());
@@ -111,7 +220,49 @@ template <class T> void dataToString(const T& data, string& str)
     ss.precision(Value::getFloatPrecision());
 
     ss << data;
-    str = ss.str();
+    str += ss.str();
+}
+
+// Append the given number to a string, following the conventions of
+// formatted stream output in the classic locale, with the current float
+// format and precision.
+template <class T> void appendNumber(T data, string& str)
+{
+#if defined(__cpp_lib_to_chars)
+    char buffer[128];
+    std::to_chars_result result;
+    if constexpr (std::is_floating_point<T>::value)
+    {
+        const int precision = Value::getFloatPrecision();
+        if (precision < 0)
+        {
+            streamFromData(data, str);
+            return;
+        }
+        const Value::FloatFormat fmt = Value::getFloatFormat();
+        const std::chars_format format = (fmt == Value::FloatFormatFixed) ? std::chars_format::fixed :
+                                         (fmt == Value::FloatFormatScientific) ? std::chars_format::scientific :
+                                                                                 std::chars_format::general;
+        result = std::to_chars(buffer, buffer + sizeof(buffer), data, format, precision);
+    }
+    else
+    {
+        result = std::to_chars(buffer, buffer + sizeof(buffer), data);
+    }
+    if (result.ec != std::errc())
+    {
+        streamFromData(data, str);
+        return;
+    }
+    str.append(buffer, result.ptr);
+#else
+    streamFromData(data, str);
+#endif
+}
+
+template <class T> void dataToString(const T& data, string& str)
+{
+    appendNumber(data, str);
 }
 
 template <> void dataToString(const bool& data, string& str)
@@ -128,9 +279,7 @@ template <class T> void dataToString(const enable_if_mx_vector_t<T>& data, strin
 {
     for (size_t i = 0; i < data.numElements(); i++)
     {
-        string token;
-        dataToString(data[i], token);
-        str += token;
+        appendNumber(data[i], str);
         if (i + 1 < data.numElements())
         {
             str += ARRAY_PREFERRED_SEPARATOR;
@@ -144,9 +293,7 @@ template <class T> void dataToString(const enable_if_mx_matrix_t<T>& data, strin
     {
         for (size_t j = 0; j < data.numColumns(); j++)
         {
-            string token;
-            dataToString(data[i][j], token);
-            str += token;
+            appendNumber(data[i][j], str);
             if (i + 1 < data.numRows() ||
                 j + 1 < data.numColumns())
             {
@@ -269,6 +416,26 @@ template <class T> ValuePtr TypedValue<T>::createFromString(const string& value)
 // Value methods
 //
 
+void Value::setFloatFormat(FloatFormat format)
+{
+    floatFormat = format;
+}
+
+void Value::setFloatPrecision(int precision)
+{
+    floatPrecision = precision;
+}
+
+Value::FloatFormat Value::getFloatFormat()
+{
+    return floatFormat;
+}
+
+int Value::getFloatPrecision()
+{
+    return floatPrecision;
+}
+
 ValuePtr Value::createValueFromStrings(const string& value, const string& type, ConstTypeDefPtr typeDef)
 {
     CreatorMap::iterator it = _creatorMap.find(type);
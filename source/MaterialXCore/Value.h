@@ -96,31 +96,20 @@ class MX_CORE_API Value
     /// Return the value string for this value.
     virtual string getValueString() const = 0;
 
-    /// Set float formatting for converting values to strings.
-    /// Formats to use are FloatFormatFixed, FloatFormatScientific
-    /// or FloatFormatDefault to set default format.
-    static void setFloatFormat(FloatFormat format)
-    {
-        _floatFormat = format;
-    }
+    /// Set float formatting for converting values to strings on the
+    /// calling thread.  Formats to use are FloatFormatFixed,
+    /// FloatFormatScientific or FloatFormatDefault to set default format.
+    static void setFloatFormat(FloatFormat format);
 
-    /// Set float precision for converting values to strings.
-    static void setFloatPrecision(int precision)
-    {
-        _floatPrecision = precision;
-    }
+    /// Set float precision for converting values to strings on the
+    /// calling thread.
+    static void setFloatPrecision(int precision);
 
-    /// Return the current float format.
-    static FloatFormat getFloatFormat()
-    {
-        return _floatFormat;
-    }
+    /// Return the current float format of the calling thread.
+    static FloatFormat getFloatFormat();
 
-    /// Return the current float precision.
-    static int getFloatPrecision()
-    {
-        return _floatPrecision;
-    }
+    /// Return the current float precision of the calling thread.
+    static int getFloatPrecision();
 
   protected:
     template <class T> friend class ValueRegistry;
@@ -130,8 +119,6 @@ class MX_CORE_API Value
 
   private:
     static CreatorMap _creatorMap;
-    static FloatFormat _floatFormat;
-    static int _floatPrecision;
 };
 
 /// The class template for typed subclasses of Value
@@ -0,0 +1,294 @@
+//
+// Copyright Contributors to the MaterialX Project
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <MaterialXFormat/BinaryIo.h>
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+MATERIALX_NAMESPACE_BEGIN
+
+const string MTLX_BINARY_EXTENSION = "mtlxb";
+
+namespace
+{
+
+const char SNAPSHOT_MAGIC[8] = { 'M', 'T', 'L', 'X', 'S', 'N', 'A', 'P' };
+const uint32_t SNAPSHOT_FORMAT_VERSION = 1;
+
+//
+// Writing
+//
+
+class SnapshotWriter
+{
+  public:
+    string write(ConstElementPtr root)
+    {
+        // Gather records first, so that the string table precedes them.
+        writeElement(root);
+
+        string output(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+        appendUint(output, SNAPSHOT_FORMAT_VERSION);
+        appendUint(output, (uint32_t) _strings.size());
+        for (const string& str : _strings)
+        {
+            appendUint(output, (uint32_t) str.size());
+            output.append(str);
+        }
+        output.append(_records);
+        return output;
+    }
+
+  private:
+    void writeElement(ConstElementPtr elem)
+    {
+        appendUint(_records, getStringIndex(elem->getCategory()));
+        appendUint(_records, getStringIndex(elem->getName()));
+        appendUint(_records, getStringIndex(elem->getSourceUri()));
+
+        const StringVec& attrNames = elem->getAttributeNames();
+        appendUint(_records, (uint32_t) attrNames.size());
+        for (const string& attrName : attrNames)
+        {
+            appendUint(_records, getStringIndex(attrName));
+            appendUint(_records, getStringIndex(elem->getAttribute(attrName)));
+        }
+
+        const vector<ElementPtr>& children = elem->getChildren();
+        appendUint(_records, (uint32_t) children.size());
+        for (ConstElementPtr child : children)
+        {
+            writeElement(child);
+        }
+    }
+
+    uint32_t getStringIndex(const string& str)
+    {
+        auto it = _stringIndices.find(str);
+        if (it != _stringIndices.end())
+        {
+            return it->second;
+        }
+        uint32_t index = (uint32_t) _strings.size();
+        _stringIndices[str] = index;
+        _strings.push_back(str);
+        return index;
+    }
+
+    static void appendUint(string& output, uint32_t value)
+    {
+        char bytes[4] = { (char) (value & 0xff),
+                          (char) ((value >> 8) & 0xff),
+                          (char) ((value >> 16) & 0xff),
+                          (char) ((value >> 24) & 0xff) };
+        output.append(bytes, sizeof(bytes));
+    }
+
+  private:
+    std::unordered_map<string, uint32_t> _stringIndices;
+    StringVec _strings;
+    string _records;
+};
+
+//
+// Reading
+//
+
+class SnapshotReader
+{
+  public:
+    SnapshotReader(const char* buffer, size_t size) :
+        _pos(buffer),
+        _end(buffer + size)
+    {
+    }
+
+    void read(DocumentPtr doc)
+    {
+        if ((size_t) (_end - _pos) < sizeof(SNAPSHOT_MAGIC) ||
+            std::memcmp(_pos, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0)
+        {
+            throw ExceptionParseError("Buffer is not a MaterialX binary snapshot");
+        }
+        _pos += sizeof(SNAPSHOT_MAGIC);
+        uint32_t formatVersion = readUint();
+        if (formatVersion != SNAPSHOT_FORMAT_VERSION)
+        {
+            throw ExceptionParseError("Unsupported binary snapshot format version: " + std::to_string(formatVersion));
+        }
+
+        uint32_t stringCount = readUint();
+        _strings.reserve(std::min((size_t) stringCount, (size_t) (_end - _pos) / 4));
+        for (uint32_t i = 0; i < stringCount; i++)
+        {
+            uint32_t length = readUint();
+            requireBytes(length);
+            _strings.emplace_back(_pos, length);
+            _pos += length;
+        }
+
+        const string& category = readString();
+        readString();
+        const string& sourceUri = readString();
+        if (category != Document::CATEGORY)
+        {
+            throw ExceptionParseError("Binary snapshot root is not a document");
+        }
+        if (!sourceUri.empty())
+        {
+            doc->setSourceUri(sourceUri);
+        }
+        readContent(doc);
+
+        if (_pos != _end)
+        {
+            throw ExceptionParseError("Unexpected data at end of binary snapshot");
+        }
+    }
+
+  private:
+    void readContent(ElementPtr elem)
+    {
+        uint32_t attrCount = readUint();
+        for (uint32_t i = 0; i < attrCount; i++)
+        {
+            const string& attrName = readString();
+            const string& attrValue = readString();
+            elem->setAttribute(attrName, attrValue);
+        }
+
+        uint32_t childCount = readUint();
+        for (uint32_t i = 0; i < childCount; i++)
+        {
+            const string& category = readString();
+            const string& name = readString();
+            const string& sourceUri = readString();
+
+            // Skip duplicate elements, as in XML reads.
+            ElementPtr child = elem->getChild(name) ? nullptr : elem->addChildOfCategory(category, name);
+            if (child)
+            {
+                child->setSourceUri(sourceUri);
+                readContent(child);
+            }
+            else
+            {
+                skipContent();
+            }
+        }
+    }
+
+    void skipContent()
+    {
+        uint32_t attrCount = readUint();
+        for (uint32_t i = 0; i < attrCount; i++)
+        {
+            readString();
+            readString();
+        }
+        uint32_t childCount = readUint();
+        for (uint32_t i = 0; i < childCount; i++)
+        {
+            readString();
+            readString();
+            readString();
+            skipContent();
+        }
+    }
+
+    uint32_t readUint()
+    {
+        requireBytes(4);
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(_pos);
+        _pos += 4;
+        return (uint32_t) bytes[0] |
+               ((uint32_t) bytes[1] << 8) |
+               ((uint32_t) bytes[2] << 16) |
+               ((uint32_t) bytes[3] << 24);
+    }
+
+    const string& readString()
+    {
+        uint32_t index = readUint();
+        if (index >= _strings.size())
+        {
+            throw ExceptionParseError("Invalid string index in binary snapshot");
+        }
+        return _strings[index];
+    }
+
+    void requireBytes(size_t count)
+    {
+        if ((size_t) (_end - _pos) < count)
+        {
+            throw ExceptionParseError("Unexpected end of binary snapshot");
+        }
+    }
+
+  private:
+    const char* _pos;
+    const char* _end;
+    StringVec _strings;
+};
+
+} // anonymous namespace
+
+//
+// Reading
+//
+
+void readFromBinaryBuffer(DocumentPtr doc, const char* buffer, size_t size)
+{
+    SnapshotReader reader(buffer, size);
+    reader.read(doc);
+
+    // Snapshots written by earlier versions of MaterialX are upgraded on
+    // read, while current snapshots are returned as-is.
+    doc->upgradeVersion();
+}
+
+void readFromBinaryFile(DocumentPtr doc, FilePath filename, FileSearchPath searchPath)
+{
+    searchPath.append(getEnvironmentPath());
+    filename = searchPath.find(filename);
+
+    std::ifstream file(filename.asString(), std::ios::in | std::ios::binary);
+    if (!file.is_open())
+    {
+        throw ExceptionFileMissing("Failed to open file for reading: " + filename.asString());
+    }
+    std::stringstream stream;
+    stream << file.rdbuf();
+    string buffer = stream.str();
+
+    doc->setSourceUri(filename);
+    readFromBinaryBuffer(doc, buffer.data(), buffer.size());
+}
+
+void readFromBinaryString(DocumentPtr doc, const string& str)
+{
+    readFromBinaryBuffer(doc, str.data(), str.size());
+}
+
+//
+// Writing
+//
+
+void writeToBinaryFile(DocumentPtr doc, const FilePath& filename)
+{
+    string buffer = writeToBinaryString(doc);
+    std::ofstream ofs(filename.asString(), std::ios::out | std::ios::binary);
+    ofs.write(buffer.data(), (std::streamsize) buffer.size());
+}
+
+string writeToBinaryString(DocumentPtr doc)
+{
+    SnapshotWriter writer;
+    return writer.write(doc);
+}
+
+MATERIALX_NAMESPACE_END
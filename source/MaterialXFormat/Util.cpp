@@ -5,9 +5,14 @@
 
 #include <MaterialXFormat/Util.h>
 
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <functional>
 #include <fstream>
 #include <iostream>
 #include <sstream>
+#include <thread>
 
 #if defined(__APPLE__) && defined(BUILD_APPLE_FRAMEWORK)
     #include <dlfcn.h>
@@ -44,10 +49,98 @@ void getSubdirectories(const FilePathVec& rootDirectories, const FileSearchPath&
     }
 }
 
+namespace
+{
+
+// Run the given task for each index in [0, taskCount), distributing indices
+// dynamically across the given number of worker threads.  A worker count of
+// zero selects the hardware concurrency of the system.
+void runParallelTasks(size_t taskCount, unsigned int workerCount, const std::function<void(size_t)>& task)
+{
+    if (workerCount == 0)
+    {
+        workerCount = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    workerCount = (unsigned int) std::min((size_t) workerCount, taskCount);
+    if (workerCount <= 1)
+    {
+        for (size_t i = 0; i < taskCount; i++)
+        {
+            task(i);
+        }
+        return;
+    }
+
+    std::atomic<size_t> nextTask(0);
+    vector<std::thread> workers;
+    for (unsigned int i = 0; i < workerCount; i++)
+    {
+        workers.emplace_back([&nextTask, &task, taskCount]()
+        {
+            for (size_t index = nextTask++; index < taskCount; index = nextTask++)
+            {
+                task(index);
+            }
+        });
+    }
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+}
+
+// The result of reading a single file into its own document.
+struct FileReadResult
+{
+    DocumentPtr doc;
+    std::exception_ptr exception;
+    string error;
+    double parseTime = 0.0;
+};
+
+// Read each of the given files into a separate document, using the given
+// number of worker threads.
+vector<FileReadResult> readFilesParallel(const FilePathVec& files,
+                                         const vector<FileSearchPath>& searchPaths,
+                                         const XmlReadOptions* readOptions,
+                                         unsigned int workerCount)
+{
+    vector<FileReadResult> results(files.size());
+    runParallelTasks(files.size(), workerCount, [&](size_t index)
+    {
+        FileReadResult& result = results[index];
+        auto startTime = std::chrono::steady_clock::now();
+        try
+        {
+            DocumentPtr doc = createDocument();
+            readFromXmlFile(doc, files[index], searchPaths[index], readOptions);
+            result.doc = doc;
+        }
+        catch (Exception& e)
+        {
+            result.exception = std::current_exception();
+            result.error = e.what();
+        }
+        catch (...)
+        {
+            result.exception = std::current_exception();
+        }
+        std::chrono::duration<double> parseTime = std::chrono::steady_clock::now() - startTime;
+        result.parseTime = parseTime.count();
+    });
+    return results;
+}
+
+} // anonymous namespace
+
 void loadDocuments(const FilePath& rootPath, const FileSearchPath& searchPath, const StringSet& skipFiles,
                    const StringSet& includeFiles, vector<DocumentPtr>& documents, StringVec& documentsPaths,
-                   const XmlReadOptions* readOptions, StringVec* errors)
+                   const XmlReadOptions* readOptions, StringVec* errors,
+                   unsigned int workerCount, ParseTimeMap* parseTimes)
 {
+    // Gather files in a deterministic order.
+    FilePathVec files;
+    vector<FileSearchPath> readSearchPaths;
     for (const FilePath& dir : rootPath.getSubDirectories())
     {
         for (const FilePath& file : dir.getFilesInDirectory(MTLX_EXTENSION))
@@ -55,26 +148,37 @@ void loadDocuments(const FilePath& rootPath, const FileSearchPath& searchPath, c
             if (!skipFiles.count(file) &&
                 (includeFiles.empty() || includeFiles.count(file)))
             {
-                DocumentPtr doc = createDocument();
-                const FilePath filePath = dir / file;
-                try
-                {
-                    FileSearchPath readSearchPath(searchPath);
-                    readSearchPath.append(dir);
-                    readFromXmlFile(doc, filePath, readSearchPath, readOptions);
-                    documents.push_back(doc);
-                    documentsPaths.push_back(filePath.asString());
-                }
-                catch (Exception& e)
-                {
-                    if (errors)
-                    {
-                        errors->push_back("Failed to load: " + filePath.asString() + ". Error: " + e.what());
-                    }
-                }
+                FileSearchPath readSearchPath(searchPath);
+                readSearchPath.append(dir);
+                files.push_back(dir / file);
+                readSearchPaths.push_back(readSearchPath);
             }
         }
     }
+
+    // Read files, and gather results in the original order.
+    vector<FileReadResult> results = readFilesParallel(files, readSearchPaths, readOptions, workerCount);
+    for (size_t i = 0; i < files.size(); i++)
+    {
+        const string filePath = files[i].asString();
+        if (parseTimes)
+        {
+            (*parseTimes)[filePath] = results[i].parseTime;
+        }
+        if (results[i].doc)
+        {
+            documents.push_back(results[i].doc);
+            documentsPaths.push_back(filePath);
+        }
+        else if (results[i].error.empty())
+        {
+            std::rethrow_exception(results[i].exception);
+        }
+        else if (errors)
+        {
+            errors->push_back("Failed to load: " + filePath + ". Error: " + results[i].error);
+        }
+    }
 }
 
 void loadLibrary(const FilePath& file, DocumentPtr doc, const FileSearchPath& searchPath, const XmlReadOptions* readOptions)
@@ -88,33 +192,22 @@ StringSet loadLibraries(const FilePathVec& libraryFolders,
                         const FileSearchPath& searchPath,
                         DocumentPtr doc,
                         const StringSet& excludeFiles,
-                        const XmlReadOptions* readOptions)
+                        const XmlReadOptions* readOptions,
+                        unsigned int workerCount,
+                        ParseTimeMap* parseTimes)
 {
     // Append environment path to the specified search path.
     FileSearchPath librarySearchPath = searchPath;
     librarySearchPath.append(getEnvironmentPath());
 
-    StringSet loadedLibraries;
+    // Gather library files in a deterministic order.
+    FilePathVec libraryPaths;
     if (libraryFolders.empty())
     {
         // No libraries specified so scan in all search paths
         for (const FilePath& libraryPath : librarySearchPath)
         {
-            for (const FilePath& path : libraryPath.getSubDirectories())
-            {
-                for (const FilePath& filename : path.getFilesInDirectory(MTLX_EXTENSION))
-                {
-                    if (!excludeFiles.count(filename))
-                    {
-                        const FilePath& file = path / filename;
-                        if (loadedLibraries.count(file) == 0)
-                        {
-                            loadLibrary(file, doc, searchPath, readOptions);
-                            loadedLibraries.insert(file.asString());
-                        }
-                    }
-                }
-            }
+            libraryPaths.push_back(libraryPath);
         }
     }
     else
@@ -122,50 +215,66 @@ StringSet loadLibraries(const FilePathVec& libraryFolders,
         // Look for specific library folders in the search paths
         for (const FilePath& libraryName : libraryFolders)
         {
-            FilePath libraryPath = librarySearchPath.find(libraryName);
-            for (const FilePath& path : libraryPath.getSubDirectories())
+            libraryPaths.push_back(librarySearchPath.find(libraryName));
+        }
+    }
+    FilePathVec files;
+    StringSet loadedLibraries;
+    for (const FilePath& libraryPath : libraryPaths)
+    {
+        for (const FilePath& path : libraryPath.getSubDirectories())
+        {
+            for (const FilePath& filename : path.getFilesInDirectory(MTLX_EXTENSION))
             {
-                for (const FilePath& filename : path.getFilesInDirectory(MTLX_EXTENSION))
+                if (!excludeFiles.count(filename))
                 {
-                    if (!excludeFiles.count(filename))
+                    const FilePath& file = path / filename;
+                    if (loadedLibraries.count(file) == 0)
                     {
-                        const FilePath& file = path / filename;
-                        if (loadedLibraries.count(file) == 0)
-                        {
-                            loadLibrary(file, doc, searchPath, readOptions);
-                            loadedLibraries.insert(file.asString());
-                        }
+                        files.push_back(file);
+                        loadedLibraries.insert(file.asString());
                     }
                 }
             }
         }
     }
+
+    // Read library files, and import them in the original order.
+    vector<FileReadResult> results = readFilesParallel(files, vector<FileSearchPath>(files.size(), searchPath), readOptions, workerCount);
+    for (size_t i = 0; i < files.size(); i++)
+    {
+        if (parseTimes)
+        {
+            (*parseTimes)[files[i].asString()] = results[i].parseTime;
+        }
+        if (!results[i].doc)
+        {
+            std::rethrow_exception(results[i].exception);
+        }
+        doc->importLibrary(results[i].doc);
+    }
     return loadedLibraries;
 }
 
 void flattenFilenames(DocumentPtr doc, const FileSearchPath& searchPath, StringResolverPtr customResolver)
 {
-    for (ElementPtr elem : doc->traverseTree())
+    for (const auto& pair : resolveFilenames(doc))
     {
-        ValueElementPtr valueElem = elem->asA<ValueElement>();
-        if (!valueElem || valueElem->getType() != FILENAME_TYPE_STRING)
-        {
-            continue;
-        }
-
+        ValueElementPtr valueElem = pair.first;
         FilePath unresolvedValue(valueElem->getValueString());
         if (unresolvedValue.isEmpty())
         {
             continue;
         }
-        StringResolverPtr elementResolver = elem->createStringResolver();
+        string resolvedString = pair.second;
         // If the path is already absolute then don't allow an additional prefix
         // as this would make the path invalid.
         if (unresolvedValue.isAbsolute())
         {
+            StringResolverPtr elementResolver = valueElem->createStringResolver();
             elementResolver->setFilePrefix(EMPTY_STRING);
+            resolvedString = valueElem->getResolvedValueString(elementResolver);
         }
-        string resolvedString = valueElem->getResolvedValueString(elementResolver);
 
         // Convert relative to absolute pathing if the file is not already found
         if (!searchPath.isEmpty())
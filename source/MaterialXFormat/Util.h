@@ -26,7 +26,16 @@ MX_FORMAT_API string readFile(const FilePath& file);
 /// Get all subdirectories for a given set of directories and search paths
 MX_FORMAT_API void getSubdirectories(const FilePathVec& rootDirectories, const FileSearchPath& searchPath, FilePathVec& subDirectories);
 
-/// Scans for all documents under a root path and returns documents which can be loaded
+/// A map from file paths to the time, in seconds, taken to parse each file.
+using ParseTimeMap = std::unordered_map<string, double>;
+
+/// Scans for all documents under a root path and returns documents which can be loaded.
+/// Files may be parsed concurrently, with documents and errors returned in the
+/// same order as a serial load.
+/// @param workerCount The number of worker threads used to parse files, where
+///    zero selects the hardware concurrency of the system.
+/// @param parseTimes An optional output map, to which the parse time of each
+///    file is written.
 MX_FORMAT_API void loadDocuments(const FilePath& rootPath,
                                  const FileSearchPath& searchPath,
                                  const StringSet& skipFiles,
@@ -34,7 +43,9 @@ MX_FORMAT_API void loadDocuments(const FilePath& rootPath,
                                  vector<DocumentPtr>& documents,
                                  StringVec& documentsPaths,
                                  const XmlReadOptions* readOptions = nullptr,
-                                 StringVec* errors = nullptr);
+                                 StringVec* errors = nullptr,
+                                 unsigned int workerCount = 1,
+                                 ParseTimeMap* parseTimes = nullptr);
 
 /// Load a given MaterialX library into a document
 MX_FORMAT_API void loadLibrary(const FilePath& file,
@@ -44,11 +55,19 @@ MX_FORMAT_API void loadLibrary(const FilePath& file,
 
 /// Load all MaterialX files within the given library folders into a document,
 /// using the given search path to locate the folders on the file system.
+/// Files may be parsed concurrently, and are imported into the document in
+/// the same order as a serial load.
+/// @param workerCount The number of worker threads used to parse files, where
+///    zero selects the hardware concurrency of the system.
+/// @param parseTimes An optional output map, to which the parse time of each
+///    file is written.
 MX_FORMAT_API StringSet loadLibraries(const FilePathVec& libraryFolders,
                                       const FileSearchPath& searchPath,
                                       DocumentPtr doc,
                                       const StringSet& excludeFiles = StringSet(),
-                                      const XmlReadOptions* readOptions = nullptr);
+                                      const XmlReadOptions* readOptions = nullptr,
+                                      unsigned int workerCount = 1,
+                                      ParseTimeMap* parseTimes = nullptr);
 
 /// Flatten all filenames in the given document, applying string resolvers at the
 /// scope of each element and removing all fileprefix attributes.
@@ -9,6 +9,16 @@
 
 #include <MaterialXCore/Types.h>
 
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
 #include <cstring>
 #include <fstream>
 #include <sstream>
@@ -25,6 +35,7 @@ namespace
 const string XINCLUDE_TAG = "xi:include";
 const string XINCLUDE_NAMESPACE = "xmlns:xi";
 const string XINCLUDE_URL = "http://www.w3.org/2001/XInclude";
+const string ANONYMOUS_TAG = ":anonymous";
 
 void elementFromXml(const xml_node& xmlNode, ElementPtr elem, const XmlReadOptions* readOptions)
 {
@@ -78,76 +89,237 @@ void elementFromXml(const xml_node& xmlNode, ElementPtr elem, const XmlReadOptio
     }
 }
 
-void elementToXml(ConstElementPtr elem, xml_node& xmlNode, const XmlWriteOptions* writeOptions)
+// A streaming XML serializer, which writes the element tree directly to an
+// output stream, producing the same indented format as pugixml.
+class XmlStreamWriter
 {
-    bool writeXIncludeEnable = writeOptions ? writeOptions->writeXIncludeEnable : true;
-    ElementPredicate elementPredicate = writeOptions ? writeOptions->elementPredicate : nullptr;
-
-    // Store attributes in XML.
-    if (!elem->getName().empty())
+  public:
+    XmlStreamWriter(std::ostream& stream, const XmlWriteOptions* writeOptions) :
+        _stream(stream),
+        _writeXIncludeEnable(writeOptions ? writeOptions->writeXIncludeEnable : true),
+        _elementPredicate(writeOptions ? writeOptions->elementPredicate : nullptr)
     {
-        xmlNode.append_attribute(Element::NAME_ATTRIBUTE.c_str()) = elem->getName().c_str();
+        _buffer.reserve(BUFFER_SIZE + BUFFER_SIZE / 4);
     }
-    for (const string& attrName : elem->getAttributeNames())
+
+    void writeDocument(ConstDocumentPtr doc)
     {
-        xml_attribute xmlAttr = xmlNode.append_attribute(attrName.c_str());
-        xmlAttr.set_value(elem->getAttribute(attrName).c_str());
+        _docSourceUri = doc->getSourceUri();
+        _layerXIncludes = doc->getLayerXIncludes();
+        _buffer += "<?xml version=\"1.0\"?>\n";
+        writeElement(doc, 0);
+        _buffer += '\n';
+        flush();
     }
 
-    // Create child nodes and recurse.
-    StringSet writtenSourceFiles;
-    for (auto child : elem->getChildren())
+  private:
+    // A child to be written, either as an element or as an XInclude reference.
+    struct ChildEntry
+    {
+        ConstElementPtr elem;
+        string includeHref;
+    };
+
+    void writeElement(ConstElementPtr elem, unsigned int depth)
     {
-        if (elementPredicate && !elementPredicate(child))
+        // Gather the children to be written, so that empty elements and
+        // XInclude namespaces can be handled in the opening tag.
+        vector<ChildEntry> children;
+        StringSet writtenSourceFiles;
+
+        // XInclude references provided by data library layers are written
+        // first at the document level.
+        if (_writeXIncludeEnable && depth == 0)
         {
-            continue;
+            for (const string& href : _layerXIncludes)
+            {
+                if (!writtenSourceFiles.count(href))
+                {
+                    children.push_back({ nullptr, href });
+                    writtenSourceFiles.insert(href);
+                }
+            }
         }
 
-        // Write XInclude references if requested.
-        if (writeXIncludeEnable && child->hasSourceUri())
+        for (const ElementPtr& child : elem->getChildren())
         {
-            string sourceUri = child->getSourceUri();
-            if (sourceUri != elem->getDocument()->getSourceUri())
+            if (_elementPredicate && !_elementPredicate(child))
             {
-                if (!writtenSourceFiles.count(sourceUri))
+                continue;
+            }
+
+            // Write XInclude references if requested.
+            if (_writeXIncludeEnable && child->hasSourceUri())
+            {
+                const string& sourceUri = child->getSourceUri();
+                if (sourceUri != _docSourceUri)
                 {
-                    if (!xmlNode.attribute(XINCLUDE_NAMESPACE.c_str()))
+                    if (!writtenSourceFiles.count(sourceUri))
                     {
-                        xmlNode.append_attribute(XINCLUDE_NAMESPACE.c_str()) = XINCLUDE_URL.c_str();
+                        // Write relative include paths in Posix format, and absolute
+                        // include paths in native format.
+                        FilePath includePath(sourceUri);
+                        FilePath::Format includeFormat = includePath.isAbsolute() ? FilePath::FormatNative : FilePath::FormatPosix;
+                        children.push_back({ nullptr, includePath.asString(includeFormat) });
+                        writtenSourceFiles.insert(sourceUri);
                     }
-                    xml_node includeNode = xmlNode.append_child(XINCLUDE_TAG.c_str());
-                    xml_attribute includeAttr = includeNode.append_attribute("href");
-                    FilePath includePath(sourceUri);
+                    continue;
+                }
+            }
 
-                    // Write relative include paths in Posix format, and absolute
-                    // include paths in native format.
-                    FilePath::Format includeFormat = includePath.isAbsolute() ? FilePath::FormatNative : FilePath::FormatPosix;
-                    includeAttr.set_value(includePath.asString(includeFormat).c_str());
+            children.push_back({ child, EMPTY_STRING });
+        }
 
-                    writtenSourceFiles.insert(sourceUri);
-                }
-                continue;
+        // Write the opening tag and attributes.
+        const string& tag = !elem->getCategory().empty() ? elem->getCategory() : ANONYMOUS_TAG;
+        _buffer += '<';
+        _buffer += tag;
+        if (!elem->getName().empty())
+        {
+            writeAttribute(Element::NAME_ATTRIBUTE, elem->getName());
+        }
+        for (const string& attrName : elem->getAttributeNames())
+        {
+            writeAttribute(attrName, elem->getAttribute(attrName));
+        }
+        if (!writtenSourceFiles.empty() && !elem->hasAttribute(XINCLUDE_NAMESPACE))
+        {
+            writeAttribute(XINCLUDE_NAMESPACE, XINCLUDE_URL);
+        }
+        if (children.empty())
+        {
+            _buffer += " />";
+            return;
+        }
+        _buffer += '>';
+
+        // Write children and recurse.
+        for (const ChildEntry& entry : children)
+        {
+            _buffer += '\n';
+            if (!entry.elem)
+            {
+                writeIndent(depth + 1);
+                _buffer += '<';
+                _buffer += XINCLUDE_TAG;
+                writeAttribute("href", entry.includeHref);
+                _buffer += " />";
+            }
+            else if (entry.elem->getCategory() == CommentElement::CATEGORY)
+            {
+                writeIndent(depth + 1);
+                writeComment(entry.elem->getAttribute(Element::DOC_ATTRIBUTE));
+            }
+            else if (entry.elem->getCategory() != NewlineElement::CATEGORY)
+            {
+                writeIndent(depth + 1);
+                writeElement(entry.elem, depth + 1);
+            }
+            if (_buffer.size() >= BUFFER_SIZE)
+            {
+                flush();
             }
         }
 
-        // Write XML comments.
-        if (child->getCategory() == CommentElement::CATEGORY)
+        // Write the closing tag.
+        _buffer += '\n';
+        writeIndent(depth);
+        _buffer += "</";
+        _buffer += tag;
+        _buffer += '>';
+    }
+
+    void writeAttribute(const string& name, const string& value)
+    {
+        _buffer += ' ';
+        _buffer += name;
+        _buffer += "=\"";
+        for (char c : value)
         {
-            xml_node xmlChild = xmlNode.append_child(node_comment);
-            xmlChild.set_value(child->getAttribute(Element::DOC_ATTRIBUTE).c_str());
-            continue;
+            unsigned char ch = (unsigned char) c;
+            // Values end at an embedded null character, which cannot be
+            // represented in XML 1.0.
+            if (c == '\0')
+            {
+                break;
+            }
+            else if (c == '&')
+            {
+                _buffer += "&amp;";
+            }
+            else if (c == '"')
+            {
+                _buffer += "&quot;";
+            }
+            else if (ch < 32 && c != '\t')
+            {
+                _buffer += "&#";
+                _buffer += (char) ('0' + ch / 10);
+                _buffer += (char) ('0' + ch % 10);
+                _buffer += ';';
+            }
+            else
+            {
+                _buffer += c;
+            }
         }
+        _buffer += '"';
+    }
 
-        // Write XML newlines.
-        if (child->getCategory() == NewlineElement::CATEGORY)
+    void writeComment(const string& text)
+    {
+        // Separate hyphens that would otherwise terminate the comment.
+        _buffer += "<!--";
+        for (size_t i = 0; i < text.size() && text[i] != '\0'; i++)
         {
-            xml_node xmlChild = xmlNode.append_child(node_newline);
-            xmlChild.set_value("\n");
-            continue;
+            _buffer += text[i];
+            if (text[i] == '-' && (i + 1 == text.size() || text[i + 1] == '-' || text[i + 1] == '\0'))
+            {
+                _buffer += ' ';
+            }
         }
+        _buffer += "-->";
+    }
 
-        xml_node xmlChild = xmlNode.append_child(child->getCategory().c_str());
-        elementToXml(child, xmlChild, writeOptions);
+    void writeIndent(unsigned int depth)
+    {
+        _buffer.append(depth * 2, ' ');
+    }
+
+    void flush()
+    {
+        _stream.write(_buffer.data(), (std::streamsize) _buffer.size());
+        _buffer.clear();
+    }
+
+  private:
+    static const size_t BUFFER_SIZE = 64 * 1024;
+
+    std::ostream& _stream;
+    bool _writeXIncludeEnable;
+    ElementPredicate _elementPredicate;
+    string _docSourceUri;
+    StringVec _layerXIncludes;
+    string _buffer;
+};
+
+// Add the source URIs of the data library layers of the given document, and
+// of their top-level elements, to the given set.  Files with these URIs have
+// been loaded into a layer, so their contents are already visible through
+// the document.
+void getDataLibrarySourceUris(ConstDocumentPtr doc, StringSet& sourceUris)
+{
+    for (ConstDocumentPtr dataLibrary : doc->getDataLibraries())
+    {
+        sourceUris.insert(dataLibrary->getSourceUri());
+        for (const ElementPtr& child : dataLibrary->getChildren())
+        {
+            if (child->hasSourceUri())
+            {
+                sourceUris.insert(child->getSourceUri());
+            }
+        }
+        getDataLibrarySourceUris(dataLibrary, sourceUris);
     }
 }
 
@@ -156,6 +328,10 @@ void processXIncludes(DocumentPtr doc, xml_node& xmlNode, const FileSearchPath&
     // Search path for includes. Set empty and then evaluated once in the iteration through xml includes.
     FileSearchPath includeSearchPath;
 
+    // Source URIs of data library layers, gathered on the first include.
+    StringSet layerSourceUris;
+    bool layerSourceUrisFound = false;
+
     XmlReadFunction readXIncludeFunction = readOptions ? readOptions->readXIncludeFunction : readFromXmlFile;
     xml_node xmlChild = xmlNode.first_child();
     while (xmlChild)
@@ -203,10 +379,35 @@ void processXIncludes(DocumentPtr doc, xml_node& xmlNode, const FileSearchPath&
                         includeSearchPath = searchPath;
                     }
                 }
-                readXIncludeFunction(library, filename, includeSearchPath, &xiReadOptions);
 
-                // Import the library document.
-                doc->importLibrary(library);
+                // Skip files whose contents are already provided by a data
+                // library layer, rather than copying them into the document.
+                bool providedByLayer = false;
+                if (doc->hasDataLibrary())
+                {
+                    if (!layerSourceUrisFound)
+                    {
+                        getDataLibrarySourceUris(doc, layerSourceUris);
+                        layerSourceUris.erase(EMPTY_STRING);
+                        layerSourceUrisFound = true;
+                    }
+                    FileSearchPath layerSearchPath = includeSearchPath;
+                    layerSearchPath.append(getEnvironmentPath());
+                    providedByLayer = layerSourceUris.count(layerSearchPath.find(filename).asString()) > 0;
+                }
+
+                if (providedByLayer)
+                {
+                    // Record the reference, so that it may be written again.
+                    doc->addLayerXInclude(filename);
+                }
+                else
+                {
+                    readXIncludeFunction(library, filename, includeSearchPath, &xiReadOptions);
+
+                    // Import the library document.
+                    doc->importLibrary(library);
+                }
             }
 
             // Remove include directive.
@@ -282,6 +483,82 @@ unsigned int getParseOptions(const XmlReadOptions* readOptions)
     return parseOptions;
 }
 
+// A private, copy-on-write memory mapping of a file, which may be modified
+// in place by the XML parser without affecting the file on disk.
+class MappedFile
+{
+  public:
+    explicit MappedFile(const FilePath& filename)
+    {
+#if defined(_WIN32)
+        HANDLE file = CreateFileA(filename.asString().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                  OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            return;
+        }
+        LARGE_INTEGER fileSize;
+        if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0)
+        {
+            HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+            if (mapping)
+            {
+                _data = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+                _size = _data ? (size_t) fileSize.QuadPart : 0;
+                CloseHandle(mapping);
+            }
+        }
+        CloseHandle(file);
+#else
+        int file = open(filename.asString().c_str(), O_RDONLY);
+        if (file < 0)
+        {
+            return;
+        }
+        struct stat sb;
+        if (fstat(file, &sb) == 0 && sb.st_size > 0)
+        {
+            void* data = mmap(nullptr, (size_t) sb.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+            if (data != MAP_FAILED)
+            {
+                _data = data;
+                _size = (size_t) sb.st_size;
+            }
+        }
+        close(file);
+#endif
+    }
+
+    ~MappedFile()
+    {
+        if (_data)
+        {
+#if defined(_WIN32)
+            UnmapViewOfFile(_data);
+#else
+            munmap(_data, _size);
+#endif
+        }
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    void* getData() const
+    {
+        return _data;
+    }
+
+    size_t getSize() const
+    {
+        return _size;
+    }
+
+  private:
+    void* _data = nullptr;
+    size_t _size = 0;
+};
+
 } // anonymous namespace
 
 //
@@ -292,6 +569,7 @@ XmlReadOptions::XmlReadOptions() :
     readComments(false),
     readNewlines(false),
     upgradeVersion(true),
+    memoryMapFiles(false),
     readXIncludeFunction(readFromXmlFile)
 {
 }
@@ -336,8 +614,23 @@ void readFromXmlFile(DocumentPtr doc, FilePath filename, FileSearchPath searchPa
     searchPath.append(getEnvironmentPath());
     filename = searchPath.find(filename);
 
+    // When requested, parse a private mapping of the file in place, falling
+    // back to a buffered read if the file cannot be mapped.
     xml_document xmlDoc;
-    xml_parse_result result = xmlDoc.load_file(filename.asString().c_str(), getParseOptions(readOptions));
+    xml_parse_result result;
+    std::unique_ptr<MappedFile> mappedFile;
+    if (readOptions && readOptions->memoryMapFiles)
+    {
+        mappedFile = std::make_unique<MappedFile>(filename);
+    }
+    if (mappedFile && mappedFile->getData())
+    {
+        result = xmlDoc.load_buffer_inplace(mappedFile->getData(), mappedFile->getSize(), getParseOptions(readOptions));
+    }
+    else
+    {
+        result = xmlDoc.load_file(filename.asString().c_str(), getParseOptions(readOptions));
+    }
     validateParseResult(result, filename);
 
     // This must be done before parsing the XML as the source URI
@@ -365,10 +658,8 @@ void readFromXmlString(DocumentPtr doc, const string& str, const FileSearchPath&
 
 void writeToXmlStream(DocumentPtr doc, std::ostream& stream, const XmlWriteOptions* writeOptions)
 {
-    xml_document xmlDoc;
-    xml_node xmlRoot = xmlDoc.append_child("materialx");
-    elementToXml(doc, xmlRoot, writeOptions);
-    xmlDoc.save(stream, "  ");
+    XmlStreamWriter writer(stream, writeOptions);
+    writer.writeDocument(doc);
 }
 
 void writeToXmlFile(DocumentPtr doc, const FilePath& filename, const XmlWriteOptions* writeOptions)
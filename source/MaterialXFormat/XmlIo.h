@@ -46,6 +46,10 @@ class MX_FORMAT_API XmlReadOptions
     /// to the current version.  Defaults to true.
     bool upgradeVersion;
 
+    /// If true, then files will be memory-mapped and parsed in place, rather
+    /// than read into an intermediate heap buffer.  Defaults to false.
+    bool memoryMapFiles;
+
     /// If provided, this function will be invoked when an XInclude reference
     /// needs to be read into a document.  Defaults to readFromXmlFile.
     XmlReadFunction readXIncludeFunction;
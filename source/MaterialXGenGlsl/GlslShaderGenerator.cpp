@@ -166,6 +166,8 @@ GlslShaderGenerator::GlslShaderGenerator() :
 
 ShaderPtr GlslShaderGenerator::generate(const string& name, ElementPtr element, GenContext& context) const
 {
+    StructTypeRegistry::Scope structTypeScope(&getStructTypes());
+
     ShaderPtr shader = createShader(name, element, context);
 
     // Request fixed floating-point notation for consistency across targets.
@@ -188,6 +190,13 @@ ShaderPtr GlslShaderGenerator::generate(const string& name, ElementPtr element,
     emitPixelStage(shader->getGraph(), context, ps);
     replaceTokens(_tokenSubstitutions, ps);
 
+    // Remove unused library code if requested.
+    if (context.getOptions().stripUnusedCode)
+    {
+        vs.stripUnusedCode();
+        ps.stripUnusedCode();
+    }
+
     return shader;
 }
 
@@ -150,6 +150,9 @@ GlslSyntax::GlslSyntax()
     tokens["_webgl"] = "wwebgl";
     registerInvalidTokens(tokens);
 
+    // Register the stage entry point in GLSL
+    registerEntryPoints({ "main" });
+
     //
     // Register syntax handlers for each data type.
     //
@@ -133,6 +133,8 @@ ShaderPtr MdlShaderGenerator::generate(const string& name, ElementPtr element, G
     // depending on the context in which a node is used.
     context.clearNodeImplementations();
 
+    StructTypeRegistry::Scope structTypeScope(&getStructTypes());
+
     ShaderPtr shader = createShader(name, element, context);
 
     // Request fixed floating-point notation for consistency across targets.
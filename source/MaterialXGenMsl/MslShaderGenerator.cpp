@@ -171,6 +171,8 @@ MslShaderGenerator::MslShaderGenerator() :
 
 ShaderPtr MslShaderGenerator::generate(const string& name, ElementPtr element, GenContext& context) const
 {
+    StructTypeRegistry::Scope structTypeScope(&getStructTypes());
+
     ShaderPtr shader = createShader(name, element, context);
 
     // Request fixed floating-point notation for consistency across targets.
@@ -202,6 +204,13 @@ ShaderPtr MslShaderGenerator::generate(const string& name, ElementPtr element, G
 
     MetalizeGeneratedShader(ps);
 
+    // Remove unused library code if requested.
+    if (context.getOptions().stripUnusedCode)
+    {
+        vs.stripUnusedCode();
+        ps.stripUnusedCode();
+    }
+
     return shader;
 }
 
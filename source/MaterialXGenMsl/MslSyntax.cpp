@@ -132,6 +132,9 @@ MslSyntax::MslSyntax()
     tokens["_webgl"] = "wwebgl";
     registerInvalidTokens(tokens);
 
+    // Register the stage entry points in MSL
+    registerEntryPoints({ "vertex", "fragment", "kernel", "VertexMain", "FragmentMain" });
+
     //
     // Register syntax handlers for each data type.
     //
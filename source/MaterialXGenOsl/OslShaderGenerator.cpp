@@ -54,6 +54,8 @@ OslShaderGenerator::OslShaderGenerator() :
 
 ShaderPtr OslShaderGenerator::generate(const string& name, ElementPtr element, GenContext& context) const
 {
+    StructTypeRegistry::Scope structTypeScope(&getStructTypes());
+
     ShaderPtr shader = createShader(name, element, context);
 
     // Request fixed floating-point notation for consistency across targets.
@@ -240,6 +242,12 @@ ShaderPtr OslShaderGenerator::generate(const string& name, ElementPtr element, G
     // Perform token substitution
     replaceTokens(_tokenSubstitutions, stage);
 
+    // Remove unused library code if requested.
+    if (context.getOptions().stripUnusedCode)
+    {
+        stage.stripUnusedCode();
+    }
+
     return shader;
 }
 
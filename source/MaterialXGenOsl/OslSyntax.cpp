@@ -261,6 +261,9 @@ OslSyntax::OslSyntax()
           "translucent_bsdf", "transparent_bsdf", "subsurface_bssrdf", "sheen_bsdf", "uniform_edf", "anisotropic_vdf",
           "medium_vdf", "layer", "artistic_ior" });
 
+    // Register the shader types that declare entry points in OSL
+    registerEntryPoints({ "shader", "surface", "displacement", "volume" });
+
     //
     // Register type syntax handlers for each data type.
     //
@@ -6,6 +6,8 @@
 #include <MaterialXGenShader/GenContext.h>
 #include <MaterialXGenShader/ShaderGenerator.h>
 
+#include <MaterialXFormat/Util.h>
+
 MATERIALX_NAMESPACE_BEGIN
 
 //
@@ -40,6 +42,11 @@ GenContext::GenContext(ShaderGeneratorPtr sg) :
     _applicationVariableHandler = nullptr;
 }
 
+string GenContext::readSourceFile(const FilePath& filename) const
+{
+    return _sourceCodeCache ? _sourceCodeCache->getSource(filename) : readFile(filename);
+}
+
 void GenContext::addNodeImplementation(const string& name, ShaderNodeImplPtr impl)
 {
     _nodeImpls[name] = impl;
@@ -159,4 +166,37 @@ ScopedSetVariableName::~ScopedSetVariableName()
     _port->setVariable(_oldName);
 }
 
+//
+// SourceCodeCache methods
+//
+
+string SourceCodeCache::getSource(const FilePath& filename)
+{
+    const string& key = filename.asString();
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _sources.find(key);
+        if (it != _sources.end())
+        {
+            return it->second;
+        }
+    }
+
+    // Read the file outside of the lock, so that other files may be read
+    // concurrently.  Failed reads are not cached.
+    string source = readFile(filename);
+    if (!source.empty())
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _sources.emplace(key, source);
+    }
+    return source;
+}
+
+void SourceCodeCache::clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _sources.clear();
+}
+
 MATERIALX_NAMESPACE_END
@@ -17,9 +17,15 @@
 
 #include <MaterialXFormat/File.h>
 
+#include <mutex>
+
 MATERIALX_NAMESPACE_BEGIN
 
 class ClosureContext;
+class SourceCodeCache;
+
+/// A shared pointer to a source code cache
+using SourceCodeCachePtr = shared_ptr<SourceCodeCache>;
 
 /// A standard function to allow for handling of application variables for a given node
 using ApplicationVariableHandler = std::function<void(ShaderNode*, GenContext&)>;
@@ -77,6 +83,24 @@ class MX_GENSHADER_API GenContext
         return searchPath.find(filename).getNormalized();
     }
 
+    /// Set a cache of source code files, which may be shared with other
+    /// contexts in order to read each source file only once.
+    void setSourceCodeCache(SourceCodeCachePtr cache)
+    {
+        _sourceCodeCache = cache;
+    }
+
+    /// Return the cache of source code files, if any.
+    SourceCodeCachePtr getSourceCodeCache() const
+    {
+        return _sourceCodeCache;
+    }
+
+    /// Return the contents of a resolved source code file, using the source
+    /// code cache if one has been set.  Returns an empty string if the file
+    /// cannot be read.
+    string readSourceFile(const FilePath& filename) const;
+
     /// Add reserved words that should not be used as
     /// identifiers during code generation.
     void addReservedWords(const StringSet& names)
@@ -226,6 +250,7 @@ class MX_GENSHADER_API GenContext
     ShaderGeneratorPtr _sg;
     GenOptions _options;
     FileSearchPath _sourceCodeSearchPath;
+    SourceCodeCachePtr _sourceCodeCache;
     StringSet _reservedWords;
 
     std::unordered_map<string, ShaderNodeImplPtr> _nodeImpls;
@@ -239,6 +264,29 @@ class MX_GENSHADER_API GenContext
     ApplicationVariableHandler _applicationVariableHandler;
 };
 
+/// @class SourceCodeCache
+/// A thread-safe cache of source code file contents.
+class MX_GENSHADER_API SourceCodeCache
+{
+  public:
+    /// Create a new source code cache.
+    static SourceCodeCachePtr create()
+    {
+        return std::make_shared<SourceCodeCache>();
+    }
+
+    /// Return the contents of the given file, reading it on first request.
+    /// Returns an empty string if the file cannot be read.
+    string getSource(const FilePath& filename);
+
+    /// Clear all cached file contents.
+    void clear();
+
+  private:
+    std::mutex _mutex;
+    std::unordered_map<string, string> _sources;
+};
+
 /// @class ClosureContext
 /// Class representing a context for closure evaluation.
 /// On hardware BSDF closures are evaluated differently in reflection, transmission
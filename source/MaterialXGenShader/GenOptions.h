@@ -81,6 +81,7 @@ class MX_GENSHADER_API GenOptions
         addUpstreamDependencies(true),
         libraryPrefix("libraries"),
         emitColorTransforms(true),
+        stripUnusedCode(false),
         hwTransparency(false),
         hwSpecularEnvironmentMethod(SPECULAR_ENVIRONMENT_FIS),
         hwDirectionalAlbedoMethod(DIRECTIONAL_ALBEDO_ANALYTIC),
@@ -134,6 +135,12 @@ class MX_GENSHADER_API GenOptions
     /// system is defined. Defaults to true.
     bool emitColorTransforms;
 
+    /// Enables the removal of functions, structs and constants that are
+    /// not reachable from the entry points of each shader stage, such as
+    /// unused functions from included library files. Only applies to
+    /// targets whose syntax declares its entry points. Defaults to false.
+    bool stripUnusedCode;
+
     /// Sets if transparency is needed or not for HW shaders.
     /// If a surface shader has potential of being transparent
     /// this must be set to true, otherwise no transparency
@@ -31,7 +31,7 @@ void SourceCodeNode::resolveSourceCode(const InterfaceElement& element, GenConte
 
     FilePath localPath = FilePath(impl.getActiveSourceUri()).getParentPath();
     _sourceFilename = context.resolveSourceFile(impl.getAttribute("file"), localPath);
-    _functionSource = readFile(_sourceFilename);
+    _functionSource = context.readSourceFile(_sourceFilename);
     if (_functionSource.empty())
     {
         throw ExceptionShaderGenError("Failed to get source code from file '" + _sourceFilename.asString() +
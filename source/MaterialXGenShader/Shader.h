@@ -111,6 +111,7 @@ class MX_GENSHADER_API Shader
     std::unordered_map<string, ValuePtr> _attributeMap;
 
     friend class ShaderGenerator;
+    friend class ShaderCache;
 };
 
 MATERIALX_NAMESPACE_END
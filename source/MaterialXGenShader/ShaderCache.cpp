@@ -0,0 +1,1019 @@
+//
+// Copyright Contributors to the MaterialX Project
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <MaterialXGenShader/ShaderCache.h>
+
+#include <MaterialXGenShader/GenContext.h>
+#include <MaterialXGenShader/HwShaderGenerator.h>
+#include <MaterialXGenShader/ShaderGenerator.h>
+
+#include <MaterialXFormat/Util.h>
+
+#include <MaterialXCore/Util.h>
+
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <thread>
+#include <unordered_set>
+
+MATERIALX_NAMESPACE_BEGIN
+
+const size_t ShaderCache::DEFAULT_CAPACITY = 256;
+
+namespace
+{
+
+const string CACHE_FILE_HEADER = "MaterialXShaderCache 1";
+const string CACHE_FILE_EXTENSION = "mxshader";
+
+// Float precision used for values written to the on-disk tier, which is
+// sufficient for floats to be read back exactly.
+const int CACHE_FILE_FLOAT_PRECISION = 9;
+
+enum BlockType
+{
+    UNIFORM_BLOCK,
+    INPUT_BLOCK,
+    OUTPUT_BLOCK,
+    CONSTANT_BLOCK
+};
+
+bool isIdentifierChar(char c)
+{
+    return std::isalnum((unsigned char) c) || c == '_';
+}
+
+// Return the number of times the given text occurs in the given code, as a
+// whole sequence of tokens, along with the position of its first occurrence.
+size_t findTokens(const string& code, const string& text, size_t& position)
+{
+    size_t count = 0;
+    for (size_t pos = code.find(text); pos != string::npos; pos = code.find(text, pos + 1))
+    {
+        size_t end = pos + text.size();
+        bool tokenStart = pos == 0 || !isIdentifierChar(code[pos - 1]);
+        bool tokenEnd = !isIdentifierChar(text.back()) || end == code.size() ||
+                        !(isIdentifierChar(code[end]) || code[end] == '.');
+        if (tokenStart && tokenEnd)
+        {
+            if (!count)
+            {
+                position = pos;
+            }
+            count++;
+        }
+    }
+    return count;
+}
+
+// Return the candidate forms in which a value may be emitted as the default
+// of a shader input or uniform.
+StringVec getValueLiterals(const Syntax& syntax, TypeDesc type, ValuePtr value)
+{
+    if (!value)
+    {
+        return { syntax.getDefaultValue(type, true), syntax.getDefaultValue(type, false) };
+    }
+    return { syntax.getValue(type, *value, true),
+             syntax.getValue(type, *value, false),
+             "\"" + value->getValueString() + "\"" };
+}
+
+// Replace the emitted default of the given variable in the given code.
+// Returns false if the default cannot be located unambiguously.
+bool patchDefault(string& code, const string& variable, const StringVec& oldLiterals, const StringVec& newLiterals)
+{
+    const string assignment = variable + " = ";
+    size_t position = 0;
+    if (!findTokens(code, assignment, position))
+    {
+        // The variable is not assigned a default in this code.
+        return true;
+    }
+    for (size_t i = 0; i < oldLiterals.size(); i++)
+    {
+        if (findTokens(code, assignment + oldLiterals[i], position) == 1)
+        {
+            code.replace(position + assignment.size(), oldLiterals[i].size(), newLiterals[i]);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool valuesMatch(ValuePtr lhs, ValuePtr rhs)
+{
+    if (!lhs || !rhs)
+    {
+        return !lhs && !rhs;
+    }
+    return lhs->getTypeString() == rhs->getTypeString() &&
+           lhs->getValueString() == rhs->getValueString();
+}
+
+void appendField(string& key, const string& field)
+{
+    key += field;
+    key += '|';
+}
+
+void appendPort(string& key, const ShaderPort& port, bool includeValue)
+{
+    appendField(key, port.getName());
+    appendField(key, port.getType().getName());
+    appendField(key, port.getVariable());
+    appendField(key, port.getPath());
+    appendField(key, port.getSemantic());
+    appendField(key, port.getUnit());
+    appendField(key, port.getColorSpace());
+    appendField(key, port.getGeomProp());
+    appendField(key, std::to_string(port.getFlags()));
+    if (includeValue)
+    {
+        appendField(key, port.getValue() ? port.getValueString() : "<none>");
+    }
+    if (port.getMetadata())
+    {
+        for (const ShaderMetadata& metadata : *port.getMetadata())
+        {
+            appendField(key, metadata.name);
+            appendField(key, metadata.value ? metadata.value->getValueString() : EMPTY_STRING);
+        }
+    }
+}
+
+void appendConnection(string& key, const ShaderOutput* connection)
+{
+    if (connection)
+    {
+        appendField(key, connection->getNode()->getName() + "." + connection->getName());
+    }
+    else
+    {
+        appendField(key, EMPTY_STRING);
+    }
+}
+
+// Append the nodes and outputs of the given graph to a fingerprint, along
+// with the contents of the graphs of any compound nodes.
+void appendGraph(string& key, const ShaderGraph& graph,
+                 const std::unordered_set<const ShaderOutput*>& publishedSockets,
+                 std::unordered_set<const ShaderGraph*>& compoundGraphs)
+{
+    // Graph nodes, in topological order
+    for (const ShaderNode* node : graph.getNodes())
+    {
+        key += "N|";
+        appendField(key, node->getName());
+        appendField(key, node->getImplementation().getName());
+        appendField(key, std::to_string(node->getClassification()));
+        key += '\n';
+        for (const ShaderInput* input : node->getInputs())
+        {
+            key += "i|";
+            appendPort(key, *input, !publishedSockets.count(input->getConnection()));
+            appendConnection(key, input->getConnection());
+            key += '\n';
+        }
+        for (const ShaderOutput* output : node->getOutputs())
+        {
+            key += "o|";
+            appendPort(key, *output, false);
+            key += '\n';
+        }
+
+        // Compound implementations are identified by their contents rather
+        // than their names, as these may be defined per document.
+        const ShaderGraph* compoundGraph = node->getImplementation().getGraph();
+        if (compoundGraph && compoundGraphs.insert(compoundGraph).second)
+        {
+            key += "C|";
+            appendField(key, compoundGraph->getName());
+            key += '\n';
+            for (const ShaderGraphInputSocket* socket : compoundGraph->getInputSockets())
+            {
+                key += "I|";
+                appendPort(key, *socket, true);
+                key += '\n';
+            }
+            appendGraph(key, *compoundGraph, {}, compoundGraphs);
+            key += "C|\n";
+        }
+    }
+
+    // Graph outputs
+    for (const ShaderGraphOutputSocket* socket : graph.getOutputSockets())
+    {
+        key += "O|";
+        appendPort(key, *socket, true);
+        appendConnection(key, socket->getConnection());
+        key += '\n';
+    }
+}
+
+// Writer and reader for length-prefixed fields of the on-disk tier.
+
+class FieldWriter
+{
+  public:
+    void write(const string& field)
+    {
+        _stream << field.size() << ' ' << field << '\n';
+    }
+
+    void write(size_t number)
+    {
+        write(std::to_string(number));
+    }
+
+    string str() const
+    {
+        return _stream.str();
+    }
+
+  private:
+    std::ostringstream _stream;
+};
+
+class FieldReader
+{
+  public:
+    FieldReader(const string& data) :
+        _data(data),
+        _pos(0)
+    {
+    }
+
+    string read()
+    {
+        size_t separator = _data.find(' ', _pos);
+        if (separator == string::npos)
+        {
+            throw Exception("Invalid shader cache file");
+        }
+        size_t length = std::stoul(_data.substr(_pos, separator - _pos));
+        if (separator + 1 + length >= _data.size())
+        {
+            throw Exception("Invalid shader cache file");
+        }
+        string field = _data.substr(separator + 1, length);
+        _pos = separator + length + 2;
+        return field;
+    }
+
+    size_t readNumber()
+    {
+        return std::stoul(read());
+    }
+
+  private:
+    const string& _data;
+    size_t _pos;
+};
+
+void writeValue(FieldWriter& writer, ValuePtr value)
+{
+    writer.write(value ? 1 : 0);
+    if (value)
+    {
+        writer.write(value->getTypeString());
+        writer.write(value->getValueString());
+    }
+}
+
+ValuePtr readValue(FieldReader& reader)
+{
+    if (!reader.readNumber())
+    {
+        return nullptr;
+    }
+    const string type = reader.read();
+    const string value = reader.read();
+    return Value::createValueFromStrings(value, type);
+}
+
+} // anonymous namespace
+
+//
+// ShaderCache::Template
+//
+
+struct ShaderCache::Template
+{
+    struct Port
+    {
+        TypeDesc type;
+        string name;
+        string variable;
+        string semantic;
+        string colorspace;
+        string unit;
+        string geomprop;
+        string path;
+        uint32_t flags = 0;
+        ValuePtr value;
+        ShaderMetadataVecPtr metadata;
+
+        // True if the port is an input socket of the shader graph, whose
+        // value is taken from the graph of each new shader.
+        bool socket = false;
+    };
+
+    struct Block
+    {
+        BlockType type;
+        string name;
+        string instance;
+        vector<size_t> ports;
+    };
+
+    struct Stage
+    {
+        string name;
+        string functionName;
+        string code;
+        StringSet includes;
+        StringSet dependencies;
+        vector<Block> blocks;
+    };
+
+    vector<std::pair<string, ValuePtr>> attributes;
+    vector<Port> ports;
+    vector<Stage> stages;
+    double generationTime = 0.0;
+};
+
+//
+// ShaderCache methods
+//
+
+ShaderCache::ShaderCache(size_t capacity) :
+    _capacity(capacity)
+{
+}
+
+ShaderCache::~ShaderCache()
+{
+}
+
+void ShaderCache::setCapacity(size_t capacity)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _capacity = capacity;
+    while (_templates.size() > _capacity)
+    {
+        _templateMap.erase(_templates.back().first);
+        _templates.pop_back();
+    }
+}
+
+size_t ShaderCache::getCapacity() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _capacity;
+}
+
+void ShaderCache::setCacheDirectory(const FilePath& directory)
+{
+    if (!directory.isEmpty() && !directory.exists())
+    {
+        directory.createDirectory();
+    }
+    std::lock_guard<std::mutex> lock(_mutex);
+    _directory = directory;
+}
+
+FilePath ShaderCache::getCacheDirectory() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _directory;
+}
+
+ShaderPtr ShaderCache::generate(const string& name, ElementPtr element, GenContext& context)
+{
+    ShaderGenerator& generator = context.getShaderGenerator();
+    StructTypeRegistry::Scope structTypeScope(&generator.getStructTypes());
+
+    // Resolve the shader graph, and look up its fingerprint.
+    auto startTime = std::chrono::steady_clock::now();
+    ShaderGraphPtr graph = ShaderGraph::create(nullptr, name, element, context);
+    const string fingerprint = getFingerprint(name, *graph, context);
+
+    bool diskHit = false;
+    TemplatePtr shaderTemplate = findTemplate(fingerprint);
+    if (!shaderTemplate)
+    {
+        shaderTemplate = readTemplate(fingerprint);
+        if (shaderTemplate)
+        {
+            diskHit = true;
+            addTemplate(fingerprint, shaderTemplate);
+        }
+    }
+    if (shaderTemplate)
+    {
+        ShaderPtr shader = createShader(*shaderTemplate, name, graph, context);
+        if (shader)
+        {
+            std::chrono::duration<double> duration = std::chrono::steady_clock::now() - startTime;
+            std::lock_guard<std::mutex> lock(_mutex);
+            (diskHit ? _statistics.diskHits : _statistics.memoryHits)++;
+            _statistics.savedTime += shaderTemplate->generationTime - duration.count();
+            return shader;
+        }
+    }
+
+    // Generate the shader, and cache it for later requests. The generation
+    // time includes the creation of the shader graph above, as this also
+    // loads node implementations into the context.
+    ShaderPtr shader = generator.generate(name, element, context);
+    std::chrono::duration<double> duration = std::chrono::steady_clock::now() - startTime;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _statistics.misses++;
+    }
+
+    shaderTemplate = createTemplate(*shader, duration.count());
+    addTemplate(fingerprint, shaderTemplate);
+    writeTemplate(fingerprint, *shaderTemplate);
+
+    return shader;
+}
+
+ShaderCache::Statistics ShaderCache::getStatistics() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _statistics;
+}
+
+void ShaderCache::resetStatistics()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _statistics = Statistics();
+}
+
+void ShaderCache::clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _templates.clear();
+    _templateMap.clear();
+    _sourceHashes.clear();
+}
+
+size_t ShaderCache::size() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _templates.size();
+}
+
+string ShaderCache::getFingerprint(const string& name, const ShaderGraph& graph, GenContext& context)
+{
+    ShaderGenerator& generator = context.getShaderGenerator();
+    const GenOptions& options = context.getOptions();
+
+    string key;
+    appendField(key, getVersionString());
+    appendField(key, generator.getTarget());
+    appendField(key, name);
+    appendField(key, context.getApplicationVariableHandler() ? "appvars" : EMPTY_STRING);
+
+    // Generation options
+    appendField(key, std::to_string(options.shaderInterfaceType));
+    appendField(key, std::to_string(options.fileTextureVerticalFlip));
+    appendField(key, options.targetColorSpaceOverride);
+    appendField(key, options.targetDistanceUnit);
+    appendField(key, std::to_string(options.addUpstreamDependencies));
+    appendField(key, options.libraryPrefix.asString());
+    appendField(key, std::to_string(options.emitColorTransforms));
+    appendField(key, std::to_string(options.stripUnusedCode));
+    appendField(key, std::to_string(options.hwTransparency));
+    appendField(key, std::to_string(options.hwSpecularEnvironmentMethod));
+    appendField(key, std::to_string(options.hwDirectionalAlbedoMethod));
+    appendField(key, std::to_string(options.hwTransmissionRenderMethod));
+    appendField(key, std::to_string(options.hwSrgbEncodeOutput));
+    appendField(key, std::to_string(options.hwWriteDepthMoments));
+    appendField(key, std::to_string(options.hwShadowMap));
+    appendField(key, std::to_string(options.hwAmbientOcclusion));
+    appendField(key, std::to_string(options.hwMaxActiveLightSources));
+    appendField(key, std::to_string(options.hwNormalizeUdimTexCoords));
+    appendField(key, std::to_string(options.hwWriteAlbedoTable));
+    appendField(key, std::to_string(options.hwWriteEnvPrefilter));
+    appendField(key, std::to_string(options.hwImplicitBitangents));
+    key += '\n';
+
+    // Bound light shaders
+    HwLightShadersPtr lightShaders = context.getUserData<HwLightShaders>(HW::USER_DATA_LIGHT_SHADERS);
+    if (lightShaders)
+    {
+        std::map<unsigned int, const ShaderNode*> sortedShaders;
+        for (const auto& it : lightShaders->get())
+        {
+            sortedShaders[it.first] = it.second.get();
+        }
+        for (const auto& it : sortedShaders)
+        {
+            appendField(key, std::to_string(it.first));
+            appendField(key, it.second->getName());
+            appendField(key, it.second->getImplementation().getName());
+        }
+        key += '\n';
+    }
+
+    // Graph interface. The values of inputs that are published as uniforms
+    // are excluded, as these are patched for each new shader.
+    appendField(key, std::to_string(graph.getClassification()));
+    std::unordered_set<const ShaderOutput*> publishedSockets;
+    std::unordered_set<const ShaderGraph*> compoundGraphs;
+    for (const ShaderGraphInputSocket* socket : graph.getInputSockets())
+    {
+        bool published = !socket->getConnections().empty() && graph.isEditable(*socket);
+        if (published)
+        {
+            publishedSockets.insert(socket);
+        }
+        key += published ? "P|" : "I|";
+        appendPort(key, *socket, !published);
+        key += '\n';
+    }
+
+    appendGraph(key, graph, publishedSockets, compoundGraphs);
+
+    return key;
+}
+
+ShaderCache::TemplatePtr ShaderCache::findTemplate(const string& fingerprint)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _templateMap.find(fingerprint);
+    if (it == _templateMap.end())
+    {
+        return nullptr;
+    }
+
+    // Move the template to the front of the recently used list.
+    _templates.splice(_templates.begin(), _templates, it->second);
+    return it->second->second;
+}
+
+void ShaderCache::addTemplate(const string& fingerprint, TemplatePtr shaderTemplate)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_capacity)
+    {
+        return;
+    }
+    auto it = _templateMap.find(fingerprint);
+    if (it != _templateMap.end())
+    {
+        _templates.erase(it->second);
+        _templateMap.erase(it);
+    }
+    _templates.emplace_front(fingerprint, shaderTemplate);
+    _templateMap[fingerprint] = _templates.begin();
+    while (_templates.size() > _capacity)
+    {
+        _templateMap.erase(_templates.back().first);
+        _templates.pop_back();
+    }
+}
+
+string ShaderCache::getSourceHash(const FilePath& file) const
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _sourceHashes.find(file);
+        if (it != _sourceHashes.end())
+        {
+            return it->second;
+        }
+    }
+
+    std::stringstream stream;
+    stream << std::hex << std::hash<string>()(readFile(file));
+    std::lock_guard<std::mutex> lock(_mutex);
+    _sourceHashes[file] = stream.str();
+    return stream.str();
+}
+
+ShaderCache::TemplatePtr ShaderCache::createTemplate(const Shader& shader, double generationTime)
+{
+    auto shaderTemplate = std::make_shared<Template>();
+    shaderTemplate->generationTime = generationTime;
+
+    for (const auto& it : shader._attributeMap)
+    {
+        shaderTemplate->attributes.emplace_back(it.first, it.second);
+    }
+
+    // Ports may be shared between blocks, so are stored once and referenced by index.
+    std::unordered_map<const ShaderPort*, size_t> portIndices;
+    auto addBlock = [&](Template::Stage& stage, BlockType type, const VariableBlock& block)
+    {
+        Template::Block blockTemplate { type, block.getName(), block.getInstance(), {} };
+        for (const ShaderPort* port : block.getVariableOrder())
+        {
+            auto it = portIndices.find(port);
+            if (it == portIndices.end())
+            {
+                Template::Port portTemplate;
+                portTemplate.type = port->getType();
+                portTemplate.name = port->getName();
+                portTemplate.variable = port->getVariable();
+                portTemplate.semantic = port->getSemantic();
+                portTemplate.colorspace = port->getColorSpace();
+                portTemplate.unit = port->getUnit();
+                portTemplate.geomprop = port->getGeomProp();
+                portTemplate.path = port->getPath();
+                portTemplate.flags = port->getFlags();
+                portTemplate.value = port->getValue();
+                portTemplate.metadata = port->getMetadata();
+                portTemplate.socket = port->getNode() == &shader.getGraph() &&
+                                      shader.getGraph().getInputSocket(port->getName()) == port;
+                it = portIndices.emplace(port, shaderTemplate->ports.size()).first;
+                shaderTemplate->ports.push_back(portTemplate);
+            }
+            blockTemplate.ports.push_back(it->second);
+        }
+        stage.blocks.push_back(blockTemplate);
+    };
+
+    for (const ShaderStage* stage : shader._stages)
+    {
+        Template::Stage stageTemplate;
+        stageTemplate.name = stage->getName();
+        stageTemplate.functionName = stage->getFunctionName();
+        stageTemplate.code = stage->getSourceCode();
+        stageTemplate.includes = stage->getIncludes();
+        stageTemplate.dependencies = stage->getSourceDependencies();
+        for (const auto& it : stage->getUniformBlocks())
+        {
+            addBlock(stageTemplate, UNIFORM_BLOCK, *it.second);
+        }
+        for (const auto& it : stage->getInputBlocks())
+        {
+            addBlock(stageTemplate, INPUT_BLOCK, *it.second);
+        }
+        for (const auto& it : stage->getOutputBlocks())
+        {
+            addBlock(stageTemplate, OUTPUT_BLOCK, *it.second);
+        }
+        addBlock(stageTemplate, CONSTANT_BLOCK, stage->getConstantBlock());
+        shaderTemplate->stages.push_back(stageTemplate);
+    }
+
+    return shaderTemplate;
+}
+
+ShaderPtr ShaderCache::createShader(const Template& shaderTemplate, const string& name,
+                                    ShaderGraphPtr graph, GenContext& context)
+{
+    ShaderGenerator& generator = context.getShaderGenerator();
+    const Syntax& syntax = generator.getSyntax();
+
+    // Use the float formatting of shader generation for emitted values.
+    ScopedFloatFormatting fmt(Value::FloatFormatFixed);
+
+    // Create ports, taking the values of graph sockets from the new graph,
+    // and collecting the defaults that need to be patched in source code.
+    struct Patch
+    {
+        string variable;
+        StringVec oldLiterals;
+        StringVec newLiterals;
+    };
+    vector<ShaderPortPtr> ports;
+    vector<Patch> patches;
+    for (const Template::Port& portTemplate : shaderTemplate.ports)
+    {
+        ValuePtr value = portTemplate.value;
+        if (portTemplate.socket)
+        {
+            const ShaderGraphInputSocket* socket = graph->getInputSocket(portTemplate.name);
+            if (!socket)
+            {
+                return nullptr;
+            }
+            value = socket->getValue();
+            if (!valuesMatch(value, portTemplate.value) && portTemplate.geomprop.empty())
+            {
+                patches.push_back({ portTemplate.variable,
+                                    getValueLiterals(syntax, portTemplate.type, portTemplate.value),
+                                    getValueLiterals(syntax, portTemplate.type, value) });
+            }
+        }
+
+        ShaderPortPtr port = std::make_shared<ShaderPort>(nullptr, portTemplate.type, portTemplate.name, value);
+        port->setVariable(portTemplate.variable);
+        port->setSemantic(portTemplate.semantic);
+        port->setColorSpace(portTemplate.colorspace);
+        port->setUnit(portTemplate.unit);
+        port->setGeomProp(portTemplate.geomprop);
+        port->setPath(portTemplate.path);
+        port->setFlags(portTemplate.flags);
+        port->setMetadata(portTemplate.metadata);
+        ports.push_back(port);
+    }
+
+    ShaderPtr shader = std::make_shared<Shader>(name, graph);
+    for (const auto& attribute : shaderTemplate.attributes)
+    {
+        shader->setAttribute(attribute.first, attribute.second);
+    }
+
+    for (const Template::Stage& stageTemplate : shaderTemplate.stages)
+    {
+        string code = stageTemplate.code;
+        for (const Patch& patch : patches)
+        {
+            if (!patchDefault(code, patch.variable, patch.oldLiterals, patch.newLiterals))
+            {
+                return nullptr;
+            }
+        }
+
+        ShaderStagePtr stage = shader->createStage(stageTemplate.name, generator._syntax);
+        stage->setFunctionName(stageTemplate.functionName);
+        stage->setSourceCode(code);
+        stage->_includes = stageTemplate.includes;
+        stage->_sourceDependencies = stageTemplate.dependencies;
+        for (const Template::Block& blockTemplate : stageTemplate.blocks)
+        {
+            VariableBlock* block = nullptr;
+            switch (blockTemplate.type)
+            {
+                case UNIFORM_BLOCK:
+                    block = stage->createUniformBlock(blockTemplate.name, blockTemplate.instance).get();
+                    break;
+                case INPUT_BLOCK:
+                    block = stage->createInputBlock(blockTemplate.name, blockTemplate.instance).get();
+                    break;
+                case OUTPUT_BLOCK:
+                    block = stage->createOutputBlock(blockTemplate.name, blockTemplate.instance).get();
+                    break;
+                case CONSTANT_BLOCK:
+                    block = &stage->getConstantBlock();
+                    break;
+            }
+            for (size_t index : blockTemplate.ports)
+            {
+                block->add(ports[index]);
+            }
+        }
+    }
+
+    return shader;
+}
+
+ShaderCache::TemplatePtr ShaderCache::readTemplate(const string& fingerprint) const
+{
+    FilePath directory = getCacheDirectory();
+    if (directory.isEmpty())
+    {
+        return nullptr;
+    }
+
+    std::stringstream nameStream;
+    nameStream << std::hex << std::setw(16) << std::setfill('0') << std::hash<string>()(fingerprint);
+    FilePath file = directory / (nameStream.str() + "." + CACHE_FILE_EXTENSION);
+    const string data = readFile(file);
+    if (data.empty())
+    {
+        return nullptr;
+    }
+
+    try
+    {
+        FieldReader reader(data);
+        if (reader.read() != CACHE_FILE_HEADER || reader.read() != fingerprint)
+        {
+            return nullptr;
+        }
+
+        // Validate source files against their current contents.
+        size_t fileCount = reader.readNumber();
+        for (size_t i = 0; i < fileCount; i++)
+        {
+            FilePath sourceFile = reader.read();
+            if (getSourceHash(sourceFile) != reader.read())
+            {
+                return nullptr;
+            }
+        }
+
+        auto shaderTemplate = std::make_shared<Template>();
+        shaderTemplate->generationTime = std::stod(reader.read());
+
+        size_t attributeCount = reader.readNumber();
+        for (size_t i = 0; i < attributeCount; i++)
+        {
+            const string attribute = reader.read();
+            shaderTemplate->attributes.emplace_back(attribute, readValue(reader));
+        }
+
+        size_t portCount = reader.readNumber();
+        for (size_t i = 0; i < portCount; i++)
+        {
+            Template::Port port;
+            port.type = TypeDesc::get(reader.read());
+            port.name = reader.read();
+            port.variable = reader.read();
+            port.semantic = reader.read();
+            port.colorspace = reader.read();
+            port.unit = reader.read();
+            port.geomprop = reader.read();
+            port.path = reader.read();
+            port.flags = (uint32_t) reader.readNumber();
+            port.socket = reader.readNumber() != 0;
+            port.value = readValue(reader);
+            size_t metadataCount = reader.readNumber();
+            if (metadataCount)
+            {
+                port.metadata = std::make_shared<ShaderMetadataVec>();
+                for (size_t j = 0; j < metadataCount; j++)
+                {
+                    const string metadataName = reader.read();
+                    const TypeDesc metadataType = TypeDesc::get(reader.read());
+                    port.metadata->emplace_back(metadataName, metadataType, readValue(reader));
+                }
+            }
+            shaderTemplate->ports.push_back(port);
+        }
+
+        size_t stageCount = reader.readNumber();
+        for (size_t i = 0; i < stageCount; i++)
+        {
+            Template::Stage stage;
+            stage.name = reader.read();
+            stage.functionName = reader.read();
+            stage.code = reader.read();
+            size_t includeCount = reader.readNumber();
+            for (size_t j = 0; j < includeCount; j++)
+            {
+                stage.includes.insert(reader.read());
+            }
+            size_t dependencyCount = reader.readNumber();
+            for (size_t j = 0; j < dependencyCount; j++)
+            {
+                stage.dependencies.insert(reader.read());
+            }
+            size_t blockCount = reader.readNumber();
+            for (size_t j = 0; j < blockCount; j++)
+            {
+                Template::Block block;
+                block.type = (BlockType) reader.readNumber();
+                block.name = reader.read();
+                block.instance = reader.read();
+                size_t blockPortCount = reader.readNumber();
+                for (size_t k = 0; k < blockPortCount; k++)
+                {
+                    size_t index = reader.readNumber();
+                    if (index >= shaderTemplate->ports.size())
+                    {
+                        return nullptr;
+                    }
+                    block.ports.push_back(index);
+                }
+                stage.blocks.push_back(block);
+            }
+            shaderTemplate->stages.push_back(stage);
+        }
+        return shaderTemplate;
+    }
+    catch (std::exception&)
+    {
+        return nullptr;
+    }
+}
+
+void ShaderCache::writeTemplate(const string& fingerprint, const Template& shaderTemplate) const
+{
+    FilePath directory = getCacheDirectory();
+    if (directory.isEmpty())
+    {
+        return;
+    }
+
+    // Struct types are local to their shader generator, so cannot be
+    // restored from the on-disk tier.
+    for (const Template::Port& port : shaderTemplate.ports)
+    {
+        if (port.type.isStruct())
+        {
+            return;
+        }
+    }
+
+    ScopedFloatFormatting fmt(Value::FloatFormatDefault, CACHE_FILE_FLOAT_PRECISION);
+
+    FieldWriter writer;
+    writer.write(CACHE_FILE_HEADER);
+    writer.write(fingerprint);
+
+    StringSet sourceFiles;
+    for (const Template::Stage& stage : shaderTemplate.stages)
+    {
+        sourceFiles.insert(stage.includes.begin(), stage.includes.end());
+        sourceFiles.insert(stage.dependencies.begin(), stage.dependencies.end());
+    }
+    writer.write(sourceFiles.size());
+    for (const string& sourceFile : sourceFiles)
+    {
+        writer.write(sourceFile);
+        writer.write(getSourceHash(sourceFile));
+    }
+
+    std::ostringstream timeStream;
+    timeStream << std::setprecision(17) << shaderTemplate.generationTime;
+    writer.write(timeStream.str());
+
+    writer.write(shaderTemplate.attributes.size());
+    for (const auto& attribute : shaderTemplate.attributes)
+    {
+        writer.write(attribute.first);
+        writeValue(writer, attribute.second);
+    }
+
+    writer.write(shaderTemplate.ports.size());
+    for (const Template::Port& port : shaderTemplate.ports)
+    {
+        writer.write(port.type.getName());
+        writer.write(port.name);
+        writer.write(port.variable);
+        writer.write(port.semantic);
+        writer.write(port.colorspace);
+        writer.write(port.unit);
+        writer.write(port.geomprop);
+        writer.write(port.path);
+        writer.write(port.flags);
+        writer.write(port.socket ? 1 : 0);
+        writeValue(writer, port.value);
+        writer.write(port.metadata ? port.metadata->size() : 0);
+        if (port.metadata)
+        {
+            for (const ShaderMetadata& metadata : *port.metadata)
+            {
+                writer.write(metadata.name);
+                writer.write(metadata.type.getName());
+                writeValue(writer, metadata.value);
+            }
+        }
+    }
+
+    writer.write(shaderTemplate.stages.size());
+    for (const Template::Stage& stage : shaderTemplate.stages)
+    {
+        writer.write(stage.name);
+        writer.write(stage.functionName);
+        writer.write(stage.code);
+        writer.write(stage.includes.size());
+        for (const string& include : stage.includes)
+        {
+            writer.write(include);
+        }
+        writer.write(stage.dependencies.size());
+        for (const string& dependency : stage.dependencies)
+        {
+            writer.write(dependency);
+        }
+        writer.write(stage.blocks.size());
+        for (const Template::Block& block : stage.blocks)
+        {
+            writer.write((size_t) block.type);
+            writer.write(block.name);
+            writer.write(block.instance);
+            writer.write(block.ports.size());
+            for (size_t index : block.ports)
+            {
+                writer.write(index);
+            }
+        }
+    }
+
+    // Write to a temporary file first, so that concurrent readers never
+    // observe a partially written entry.
+    std::stringstream nameStream;
+    nameStream << std::hex << std::setw(16) << std::setfill('0') << std::hash<string>()(fingerprint);
+    FilePath file = directory / (nameStream.str() + "." + CACHE_FILE_EXTENSION);
+    std::stringstream tempStream;
+    tempStream << file.asString() << "." << std::this_thread::get_id() << ".tmp";
+    const string tempFile = tempStream.str();
+    {
+        std::ofstream stream(tempFile, std::ios::out | std::ios::binary);
+        if (!stream)
+        {
+            return;
+        }
+        stream << writer.str();
+    }
+    std::remove(file.asString().c_str());
+    std::rename(tempFile.c_str(), file.asString().c_str());
+}
+
+MATERIALX_NAMESPACE_END
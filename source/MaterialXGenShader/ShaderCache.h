@@ -0,0 +1,153 @@
+//
+// Copyright Contributors to the MaterialX Project
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#ifndef MATERIALX_SHADERCACHE_H
+#define MATERIALX_SHADERCACHE_H
+
+/// @file
+/// Caching of generated shaders by shader graph fingerprint
+
+#include <MaterialXGenShader/Export.h>
+
+#include <MaterialXGenShader/Shader.h>
+
+#include <MaterialXFormat/File.h>
+
+#include <list>
+#include <mutex>
+
+MATERIALX_NAMESPACE_BEGIN
+
+/// A shared pointer to a ShaderCache
+using ShaderCachePtr = shared_ptr<class ShaderCache>;
+
+/// @class ShaderCache
+/// A cache of generated shaders, keyed by a fingerprint of the resolved
+/// shader graph.
+///
+/// The fingerprint covers the graph topology, node implementations, all
+/// values that are emitted as constants, the generation options, the target
+/// and the library version, but excludes the values of published uniforms.
+/// Elements whose shader graphs differ only in uniform values therefore
+/// share a cache entry, and a cache hit returns a copy of the cached shader
+/// with the defaults of its uniforms updated, both in its variable blocks
+/// and in its source code.
+///
+/// Cached shaders are held in an in-memory tier with least-recently-used
+/// eviction, and may optionally be written to an on-disk tier, in which
+/// entries are validated against the contents of their source files when
+/// loaded. Source file contents are read once per cache, so the cache should
+/// be cleared when source files are edited during its lifetime.
+///
+/// Node implementations other than node graphs are identified by name, and
+/// user data other than bound light shaders is not part of the fingerprint,
+/// so these should remain constant for all contexts used with a given cache.
+class MX_GENSHADER_API ShaderCache
+{
+  public:
+    /// Statistics on the use of a shader cache.
+    struct Statistics
+    {
+        /// The number of shaders returned from the in-memory tier.
+        size_t memoryHits = 0;
+
+        /// The number of shaders returned from the on-disk tier.
+        size_t diskHits = 0;
+
+        /// The number of shaders that were generated.
+        size_t misses = 0;
+
+        /// The estimated generation time saved by cache hits, in seconds.
+        double savedTime = 0.0;
+
+        /// Return the fraction of requests served from the cache.
+        double getHitRate() const
+        {
+            size_t hits = memoryHits + diskHits;
+            return hits + misses ? (double) hits / (double) (hits + misses) : 0.0;
+        }
+    };
+
+    /// The default number of shaders held in the in-memory tier.
+    static const size_t DEFAULT_CAPACITY;
+
+  public:
+    ~ShaderCache();
+
+    /// Create a new shader cache, holding up to the given number of shaders
+    /// in memory.
+    static ShaderCachePtr create(size_t capacity = DEFAULT_CAPACITY)
+    {
+        return ShaderCachePtr(new ShaderCache(capacity));
+    }
+
+    /// Set the number of shaders held in the in-memory tier.
+    void setCapacity(size_t capacity);
+
+    /// Return the number of shaders held in the in-memory tier.
+    size_t getCapacity() const;
+
+    /// Set the directory of the on-disk tier, which is created if needed.
+    /// An empty path disables the on-disk tier, which is the default.
+    void setCacheDirectory(const FilePath& directory);
+
+    /// Return the directory of the on-disk tier.
+    FilePath getCacheDirectory() const;
+
+    /// Return a shader for the given element, from the cache if possible,
+    /// and otherwise by generating it with the shader generator of the given
+    /// context.
+    ShaderPtr generate(const string& name, ElementPtr element, GenContext& context);
+
+    /// Return the statistics on the use of this cache.
+    Statistics getStatistics() const;
+
+    /// Reset the statistics on the use of this cache.
+    void resetStatistics();
+
+    /// Remove all shaders from the in-memory tier, and forget the contents
+    /// of source files against which on-disk entries are validated.
+    void clear();
+
+    /// Return the number of shaders in the in-memory tier.
+    size_t size() const;
+
+    /// Return the fingerprint of the given shader graph, under which shaders
+    /// generated from it are cached.
+    static string getFingerprint(const string& name, const ShaderGraph& graph, GenContext& context);
+
+  protected:
+    ShaderCache(size_t capacity);
+
+    struct Template;
+    using TemplatePtr = shared_ptr<const Template>;
+
+    TemplatePtr findTemplate(const string& fingerprint);
+    void addTemplate(const string& fingerprint, TemplatePtr shaderTemplate);
+
+    TemplatePtr readTemplate(const string& fingerprint) const;
+    void writeTemplate(const string& fingerprint, const Template& shaderTemplate) const;
+
+    string getSourceHash(const FilePath& file) const;
+
+    static TemplatePtr createTemplate(const Shader& shader, double generationTime);
+    static ShaderPtr createShader(const Template& shaderTemplate, const string& name,
+                                  ShaderGraphPtr graph, GenContext& context);
+
+  protected:
+    using TemplateList = std::list<std::pair<string, TemplatePtr>>;
+
+    mutable std::mutex _mutex;
+    size_t _capacity;
+    FilePath _directory;
+    TemplateList _templates;
+    std::unordered_map<string, TemplateList::iterator> _templateMap;
+    mutable StringMap _sourceHashes;
+    Statistics _statistics;
+};
+
+MATERIALX_NAMESPACE_END
+
+#endif
@@ -347,6 +347,9 @@ ShaderNodeImplPtr ShaderGenerator::getImplementation(const NodeDef& nodedef, Gen
 /// Load any struct type definitions from the document in to the type cache.
 void ShaderGenerator::loadStructTypeDefs(const DocumentPtr& doc)
 {
+    // Resolve member types against the struct types of this generator.
+    StructTypeRegistry::Scope scope(&_structTypes);
+
     for (const auto& mxTypeDef : doc->getTypeDefs())
     {
         const auto& typeDefName = mxTypeDef->getName();
@@ -367,13 +370,8 @@ void ShaderGenerator::loadStructTypeDefs(const DocumentPtr& doc)
             newStructTypeDesc.addMember(memberName, memberType, memberDefaultValue);
         }
 
-        auto structIndex = StructTypeDesc::emplace_back(newStructTypeDesc);
-
-        TypeDesc structTypeDesc(typeDefName, TypeDesc::BASETYPE_STRUCT, TypeDesc::SEMANTIC_NONE, 1, structIndex);
-
-        TypeDescRegistry(structTypeDesc, typeDefName);
-
-        StructTypeDesc::get(structIndex).setTypeDesc(TypeDesc::get(typeDefName));
+        TypeDesc structTypeDesc = StructTypeDesc::store(typeDefName, newStructTypeDesc);
+        _structTypes.registerType(structTypeDesc, typeDefName);
     }
 
     _syntax->registerStructTypeDescSyntax();
@@ -382,6 +380,7 @@ void ShaderGenerator::loadStructTypeDefs(const DocumentPtr& doc)
 /// Clear any struct type definitions loaded
 void ShaderGenerator::clearStructTypeDefs()
 {
+    _structTypes.clear();
     StructTypeDesc::clear();
 }
 
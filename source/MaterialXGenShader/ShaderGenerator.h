@@ -192,11 +192,19 @@ class MX_GENSHADER_API ShaderGenerator
     }
 
     /// Load any struct type definitions from the document in to the type cache.
+    ///
+    /// The loaded types are held by this generator's StructTypeRegistry rather
+    /// than globally, so outside of shader generation, TypeDesc::get will find
+    /// them by name only within a StructTypeRegistry::Scope on getStructTypes().
+    /// Elsewhere it returns Type::NONE for these types.
     void loadStructTypeDefs(const DocumentPtr& doc);
 
     /// Clear any struct type definitions loaded
     void clearStructTypeDefs();
 
+    /// Return the struct types loaded by this generator.
+    const StructTypeRegistry& getStructTypes() const { return _structTypes; }
+
     /// Register metadata that should be exported to the generated shaders.
     /// Supported metadata includes standard UI attributes like "uiname", "uifolder",
     /// "uimin", "uimax", etc.
@@ -235,9 +243,11 @@ class MX_GENSHADER_API ShaderGenerator
     Factory<ShaderNodeImpl> _implFactory;
     ColorManagementSystemPtr _colorManagementSystem;
     UnitSystemPtr _unitSystem;
+    StructTypeRegistry _structTypes;
     mutable StringMap _tokenSubstitutions;
 
     friend ShaderGraph;
+    friend class ShaderCache;
 };
 
 /// @class ExceptionShaderGenError
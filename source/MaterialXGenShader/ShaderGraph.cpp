@@ -9,11 +9,388 @@
 #include <MaterialXGenShader/ShaderGenerator.h>
 #include <MaterialXGenShader/Util.h>
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <queue>
+#include <sstream>
 
 MATERIALX_NAMESPACE_BEGIN
 
+namespace
+{
+
+// Helpers for the evaluation of standard library nodes with constant inputs.
+// Values are represented by their float components.
+
+using Components = vector<float>;
+
+template <class T> Components getVectorComponents(const Value& value)
+{
+    const T& vec = value.asA<T>();
+    return Components(vec.data(), vec.data() + T::numElements());
+}
+
+bool isFoldableType(TypeDesc type, bool allowInteger)
+{
+    if (type.getSemantic() == TypeDesc::SEMANTIC_MATRIX || type.getSize() < 1 || type.getSize() > 4)
+    {
+        return false;
+    }
+    return type.getBaseType() == TypeDesc::BASETYPE_FLOAT ||
+           (allowInteger && type == Type::INTEGER);
+}
+
+bool getComponents(const Value& value, Components& components)
+{
+    if (value.isA<float>())
+    {
+        components = { value.asA<float>() };
+    }
+    else if (value.isA<int>())
+    {
+        components = { (float) value.asA<int>() };
+    }
+    else if (value.isA<Color3>())
+    {
+        components = getVectorComponents<Color3>(value);
+    }
+    else if (value.isA<Color4>())
+    {
+        components = getVectorComponents<Color4>(value);
+    }
+    else if (value.isA<Vector2>())
+    {
+        components = getVectorComponents<Vector2>(value);
+    }
+    else if (value.isA<Vector3>())
+    {
+        components = getVectorComponents<Vector3>(value);
+    }
+    else if (value.isA<Vector4>())
+    {
+        components = getVectorComponents<Vector4>(value);
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+ValuePtr createValue(TypeDesc type, const Components& c)
+{
+    if (type == Type::FLOAT)
+        return Value::createValue(c[0]);
+    if (type == Type::COLOR3)
+        return Value::createValue(Color3(c[0], c[1], c[2]));
+    if (type == Type::COLOR4)
+        return Value::createValue(Color4(c[0], c[1], c[2], c[3]));
+    if (type == Type::VECTOR2)
+        return Value::createValue(Vector2(c[0], c[1]));
+    if (type == Type::VECTOR3)
+        return Value::createValue(Vector3(c[0], c[1], c[2]));
+    if (type == Type::VECTOR4)
+        return Value::createValue(Vector4(c[0], c[1], c[2], c[3]));
+    return nullptr;
+}
+
+// Return the given component, broadcasting scalars.
+float at(const Components& c, size_t i)
+{
+    return c.size() == 1 ? c[0] : c[i];
+}
+
+class ConstantNodeEvaluator
+{
+  public:
+    ConstantNodeEvaluator(const ShaderNode& node, const std::unordered_map<string, Components>& inputs) :
+        _node(node),
+        _inputs(inputs),
+        _size(node.getOutput()->getType().getSize())
+    {
+    }
+
+    // Evaluate the node for the given category, returning the components of
+    // each of its outputs, or false if the node cannot be evaluated.
+    bool evaluate(const string& category, vector<Components>& outputs)
+    {
+        if (category == "add")
+            return binary(outputs, [](float a, float b) { return a + b; });
+        if (category == "subtract")
+            return binary(outputs, [](float a, float b) { return a - b; });
+        if (category == "multiply")
+            return binary(outputs, [](float a, float b) { return a * b; });
+        if (category == "divide")
+            return !hasComponent("in2", 0.0f) && binary(outputs, [](float a, float b) { return a / b; });
+        if (category == "modulo")
+            return !hasComponent("in2", 0.0f) && binary(outputs, [](float a, float b) { return a - b * std::floor(a / b); });
+        if (category == "min")
+            return binary(outputs, [](float a, float b) { return std::min(a, b); });
+        if (category == "max")
+            return binary(outputs, [](float a, float b) { return std::max(a, b); });
+        if (category == "power")
+            return !hasNonPositive("in1") && binary(outputs, [](float a, float b) { return std::pow(a, b); });
+        if (category == "absval")
+            return unary(outputs, [](float a) { return std::abs(a); });
+        if (category == "floor")
+            return unary(outputs, [](float a) { return std::floor(a); });
+        if (category == "ceil")
+            return unary(outputs, [](float a) { return std::ceil(a); });
+        if (category == "sin")
+            return unary(outputs, [](float a) { return std::sin(a); });
+        if (category == "cos")
+            return unary(outputs, [](float a) { return std::cos(a); });
+        if (category == "sqrt")
+            return !hasNegative("in") && unary(outputs, [](float a) { return std::sqrt(a); });
+        if (category == "exp")
+            return unary(outputs, [](float a) { return std::exp(a); });
+        if (category == "ln")
+            return !hasNonPositive("in") && unary(outputs, [](float a) { return std::log(a); });
+        if (category == "invert")
+            return componentwise(outputs, { "in", "amount" },
+                                 [](const vector<const Components*>& in, size_t i) { return at(*in[1], i) - at(*in[0], i); });
+        if (category == "clamp")
+            return componentwise(outputs, { "in", "low", "high" },
+                                 [](const vector<const Components*>& in, size_t i) { return std::min(std::max(at(*in[0], i), at(*in[1], i)), at(*in[2], i)); });
+        if (category == "mix")
+            return componentwise(outputs, { "fg", "bg", "mix" },
+                                 [](const vector<const Components*>& in, size_t i) { return at(*in[1], i) * (1.0f - at(*in[2], i)) + at(*in[0], i) * at(*in[2], i); });
+        if (category == "ifgreater")
+            return select(outputs, [](float a, float b) { return a > b; });
+        if (category == "ifgreatereq")
+            return select(outputs, [](float a, float b) { return a >= b; });
+        if (category == "ifequal")
+            return select(outputs, [](float a, float b) { return a == b; });
+        if (category == "dotproduct")
+            return dot(outputs, "in1", "in2");
+        if (category == "magnitude")
+            return magnitude(outputs);
+        if (category == "normalize")
+            return normalize(outputs);
+        if (category == "extract")
+            return extract(outputs);
+        if (category == "convert")
+            return convert(outputs);
+        if (category == "combine2" || category == "combine3" || category == "combine4")
+            return combine(outputs);
+        if (category == "separate2" || category == "separate3" || category == "separate4")
+            return separate(outputs);
+        return false;
+    }
+
+  protected:
+    const Components* get(const string& name) const
+    {
+        auto it = _inputs.find(name);
+        return it != _inputs.end() ? &it->second : nullptr;
+    }
+
+    bool hasComponent(const string& name, float value) const
+    {
+        const Components* c = get(name);
+        return !c || std::find(c->begin(), c->end(), value) != c->end();
+    }
+
+    bool hasNegative(const string& name) const
+    {
+        const Components* c = get(name);
+        return !c || std::any_of(c->begin(), c->end(), [](float a) { return a < 0.0f; });
+    }
+
+    bool hasNonPositive(const string& name) const
+    {
+        const Components* c = get(name);
+        return !c || std::any_of(c->begin(), c->end(), [](float a) { return a <= 0.0f; });
+    }
+
+    template <class F> bool componentwise(vector<Components>& outputs, const vector<string>& names, F func)
+    {
+        vector<const Components*> in;
+        for (const string& name : names)
+        {
+            const Components* c = get(name);
+            if (!c || (c->size() != 1 && c->size() != _size))
+            {
+                return false;
+            }
+            in.push_back(c);
+        }
+        Components result(_size);
+        for (size_t i = 0; i < _size; i++)
+        {
+            result[i] = func(in, i);
+        }
+        outputs = { result };
+        return true;
+    }
+
+    template <class F> bool unary(vector<Components>& outputs, F func)
+    {
+        return componentwise(outputs, { "in" },
+                             [func](const vector<const Components*>& in, size_t i) { return func(at(*in[0], i)); });
+    }
+
+    template <class F> bool binary(vector<Components>& outputs, F func)
+    {
+        return componentwise(outputs, { "in1", "in2" },
+                             [func](const vector<const Components*>& in, size_t i) { return func(at(*in[0], i), at(*in[1], i)); });
+    }
+
+    template <class F> bool select(vector<Components>& outputs, F compare)
+    {
+        const Components* value1 = get("value1");
+        const Components* value2 = get("value2");
+        if (!value1 || !value2 || value1->size() != 1 || value2->size() != 1)
+        {
+            return false;
+        }
+        const Components* in = get(compare((*value1)[0], (*value2)[0]) ? "in1" : "in2");
+        if (!in || in->size() != _size)
+        {
+            return false;
+        }
+        outputs = { *in };
+        return true;
+    }
+
+    bool dot(vector<Components>& outputs, const string& name1, const string& name2)
+    {
+        const Components* in1 = get(name1);
+        const Components* in2 = get(name2);
+        if (!in1 || !in2 || in1->size() != in2->size() || _size != 1)
+        {
+            return false;
+        }
+        float result = 0.0f;
+        for (size_t i = 0; i < in1->size(); i++)
+        {
+            result += (*in1)[i] * (*in2)[i];
+        }
+        outputs = { { result } };
+        return true;
+    }
+
+    bool magnitude(vector<Components>& outputs)
+    {
+        if (!dot(outputs, "in", "in"))
+        {
+            return false;
+        }
+        outputs[0][0] = std::sqrt(outputs[0][0]);
+        return true;
+    }
+
+    bool normalize(vector<Components>& outputs)
+    {
+        const Components* in = get("in");
+        if (!in || in->size() != _size)
+        {
+            return false;
+        }
+        float length = 0.0f;
+        for (float a : *in)
+        {
+            length += a * a;
+        }
+        if (length <= 0.0f)
+        {
+            return false;
+        }
+        length = std::sqrt(length);
+        Components result(_size);
+        for (size_t i = 0; i < _size; i++)
+        {
+            result[i] = (*in)[i] / length;
+        }
+        outputs = { result };
+        return true;
+    }
+
+    bool extract(vector<Components>& outputs)
+    {
+        const Components* in = get("in");
+        const Components* index = get("index");
+        if (!in || !index || index->size() != 1 || _size != 1)
+        {
+            return false;
+        }
+        int i = (int) (*index)[0];
+        if (i < 0 || i >= (int) in->size())
+        {
+            return false;
+        }
+        outputs = { { (*in)[i] } };
+        return true;
+    }
+
+    bool convert(vector<Components>& outputs)
+    {
+        const Components* in = get("in");
+        if (!in || _node.getInput("in")->getType().getBaseType() != TypeDesc::BASETYPE_FLOAT)
+        {
+            return false;
+        }
+
+        // Scalars are broadcast, and vectors are truncated or padded with
+        // zero for the third and one for the fourth component.
+        Components result(_size);
+        for (size_t i = 0; i < _size; i++)
+        {
+            if (in->size() == 1)
+                result[i] = (*in)[0];
+            else if (i < in->size())
+                result[i] = (*in)[i];
+            else
+                result[i] = i == 3 ? 1.0f : 0.0f;
+        }
+        outputs = { result };
+        return true;
+    }
+
+    bool combine(vector<Components>& outputs)
+    {
+        Components result;
+        for (const ShaderInput* input : _node.getInputs())
+        {
+            const Components* c = get(input->getName());
+            if (!c)
+            {
+                return false;
+            }
+            result.insert(result.end(), c->begin(), c->end());
+        }
+        if (result.size() != _size)
+        {
+            return false;
+        }
+        outputs = { result };
+        return true;
+    }
+
+    bool separate(vector<Components>& outputs)
+    {
+        const Components* in = get("in");
+        if (!in || in->size() != _node.numOutputs())
+        {
+            return false;
+        }
+        outputs.clear();
+        for (float a : *in)
+        {
+            outputs.push_back({ a });
+        }
+        return true;
+    }
+
+  protected:
+    const ShaderNode& _node;
+    const std::unordered_map<string, Components>& _inputs;
+    size_t _size;
+};
+
+} // anonymous namespace
+
 //
 // ShaderGraph methods
 //
@@ -435,6 +812,8 @@ void ShaderGraph::addUnitTransformNode(ShaderOutput* output, const UnitTransform
 
 ShaderGraphPtr ShaderGraph::create(const ShaderGraph* parent, const NodeGraph& nodeGraph, GenContext& context)
 {
+    StructTypeRegistry::Scope structTypeScope(&context.getShaderGenerator().getStructTypes());
+
     NodeDefPtr nodeDef = nodeGraph.getNodeDef();
     if (!nodeDef)
     {
@@ -468,6 +847,8 @@ ShaderGraphPtr ShaderGraph::create(const ShaderGraph* parent, const NodeGraph& n
 
 ShaderGraphPtr ShaderGraph::create(const ShaderGraph* parent, const string& name, ElementPtr element, GenContext& context)
 {
+    StructTypeRegistry::Scope structTypeScope(&context.getShaderGenerator().getStructTypes());
+
     ShaderGraphPtr graph;
     ElementPtr root;
 
@@ -827,7 +1208,7 @@ void ShaderGraph::finalize(GenContext& context)
     _outputUnitTransformMap.clear();
 
     // Optimize the graph, removing redundant paths.
-    optimize();
+    optimize(context);
 
     // Sort the nodes in topological order.
     topologicalSort();
@@ -887,7 +1268,7 @@ void ShaderGraph::disconnect(ShaderNode* node) const
     }
 }
 
-void ShaderGraph::optimize()
+void ShaderGraph::optimize(GenContext& context)
 {
     size_t numEdits = 0;
     for (ShaderNode* node : getNodes())
@@ -912,6 +1293,15 @@ void ShaderGraph::optimize()
         // "uniform" in the NodeDef or to handle very specific cases, like FILENAME.
     }
 
+    // With a complete interface, all unconnected inputs are published as
+    // uniforms, so nodes may only be evaluated when the interface is reduced.
+    const bool reducedInterface = context.getOptions().shaderInterfaceType == SHADER_INTERFACE_REDUCED;
+    if (reducedInterface)
+    {
+        numEdits += foldConstantNodes();
+    }
+    numEdits += mergeDuplicateNodes(reducedInterface);
+
     if (numEdits > 0)
     {
         std::set<ShaderNode*> usedNodesSet;
@@ -953,6 +1343,141 @@ void ShaderGraph::optimize()
     }
 }
 
+size_t ShaderGraph::foldConstantNodes()
+{
+    size_t numFolded = 0;
+    bool folded = true;
+    while (folded)
+    {
+        folded = false;
+        for (ShaderNode* node : _nodeOrder)
+        {
+            if (node->_category.empty() || (node->getClassification() & ShaderNode::Classification::CLOSURE))
+            {
+                continue;
+            }
+
+            // Only nodes that are still in use, and whose inputs and outputs
+            // all have float-based types, are considered.
+            bool used = false;
+            bool foldable = true;
+            for (const ShaderOutput* output : node->getOutputs())
+            {
+                used |= !output->getConnections().empty();
+                foldable &= isFoldableType(output->getType(), false);
+            }
+            std::unordered_map<string, Components> inputs;
+            for (const ShaderInput* input : node->getInputs())
+            {
+                if (!foldable)
+                {
+                    break;
+                }
+                foldable = !input->getConnection() && input->getValue() &&
+                           isFoldableType(input->getType(), true) &&
+                           getComponents(*input->getValue(), inputs[input->getName()]);
+            }
+            if (!used || !foldable)
+            {
+                continue;
+            }
+
+            vector<Components> results;
+            ConstantNodeEvaluator evaluator(*node, inputs);
+            if (!evaluator.evaluate(node->_category, results) || results.size() != node->numOutputs())
+            {
+                continue;
+            }
+
+            // Push the resulting values downstream.
+            for (size_t i = 0; i < node->numOutputs(); i++)
+            {
+                ShaderOutput* output = node->getOutput(i);
+                ValuePtr value = createValue(output->getType(), results[i]);
+                ShaderInputVec downstreamConnections = output->getConnections();
+                for (ShaderInput* downstream : downstreamConnections)
+                {
+                    output->breakConnection(downstream);
+                    downstream->setValue(value);
+                }
+            }
+            folded = true;
+            ++numFolded;
+        }
+    }
+    return numFolded;
+}
+
+size_t ShaderGraph::mergeDuplicateNodes(bool mergeEditableInputs)
+{
+    // Visit nodes in topological order, so that duplicates upstream are
+    // merged before the nodes downstream of them are compared.
+    topologicalSort();
+
+    const uint32_t excludedClassification = ShaderNode::Classification::CLOSURE |
+                                            ShaderNode::Classification::SHADER |
+                                            ShaderNode::Classification::MATERIAL |
+                                            ShaderNode::Classification::LIGHT;
+
+    size_t numMerged = 0;
+    std::unordered_map<string, ShaderNode*> nodeMap;
+    for (ShaderNode* node : _nodeOrder)
+    {
+        if (!node->_impl || (node->getClassification() & excludedClassification))
+        {
+            continue;
+        }
+
+        // Build a key from the implementation and inputs of the node.
+        std::ostringstream key;
+        key << node->_impl.get() << '|' << node->getClassification();
+        bool mergeable = true;
+        for (const ShaderInput* input : node->getInputs())
+        {
+            key << '|' << input->getName() << '|' << input->getType().getName() << '|';
+            if (input->getConnection())
+            {
+                key << input->getConnection();
+            }
+            else if (!mergeEditableInputs && !input->getType().isClosure() && node->isEditable(*input))
+            {
+                mergeable = false;
+                break;
+            }
+            else
+            {
+                key << (input->getValue() ? input->getValueString() : EMPTY_STRING) << '|'
+                    << input->getUnit() << '|' << input->getColorSpace();
+            }
+        }
+        if (!mergeable)
+        {
+            continue;
+        }
+
+        auto it = nodeMap.emplace(key.str(), node);
+        if (it.second)
+        {
+            continue;
+        }
+
+        // Reconnect the downstream connections of the duplicate.
+        ShaderNode* original = it.first->second;
+        for (size_t i = 0; i < node->numOutputs(); i++)
+        {
+            ShaderOutput* output = node->getOutput(i);
+            ShaderInputVec downstreamConnections = output->getConnections();
+            for (ShaderInput* downstream : downstreamConnections)
+            {
+                output->breakConnection(downstream);
+                downstream->makeConnection(original->getOutput(i));
+            }
+        }
+        ++numMerged;
+    }
+    return numMerged;
+}
+
 void ShaderGraph::bypass(ShaderNode* node, size_t inputIndex, size_t outputIndex)
 {
     ShaderInput* input = node->getInput(inputIndex);
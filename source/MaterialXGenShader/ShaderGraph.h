@@ -159,7 +159,21 @@ class MX_GENSHADER_API ShaderGraph : public ShaderNode
     void finalize(GenContext& context);
 
     /// Optimize the graph, removing redundant paths.
-    void optimize();
+    /// Standard library nodes with constant inputs are evaluated and merged
+    /// into downstream values, and nodes with identical implementations and
+    /// inputs are merged, as far as the shader interface type allows.
+    void optimize(GenContext& context);
+
+    /// Evaluate standard library nodes whose inputs are all constant, moving
+    /// their output values downstream. Returns the number of nodes evaluated.
+    size_t foldConstantNodes();
+
+    /// Merge nodes with identical implementations and inputs, reconnecting
+    /// the downstream connections of duplicates to the first such node.
+    /// Nodes with unconnected editable inputs are only merged if requested,
+    /// as these inputs would otherwise be published as distinct uniforms.
+    /// Returns the number of nodes merged.
+    size_t mergeDuplicateNodes(bool mergeEditableInputs);
 
     /// Bypass a node for a particular input and output,
     /// effectively connecting the input's upstream connection
@@ -226,6 +226,10 @@ ShaderNodePtr ShaderNode::create(const ShaderGraph* parent, const string& name,
         newNode->addOutput("out", TypeDesc::get(nodeDef.getType()));
     }
 
+    // Record the category of the node, which identifies nodes that
+    // may be evaluated during graph optimization.
+    newNode->_category = nodeDef.getNodeString();
+
     const string& nodeDefName = nodeDef.getName();
     const string& groupName = nodeDef.getNodeGroup();
 
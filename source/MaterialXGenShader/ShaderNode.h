@@ -490,6 +490,7 @@ class MX_GENSHADER_API ShaderNode
 
     const ShaderGraph* _parent;
     string _name;
+    string _category;
     uint32_t _classification;
 
     std::unordered_map<string, ShaderInputPtr> _inputMap;
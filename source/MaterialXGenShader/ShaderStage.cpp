@@ -14,6 +14,11 @@
 
 #include <MaterialXFormat/Util.h>
 
+#include <algorithm>
+#include <cctype>
+#include <string_view>
+#include <unordered_set>
+
 MATERIALX_NAMESPACE_BEGIN
 
 namespace Stage
@@ -23,6 +28,527 @@ const string PIXEL = "pixel";
 
 } // namespace Stage
 
+namespace
+{
+
+// A declaration in emitted source code, such as a function, struct,
+// constant, variable or preprocessor directive.
+struct SourceDeclaration
+{
+    size_t begin = 0;
+    size_t end = 0;
+    int parent = -1;
+    string name;
+    bool removable = false;
+    vector<std::string_view> references;
+};
+
+bool isIdentifierStart(char c)
+{
+    return std::isalpha((unsigned char) c) || c == '_';
+}
+
+bool isIdentifierChar(char c)
+{
+    return std::isalnum((unsigned char) c) || c == '_';
+}
+
+const string OPERATOR_CHARS = "+-*/%<>=!&|^~[]";
+const string COMPOUND_ASSIGNMENT_CHARS = "+-*/%<>=!&|^";
+
+bool isOperatorChar(char c)
+{
+    return OPERATOR_CHARS.find(c) != string::npos;
+}
+
+bool isIdentifier(const string& name)
+{
+    return !name.empty() && isIdentifierStart(name[0]) &&
+           std::all_of(name.begin(), name.end(), isIdentifierChar);
+}
+
+// Splits emitted source code into declarations, recording the names they
+// define and the identifiers they reference. The parser only understands
+// the C-like structure shared by the supported languages: comments, string
+// literals, preprocessor directives, braces and parentheses.
+class SourceParser
+{
+  public:
+    SourceParser(const string& code, const Syntax& syntax) :
+        _code(code),
+        _syntax(syntax),
+        _lineComment(syntax.getSingleLineComment()),
+        _beginComment(syntax.getBeginMultiLineComment()),
+        _endComment(syntax.getEndMultiLineComment())
+    {
+    }
+
+    // Parse the declarations within the given range. The bodies of structs
+    // are parsed recursively, so that unused member functions, such as those
+    // of the global context struct in MSL, can be removed. Data members are
+    // never marked removable, as struct constructors and buffer layouts
+    // depend on them.
+    void parse(size_t begin, size_t end, int parent, vector<SourceDeclaration>& decls) const
+    {
+        size_t pos = begin;
+        while (true)
+        {
+            const size_t start = skipSpace(pos, end);
+            if (start >= end)
+            {
+                break;
+            }
+
+            SourceDeclaration decl;
+            decl.begin = pos;
+            decl.parent = parent;
+            size_t bodyBegin = string::npos;
+            size_t bodyEnd = string::npos;
+            if (_code[start] == '#')
+            {
+                decl.end = parseDirective(start, end, decl);
+            }
+            else
+            {
+                decl.end = parseDeclaration(start, end, decl, bodyBegin, bodyEnd);
+            }
+
+            // Include trailing whitespace up to and including the newline.
+            while (decl.end < end && (_code[decl.end] == ' ' || _code[decl.end] == '\t' || _code[decl.end] == '\r'))
+            {
+                ++decl.end;
+            }
+            if (decl.end < end && _code[decl.end] == '\n')
+            {
+                ++decl.end;
+            }
+
+            pos = decl.end;
+            decls.push_back(std::move(decl));
+            if (bodyBegin != string::npos)
+            {
+                parse(bodyBegin + 1, bodyEnd, (int) decls.size() - 1, decls);
+            }
+        }
+    }
+
+  private:
+    // Return the position following a comment or string literal starting
+    // at the given position, or the position itself if there is none.
+    size_t skipCommentOrLiteral(size_t pos, size_t end) const
+    {
+        const char c = _code[pos];
+        if (c != '"' && (_lineComment.empty() || c != _lineComment[0]) &&
+            (_beginComment.empty() || c != _beginComment[0]))
+        {
+            return pos;
+        }
+        if (!_lineComment.empty() && _code.compare(pos, _lineComment.size(), _lineComment) == 0)
+        {
+            size_t next = _code.find('\n', pos);
+            return std::min(next, end);
+        }
+        if (!_beginComment.empty() && _code.compare(pos, _beginComment.size(), _beginComment) == 0)
+        {
+            size_t next = _code.find(_endComment, pos + _beginComment.size());
+            return next == string::npos ? end : std::min(next + _endComment.size(), end);
+        }
+        if (c == '"')
+        {
+            for (size_t i = pos + 1; i < end; ++i)
+            {
+                if (_code[i] == '\\')
+                {
+                    ++i;
+                }
+                else if (_code[i] == '"' || _code[i] == '\n')
+                {
+                    return i + 1;
+                }
+            }
+            return end;
+        }
+        return pos;
+    }
+
+    size_t skipSpace(size_t pos, size_t end) const
+    {
+        while (pos < end)
+        {
+            if (std::isspace((unsigned char) _code[pos]))
+            {
+                ++pos;
+                continue;
+            }
+            size_t next = skipCommentOrLiteral(pos, end);
+            if (next == pos || _code[pos] == '"')
+            {
+                break;
+            }
+            pos = next;
+        }
+        return pos;
+    }
+
+    bool isLineStart(size_t pos) const
+    {
+        while (pos > 0 && (_code[pos - 1] == ' ' || _code[pos - 1] == '\t'))
+        {
+            --pos;
+        }
+        return pos == 0 || _code[pos - 1] == '\n';
+    }
+
+    // Return the end of the directive at the given position, following
+    // line continuations.
+    size_t directiveEnd(size_t pos, size_t end) const
+    {
+        while (pos < end)
+        {
+            size_t next = _code.find('\n', pos);
+            if (next == string::npos || next >= end)
+            {
+                return end;
+            }
+            size_t last = next;
+            while (last > pos && (_code[last - 1] == '\r' || _code[last - 1] == ' ' || _code[last - 1] == '\t'))
+            {
+                --last;
+            }
+            if (last == pos || _code[last - 1] != '\\')
+            {
+                return next;
+            }
+            pos = next + 1;
+        }
+        return end;
+    }
+
+    void collectIdentifiers(size_t begin, size_t end, vector<std::string_view>& identifiers) const
+    {
+        size_t pos = begin;
+        while (pos < end)
+        {
+            size_t next = skipCommentOrLiteral(pos, end);
+            if (next != pos)
+            {
+                pos = next;
+            }
+            else if (std::isdigit((unsigned char) _code[pos]))
+            {
+                // Skip numeric literals, including suffixes and exponents.
+                while (pos < end && (isIdentifierChar(_code[pos]) || _code[pos] == '.'))
+                {
+                    ++pos;
+                }
+            }
+            else if (isIdentifierStart(_code[pos]))
+            {
+                size_t identifierEnd = pos + 1;
+                while (identifierEnd < end && isIdentifierChar(_code[identifierEnd]))
+                {
+                    ++identifierEnd;
+                }
+                identifiers.push_back(std::string_view(_code).substr(pos, identifierEnd - pos));
+                pos = identifierEnd;
+            }
+            else
+            {
+                ++pos;
+            }
+        }
+    }
+
+    // Return the identifier ending right before the given position, skipping
+    // whitespace, or an empty string if there is none.
+    string identifierBefore(size_t pos, size_t begin) const
+    {
+        while (pos > begin && std::isspace((unsigned char) _code[pos - 1]))
+        {
+            --pos;
+        }
+        size_t identifierBegin = pos;
+        while (identifierBegin > begin && isIdentifierChar(_code[identifierBegin - 1]))
+        {
+            --identifierBegin;
+        }
+        if (identifierBegin == pos || !isIdentifierStart(_code[identifierBegin]))
+        {
+            return EMPTY_STRING;
+        }
+        return _code.substr(identifierBegin, pos - identifierBegin);
+    }
+
+    // Return the name of a function whose parameter list starts at the given
+    // position, including the symbols of operator overloads.
+    string functionName(size_t firstParen, size_t begin) const
+    {
+        string name = identifierBefore(firstParen, begin);
+        if (!name.empty())
+        {
+            return name;
+        }
+        size_t pos = firstParen;
+        while (pos > begin && std::isspace((unsigned char) _code[pos - 1]))
+        {
+            --pos;
+        }
+        size_t symbolBegin = pos;
+        while (symbolBegin > begin && isOperatorChar(_code[symbolBegin - 1]))
+        {
+            --symbolBegin;
+        }
+        if (symbolBegin == pos || identifierBefore(symbolBegin, begin) != "operator")
+        {
+            return EMPTY_STRING;
+        }
+        return "operator" + _code.substr(symbolBegin, pos - symbolBegin);
+    }
+
+    // Return true if the declaration with the given name and leading
+    // identifiers is an entry point of the stage.
+    bool isEntryPoint(const vector<std::string_view>& identifiers, const string& name) const
+    {
+        const StringSet& entryPoints = _syntax.getEntryPoints();
+        return entryPoints.count(name) || (!identifiers.empty() && entryPoints.count(string(identifiers[0])));
+    }
+
+    size_t parseDirective(size_t pos, size_t end, SourceDeclaration& decl) const
+    {
+        const size_t lineEnd = directiveEnd(pos, end);
+        vector<std::string_view> identifiers;
+        collectIdentifiers(pos + 1, lineEnd, identifiers);
+
+        // Macro definitions may be removed if the macro is never referenced.
+        if (identifiers.size() > 1 && identifiers[0] == "define")
+        {
+            decl.name = string(identifiers[1]);
+            decl.removable = true;
+            decl.references.assign(identifiers.begin() + 2, identifiers.end());
+        }
+        else
+        {
+            decl.references = std::move(identifiers);
+        }
+        return lineEnd;
+    }
+
+    size_t parseDeclaration(size_t pos, size_t end, SourceDeclaration& decl, size_t& bodyBegin, size_t& bodyEnd) const
+    {
+        // Scan to the end of the declaration, which is either a semicolon at
+        // the outer level, or the closing brace of a function body, collecting
+        // the referenced identifiers on the way.
+        vector<std::string_view>& references = decl.references;
+        size_t firstParen = string::npos;
+        size_t firstAssign = string::npos;
+        size_t lastToken = string::npos;
+        size_t lastTokenBeforeBody = string::npos;
+        size_t firstBracket = string::npos;
+        size_t headerCount = 0;
+        size_t bodyCount = 0;
+        bool hasDirective = false;
+        bool terminated = false;
+        int parenDepth = 0;
+        int braceDepth = 0;
+        size_t scan = pos;
+        while (scan < end)
+        {
+            const char c = _code[scan];
+            if (std::isspace((unsigned char) c))
+            {
+                ++scan;
+                continue;
+            }
+            if (isIdentifierStart(c))
+            {
+                size_t identifierEnd = scan + 1;
+                while (identifierEnd < end && isIdentifierChar(_code[identifierEnd]))
+                {
+                    ++identifierEnd;
+                }
+                references.push_back(std::string_view(_code).substr(scan, identifierEnd - scan));
+                lastToken = identifierEnd - 1;
+                scan = identifierEnd;
+                continue;
+            }
+            if (std::isdigit((unsigned char) c))
+            {
+                // Skip numeric literals, including suffixes and exponents.
+                while (scan < end && (isIdentifierChar(_code[scan]) || _code[scan] == '.'))
+                {
+                    ++scan;
+                }
+                lastToken = scan - 1;
+                continue;
+            }
+            size_t next = skipCommentOrLiteral(scan, end);
+            if (next != scan)
+            {
+                if (c == '"')
+                {
+                    lastToken = scan;
+                }
+                scan = next;
+                continue;
+            }
+            if (c == '#' && braceDepth == 0 && isLineStart(scan))
+            {
+                hasDirective = true;
+                next = directiveEnd(scan, end);
+                collectIdentifiers(scan + 1, next, references);
+                scan = next;
+                continue;
+            }
+
+            const size_t previousToken = lastToken;
+            lastToken = scan;
+            if (c == '(' && braceDepth == 0)
+            {
+                if (parenDepth == 0 && firstParen == string::npos && bodyBegin == string::npos)
+                {
+                    firstParen = scan;
+                }
+                ++parenDepth;
+            }
+            else if (c == ')' && braceDepth == 0)
+            {
+                --parenDepth;
+            }
+            else if (c == '=' && braceDepth == 0 && parenDepth == 0 && firstAssign == string::npos && bodyBegin == string::npos &&
+                     scan > pos && COMPOUND_ASSIGNMENT_CHARS.find(_code[scan - 1]) == string::npos &&
+                     (scan + 1 >= end || _code[scan + 1] != '='))
+            {
+                firstAssign = scan;
+            }
+            else if (c == '[' && braceDepth == 0 && parenDepth == 0 && firstBracket == string::npos && firstAssign == string::npos)
+            {
+                firstBracket = scan;
+            }
+            else if (c == '{')
+            {
+                if (braceDepth == 0 && bodyBegin == string::npos)
+                {
+                    bodyBegin = scan;
+                    lastTokenBeforeBody = previousToken;
+                    headerCount = references.size();
+                }
+                ++braceDepth;
+            }
+            else if (c == '}')
+            {
+                if (--braceDepth == 0 && bodyEnd == string::npos)
+                {
+                    bodyEnd = scan;
+                    bodyCount = references.size();
+                    if (isFunctionHeader(pos, firstParen, firstAssign, bodyBegin, lastTokenBeforeBody))
+                    {
+                        ++scan;
+                        size_t after = skipSpace(scan, end);
+                        if (after < end && _code[after] == ';')
+                        {
+                            scan = after + 1;
+                        }
+                        terminated = true;
+                        break;
+                    }
+                }
+                else if (braceDepth < 0)
+                {
+                    break;
+                }
+            }
+            else if (c == ';' && braceDepth == 0 && parenDepth == 0)
+            {
+                ++scan;
+                terminated = true;
+                break;
+            }
+            ++scan;
+        }
+
+        if (bodyBegin == string::npos)
+        {
+            headerCount = references.size();
+        }
+        if (!terminated || hasDirective || headerCount == 0)
+        {
+            bodyBegin = string::npos;
+            return scan;
+        }
+
+        if (bodyBegin != string::npos && bodyEnd != string::npos &&
+            isFunctionHeader(pos, firstParen, firstAssign, bodyBegin, lastTokenBeforeBody))
+        {
+            // Function definition. Operator overloads are always kept, as
+            // their use cannot be detected from identifiers.
+            decl.name = functionName(firstParen, pos);
+            decl.removable = isIdentifier(decl.name) && !isEntryPoint(references, decl.name);
+            bodyBegin = string::npos;
+        }
+        else if (bodyBegin != string::npos && bodyEnd != string::npos)
+        {
+            // Struct definition, which must not declare any variables. Its
+            // members are parsed separately, and are kept whenever the struct
+            // is used, except for member functions that are never referenced.
+            if (references[0] == "struct" && headerCount == 2 && references.size() == bodyCount)
+            {
+                decl.name = string(references[1]);
+                decl.removable = !isEntryPoint(references, decl.name);
+                references.resize(headerCount);
+                return scan;
+            }
+            bodyBegin = string::npos;
+        }
+        else if (references[0] == "const" && firstAssign != string::npos)
+        {
+            // Constant variable
+            decl.name = identifierBefore(std::min(firstAssign, firstBracket), pos);
+            decl.removable = !decl.name.empty();
+        }
+        else if (firstParen != string::npos && firstAssign == string::npos &&
+                 lastToken != string::npos && _code[lastToken] == ';' &&
+                 isFunctionHeader(pos, firstParen, firstAssign, scan - 1, lastTokenBefore(scan - 1, pos)))
+        {
+            // Function prototype
+            decl.name = functionName(firstParen, pos);
+            decl.removable = isIdentifier(decl.name) && !isEntryPoint(references, decl.name);
+        }
+        return scan;
+    }
+
+    size_t lastTokenBefore(size_t pos, size_t begin) const
+    {
+        while (pos > begin && std::isspace((unsigned char) _code[pos - 1]))
+        {
+            --pos;
+        }
+        return pos > begin ? pos - 1 : string::npos;
+    }
+
+    // Return true if the header of a declaration, ending at the given body
+    // or terminator, is the header of a function: a name followed by a
+    // parameter list, and optionally a constructor initializer list.
+    bool isFunctionHeader(size_t begin, size_t firstParen, size_t firstAssign, size_t headerEnd, size_t lastToken) const
+    {
+        if (firstParen == string::npos || firstParen > headerEnd || firstAssign < firstParen ||
+            lastToken == string::npos || lastToken < firstParen)
+        {
+            return false;
+        }
+        return !functionName(firstParen, begin).empty() &&
+               (_code[lastToken] == ')' || identifierBefore(lastToken + 1, begin) == "const");
+    }
+
+  private:
+    const string& _code;
+    const Syntax& _syntax;
+    const string& _lineComment;
+    const string& _beginComment;
+    const string& _endComment;
+};
+
+} // anonymous namespace
+
 //
 // VariableBlock methods
 //
@@ -349,7 +875,7 @@ void ShaderStage::addInclude(const FilePath& includeFilename, const FilePath& so
 
     if (!_includes.count(resolvedFile))
     {
-        string content = readFile(resolvedFile);
+        string content = context.readSourceFile(resolvedFile);
         if (content.empty())
         {
             throw ExceptionShaderGenError("Could not find include file: '" + includeFilename.asString() + "'");
@@ -411,4 +937,100 @@ bool ShaderStage::isEmitted(const ShaderNode& node, GenContext& context) const
     return false;
 }
 
+void ShaderStage::stripUnusedCode()
+{
+    if (_syntax->getEntryPoints().empty())
+    {
+        return;
+    }
+
+    vector<SourceDeclaration> decls;
+    SourceParser parser(_code, *_syntax);
+    parser.parse(0, _code.size(), -1, decls);
+
+    std::unordered_map<std::string_view, vector<size_t>> declsByName;
+    vector<vector<size_t>> children(decls.size());
+    for (size_t i = 0; i < decls.size(); ++i)
+    {
+        if (decls[i].removable)
+        {
+            declsByName[decls[i].name].push_back(i);
+        }
+        if (decls[i].parent >= 0)
+        {
+            children[decls[i].parent].push_back(i);
+        }
+    }
+
+    // Starting from all declarations that cannot be removed, such as entry
+    // points, uniforms and directives, find all declarations they reference.
+    // Members of structs are only considered once the struct itself is used,
+    // at which point all of its data members are used as well.
+    vector<bool> used(decls.size(), false);
+    std::unordered_set<std::string_view> usedNames;
+    vector<size_t> stack;
+    auto useName = [&](std::string_view name)
+    {
+        if (usedNames.insert(name).second)
+        {
+            auto it = declsByName.find(name);
+            if (it != declsByName.end())
+            {
+                for (size_t i : it->second)
+                {
+                    if (!used[i] && (decls[i].parent < 0 || used[decls[i].parent]))
+                    {
+                        used[i] = true;
+                        stack.push_back(i);
+                    }
+                }
+            }
+        }
+    };
+    for (size_t i = 0; i < decls.size(); ++i)
+    {
+        if (decls[i].parent < 0 && !decls[i].removable)
+        {
+            used[i] = true;
+            stack.push_back(i);
+        }
+    }
+    if (!_functionName.empty())
+    {
+        useName(_functionName);
+    }
+    while (!stack.empty())
+    {
+        const size_t i = stack.back();
+        stack.pop_back();
+        for (std::string_view name : decls[i].references)
+        {
+            useName(name);
+        }
+        for (size_t child : children[i])
+        {
+            if (!used[child] && (!decls[child].removable || usedNames.count(decls[child].name)))
+            {
+                used[child] = true;
+                stack.push_back(child);
+            }
+        }
+    }
+
+    // Remove unused declarations, whose enclosing declarations are in use.
+    string code;
+    code.reserve(_code.size());
+    size_t pos = 0;
+    for (size_t i = 0; i < decls.size(); ++i)
+    {
+        if (!used[i] && (decls[i].parent < 0 || used[decls[i].parent]))
+        {
+            code.append(_code, pos, decls[i].begin - pos);
+            pos = decls[i].end;
+        }
+    }
+    code.append(_code, pos, string::npos);
+    _code = std::move(code);
+}
+
 MATERIALX_NAMESPACE_END
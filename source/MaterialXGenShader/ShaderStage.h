@@ -283,6 +283,13 @@ class MX_GENSHADER_API ShaderStage
     /// Return true if the function for the given node has been emitted in the current scope.
     bool isEmitted(const ShaderNode& node, GenContext& context) const;
 
+    /// Remove functions, structs, constants and macros from the source code
+    /// that are not reachable from the entry points of the stage, as
+    /// identified by the syntax of the stage. This is a textual pass over
+    /// the emitted code, and only removes declarations that are known to be
+    /// unreferenced. It does nothing if the syntax declares no entry points.
+    void stripUnusedCode();
+
     /// Set stage function name.
     void setFunctionName(const string& functionName)
     {
@@ -330,6 +337,7 @@ class MX_GENSHADER_API ShaderStage
     string _code;
 
     friend class ShaderGenerator;
+    friend class ShaderCache;
 };
 
 /// Shared pointer to a ShaderStage
@@ -65,6 +65,11 @@ void Syntax::registerInvalidTokens(const StringMap& tokens)
     _invalidTokens.insert(tokens.begin(), tokens.end());
 }
 
+void Syntax::registerEntryPoints(const StringSet& tokens)
+{
+    _entryPoints.insert(tokens.begin(), tokens.end());
+}
+
 /// Returns the type syntax object for a named type.
 /// Throws an exception if a type syntax is not defined for the given type.
 const TypeSyntax& Syntax::getTypeSyntax(TypeDesc type) const
@@ -70,6 +70,11 @@ class MX_GENSHADER_API Syntax
     /// Multiple calls will add to the internal set of tokens.
     void registerInvalidTokens(const StringMap& tokens);
 
+    /// Register tokens identifying the entry points of shader stages in emitted
+    /// source code. A declaration is an entry point if its name or leading token
+    /// is one of these tokens. Multiple calls will add to the internal set of tokens.
+    void registerEntryPoints(const StringSet& tokens);
+
     virtual void registerStructTypeDescSyntax();
 
     /// Returns a set of names that are reserved words for this language syntax.
@@ -78,6 +83,10 @@ class MX_GENSHADER_API Syntax
     /// Returns a mapping from disallowed tokens to replacement strings for this language syntax.
     const StringMap& getInvalidTokens() const { return _invalidTokens; }
 
+    /// Returns the set of tokens identifying entry points for this language syntax.
+    /// An empty set means unused code cannot be stripped from shader stages.
+    const StringSet& getEntryPoints() const { return _entryPoints; }
+
     /// Returns the type syntax object for a named type.
     /// Throws an exception if a type syntax is not defined for the given type.
     const TypeSyntax& getTypeSyntax(TypeDesc type) const;
@@ -222,6 +231,7 @@ class MX_GENSHADER_API Syntax
 
     StringSet _reservedWords;
     StringMap _invalidTokens;
+    StringSet _entryPoints;
 
     static const string INDENTATION;
     static const string STRING_QUOTE;
@@ -7,6 +7,10 @@
 
 #include <MaterialXGenShader/ShaderGenerator.h>
 
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+
 MATERIALX_NAMESPACE_BEGIN
 
 namespace
@@ -15,59 +19,173 @@ namespace
 using TypeDescMap = std::unordered_map<string, TypeDesc>;
 using TypeDescNameMap = std::unordered_map<uint32_t, string>;
 
-// Internal storage of registered type descriptors
-TypeDescMap& typeMap()
+// Type descriptors for standard types, which are constructed on first use
+// and never modified, so may be read without locking.
+struct StandardTypes
 {
-    static TypeDescMap map;
-    return map;
+    StandardTypes()
+    {
+        const std::pair<TypeDesc, string> TYPES[] =
+        {
+            { Type::NONE, "none" },
+            { Type::BOOLEAN, "boolean" },
+            { Type::INTEGER, "integer" },
+            { Type::INTEGERARRAY, "integerarray" },
+            { Type::FLOAT, "float" },
+            { Type::FLOATARRAY, "floatarray" },
+            { Type::VECTOR2, "vector2" },
+            { Type::VECTOR3, "vector3" },
+            { Type::VECTOR4, "vector4" },
+            { Type::COLOR3, "color3" },
+            { Type::COLOR4, "color4" },
+            { Type::MATRIX33, "matrix33" },
+            { Type::MATRIX44, "matrix44" },
+            { Type::STRING, "string" },
+            { Type::FILENAME, "filename" },
+            { Type::BSDF, "BSDF" },
+            { Type::EDF, "EDF" },
+            { Type::VDF, "VDF" },
+            { Type::SURFACESHADER, "surfaceshader" },
+            { Type::VOLUMESHADER, "volumeshader" },
+            { Type::DISPLACEMENTSHADER, "displacementshader" },
+            { Type::LIGHTSHADER, "lightshader" },
+            { Type::MATERIAL, "material" }
+        };
+        for (const auto& type : TYPES)
+        {
+            types[type.second] = type.first;
+            names[type.first.typeId()] = type.second;
+        }
+    }
+
+    TypeDescMap types;
+    TypeDescNameMap names;
+};
+
+const StandardTypes& standardTypes()
+{
+    static const StandardTypes types;
+    return types;
 }
 
-TypeDescNameMap& typeNameMap()
+// Custom types registered at runtime, guarded by a reader-writer lock.
+struct CustomTypes
+{
+    std::shared_mutex mutex;
+    TypeDescMap types;
+    TypeDescNameMap names;
+};
+
+CustomTypes& customTypes()
 {
-    static TypeDescNameMap map;
-    return map;
+    static CustomTypes types;
+    return types;
 }
 
-using StructTypeDescStorage = vector<StructTypeDesc>;
-StructTypeDescStorage& structTypeStorage()
+// Process-wide storage of struct type descriptions.  Entries are never
+// removed, so references to them remain valid across threads, and their
+// indices may be embedded in type descriptors.
+struct StructTypeStorage
+{
+    std::shared_mutex mutex;
+    std::deque<StructTypeDesc> structs;
+    TypeDescNameMap names;
+};
+
+StructTypeStorage& structTypeStorage()
 {
-    // TODO: Our use of the singleton pattern for TypeDescMap and StructTypeDestStorage
-    //       is not thread-safe, and we should consider replacing this with thread-local
-    //       data in the GenContext object.
-    static StructTypeDescStorage storage;
+    static StructTypeStorage storage;
     return storage;
 }
 
+bool structMembersMatch(const StructTypeDesc& lhs, const StructTypeDesc& rhs)
+{
+    const auto& lhsMembers = lhs.getMembers();
+    const auto& rhsMembers = rhs.getMembers();
+    if (lhsMembers.size() != rhsMembers.size())
+    {
+        return false;
+    }
+    for (size_t i = 0; i < lhsMembers.size(); i++)
+    {
+        if (lhsMembers[i]._name != rhsMembers[i]._name ||
+            lhsMembers[i]._typeDesc != rhsMembers[i]._typeDesc ||
+            lhsMembers[i]._defaultValueStr != rhsMembers[i]._defaultValueStr)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+thread_local const StructTypeRegistry* activeStructTypeRegistry = nullptr;
+
 } // anonymous namespace
 
 const string TypeDesc::NONE_TYPE_NAME = "none";
 
 const string& TypeDesc::getName() const
 {
-    TypeDescNameMap& typenames = typeNameMap();
-    auto it = typenames.find(_id);
-    return it != typenames.end() ? it->second : NONE_TYPE_NAME;
+    const TypeDescNameMap& standardNames = standardTypes().names;
+    auto it = standardNames.find(_id);
+    if (it != standardNames.end())
+    {
+        return it->second;
+    }
+
+    if (isStruct())
+    {
+        StructTypeStorage& storage = structTypeStorage();
+        std::shared_lock<std::shared_mutex> lock(storage.mutex);
+        auto structIt = storage.names.find(_id);
+        if (structIt != storage.names.end())
+        {
+            return structIt->second;
+        }
+    }
+
+    CustomTypes& custom = customTypes();
+    std::shared_lock<std::shared_mutex> lock(custom.mutex);
+    auto customIt = custom.names.find(_id);
+    return customIt != custom.names.end() ? customIt->second : NONE_TYPE_NAME;
 }
 
 TypeDesc TypeDesc::get(const string& name)
 {
-    TypeDescMap& types = typeMap();
-    auto it = types.find(name);
-    return it != types.end() ? it->second : Type::NONE;
+    const TypeDescMap& standard = standardTypes().types;
+    auto it = standard.find(name);
+    if (it != standard.end())
+    {
+        return it->second;
+    }
+
+    const StructTypeRegistry* registry = StructTypeRegistry::getActive();
+    if (registry)
+    {
+        TypeDesc type = registry->getType(name);
+        if (type != Type::NONE)
+        {
+            return type;
+        }
+    }
+
+    CustomTypes& custom = customTypes();
+    std::shared_lock<std::shared_mutex> lock(custom.mutex);
+    auto customIt = custom.types.find(name);
+    return customIt != custom.types.end() ? customIt->second : Type::NONE;
 }
 
 void TypeDesc::remove(const string& name)
 {
-    TypeDescNameMap& typenames = typeNameMap();
+    CustomTypes& custom = customTypes();
+    std::unique_lock<std::shared_mutex> lock(custom.mutex);
 
-    TypeDescMap& types = typeMap();
-
-    auto it = types.find(name);
-    if (it == types.end())
+    auto it = custom.types.find(name);
+    if (it == custom.types.end())
         return;
 
-    typenames.erase(it->second.typeId());
-    types.erase(it);
+    custom.names.erase(it->second.typeId());
+    custom.types.erase(it);
 }
 
 ValuePtr TypeDesc::createValueFromStrings(const string& value) const
@@ -103,43 +221,17 @@ ValuePtr TypeDesc::createValueFromStrings(const string& value) const
 
 TypeDescRegistry::TypeDescRegistry(TypeDesc type, const string& name)
 {
-    TypeDescMap& types = typeMap();
-    TypeDescNameMap& typenames = typeNameMap();
-    types[name] = type;
-    typenames[type.typeId()] = name;
-}
-
-namespace Type
-{
-
-///
-/// Register type descriptors for standard types.
-///
-TYPEDESC_REGISTER_TYPE(NONE, "none")
-TYPEDESC_REGISTER_TYPE(BOOLEAN, "boolean")
-TYPEDESC_REGISTER_TYPE(INTEGER, "integer")
-TYPEDESC_REGISTER_TYPE(INTEGERARRAY, "integerarray")
-TYPEDESC_REGISTER_TYPE(FLOAT, "float")
-TYPEDESC_REGISTER_TYPE(FLOATARRAY, "floatarray")
-TYPEDESC_REGISTER_TYPE(VECTOR2, "vector2")
-TYPEDESC_REGISTER_TYPE(VECTOR3, "vector3")
-TYPEDESC_REGISTER_TYPE(VECTOR4, "vector4")
-TYPEDESC_REGISTER_TYPE(COLOR3, "color3")
-TYPEDESC_REGISTER_TYPE(COLOR4, "color4")
-TYPEDESC_REGISTER_TYPE(MATRIX33, "matrix33")
-TYPEDESC_REGISTER_TYPE(MATRIX44, "matrix44")
-TYPEDESC_REGISTER_TYPE(STRING, "string")
-TYPEDESC_REGISTER_TYPE(FILENAME, "filename")
-TYPEDESC_REGISTER_TYPE(BSDF, "BSDF")
-TYPEDESC_REGISTER_TYPE(EDF, "EDF")
-TYPEDESC_REGISTER_TYPE(VDF, "VDF")
-TYPEDESC_REGISTER_TYPE(SURFACESHADER, "surfaceshader")
-TYPEDESC_REGISTER_TYPE(VOLUMESHADER, "volumeshader")
-TYPEDESC_REGISTER_TYPE(DISPLACEMENTSHADER, "displacementshader")
-TYPEDESC_REGISTER_TYPE(LIGHTSHADER, "lightshader")
-TYPEDESC_REGISTER_TYPE(MATERIAL, "material")
-
-} // namespace Type
+    // Standard types are registered in advance, and cannot be redefined.
+    if (standardTypes().types.count(name))
+    {
+        return;
+    }
+
+    CustomTypes& custom = customTypes();
+    std::unique_lock<std::shared_mutex> lock(custom.mutex);
+    custom.types[name] = type;
+    custom.names[type.typeId()] = name;
+}
 
 //
 // StructTypeDesc methods
@@ -152,42 +244,86 @@ void StructTypeDesc::addMember(const string& name, TypeDesc type, const string&
 
 vector<string> StructTypeDesc::getStructTypeNames()
 {
-    StructTypeDescStorage& structs = structTypeStorage();
+    const StructTypeRegistry* registry = StructTypeRegistry::getActive();
+    if (registry)
+    {
+        return registry->getTypeNames();
+    }
+
+    StructTypeStorage& storage = structTypeStorage();
+    std::shared_lock<std::shared_mutex> lock(storage.mutex);
     vector<string> structNames;
-    for (const auto& x : structs)
+    for (const auto& x : storage.structs)
     {
-        structNames.emplace_back(x.typeDesc().getName());
+        auto it = storage.names.find(x.typeDesc().typeId());
+        structNames.emplace_back(it != storage.names.end() ? it->second : TypeDesc::NONE_TYPE_NAME);
     }
     return structNames;
 }
 
 StructTypeDesc& StructTypeDesc::get(unsigned int index)
 {
-    StructTypeDescStorage& structs = structTypeStorage();
-    return structs[index];
+    StructTypeStorage& storage = structTypeStorage();
+    std::shared_lock<std::shared_mutex> lock(storage.mutex);
+    return storage.structs[index];
 }
 
 uint16_t StructTypeDesc::emplace_back(StructTypeDesc structTypeDesc)
 {
-    StructTypeDescStorage& structs = structTypeStorage();
-    if (structs.size() >= std::numeric_limits<uint16_t>::max())
+    StructTypeStorage& storage = structTypeStorage();
+    std::unique_lock<std::shared_mutex> lock(storage.mutex);
+    if (storage.structs.size() >= std::numeric_limits<uint16_t>::max())
     {
         throw ExceptionShaderGenError("Maximum number of custom struct types has been exceeded.");
     }
-    uint16_t index = static_cast<uint16_t>(structs.size());
-    structs.emplace_back(structTypeDesc);
+    uint16_t index = static_cast<uint16_t>(storage.structs.size());
+    storage.structs.emplace_back(structTypeDesc);
     return index;
 }
 
+TypeDesc StructTypeDesc::store(const string& name, StructTypeDesc structTypeDesc)
+{
+    StructTypeStorage& storage = structTypeStorage();
+    std::unique_lock<std::shared_mutex> lock(storage.mutex);
+
+    // Return any identical definition that has already been stored.
+    const uint32_t typeId = TypeDesc(name, TypeDesc::BASETYPE_STRUCT).typeId();
+    for (const StructTypeDesc& existing : storage.structs)
+    {
+        if (existing.typeDesc().typeId() == typeId && structMembersMatch(existing, structTypeDesc))
+        {
+            return existing.typeDesc();
+        }
+    }
+
+    if (storage.structs.size() >= std::numeric_limits<uint16_t>::max())
+    {
+        throw ExceptionShaderGenError("Maximum number of custom struct types has been exceeded.");
+    }
+    uint16_t index = static_cast<uint16_t>(storage.structs.size());
+    TypeDesc typeDesc(name, TypeDesc::BASETYPE_STRUCT, TypeDesc::SEMANTIC_NONE, 1, index);
+    structTypeDesc.setTypeDesc(typeDesc);
+    storage.structs.emplace_back(structTypeDesc);
+    storage.names[typeId] = name;
+    return typeDesc;
+}
+
 void StructTypeDesc::clear()
 {
-    StructTypeDescStorage& structs = structTypeStorage();
-    for (const auto& structType: structs)
+    CustomTypes& custom = customTypes();
+    std::unique_lock<std::shared_mutex> lock(custom.mutex);
+    for (auto it = custom.types.begin(); it != custom.types.end();)
     {
-        // Need to add typeID to structTypeDesc - and use it here to reference back to typeDesc obj and remove it.
-        TypeDesc::remove(structType.typeDesc().getName());
+        if (it->second.isStruct())
+        {
+            custom.names.erase(it->second.typeId());
+            it = custom.types.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
     }
-    structs.clear();
 }
 
 const string& StructTypeDesc::getName() const
@@ -200,6 +336,47 @@ const vector<StructTypeDesc::StructMemberTypeDesc>& StructTypeDesc::getMembers()
     return _members;
 }
 
+//
+// StructTypeRegistry methods
+//
+
+StructTypeRegistry::Scope::Scope(const StructTypeRegistry* registry) :
+    _previous(activeStructTypeRegistry)
+{
+    activeStructTypeRegistry = registry;
+}
+
+StructTypeRegistry::Scope::~Scope()
+{
+    activeStructTypeRegistry = _previous;
+}
+
+void StructTypeRegistry::registerType(TypeDesc type, const string& name)
+{
+    if (!_types.count(name))
+    {
+        _typeNames.push_back(name);
+    }
+    _types[name] = type;
+}
+
+TypeDesc StructTypeRegistry::getType(const string& name) const
+{
+    auto it = _types.find(name);
+    return it != _types.end() ? it->second : Type::NONE;
+}
+
+void StructTypeRegistry::clear()
+{
+    _types.clear();
+    _typeNames.clear();
+}
+
+const StructTypeRegistry* StructTypeRegistry::getActive()
+{
+    return activeStructTypeRegistry;
+}
+
 TypeDesc createStructTypeDesc(std::string_view name)
 {
     return {name, TypeDesc::BASETYPE_STRUCT};
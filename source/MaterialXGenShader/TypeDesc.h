@@ -32,6 +32,11 @@ MATERIALX_NAMESPACE_BEGIN
 /// The class is a POD type of 64-bits and can efficiently be stored and passed by value.
 /// Type compare operations and hash operations are done using a precomputed hash value.
 ///
+/// Lookups of standard types are lock-free, and all lookups are thread-safe.  Struct
+/// types loaded from a document are held by the StructTypeRegistry of a shader
+/// generator, and are found by name only while that registry is active on the
+/// calling thread.
+///
 class MX_GENSHADER_API TypeDesc
 {
   public:
@@ -153,7 +158,9 @@ class MX_GENSHADER_API TypeDesc
         }
     };
 
-    /// Return a type description by name.
+    /// Return a type description by name, searching the standard types, the
+    /// struct types of the active StructTypeRegistry, if any, and then any
+    /// custom registered types.
     /// If no type is found Type::NONE is returned.
     static TypeDesc get(const string& name);
 
@@ -260,8 +267,23 @@ class MX_GENSHADER_API StructTypeDesc
 
     /// Return a type description by index.
     static StructTypeDesc& get(unsigned int index);
+
+    /// Return the names of the struct types in the active StructTypeRegistry,
+    /// or of all stored struct types if no registry is active.
     static vector<string> getStructTypeNames();
+
+    /// Append the given struct type description to the process-wide storage,
+    /// returning its index.
     static uint16_t emplace_back(StructTypeDesc structTypeDesc);
+
+    /// Store a struct type of the given name and members, returning its type
+    /// description.  Identical definitions share a single storage entry, so
+    /// that repeated loading of a struct type consumes no further storage.
+    static TypeDesc store(const string& name, StructTypeDesc structTypeDesc);
+
+    /// Remove all struct types from the process-wide registry of custom types.
+    /// Stored struct type descriptions, and the struct types held by each
+    /// StructTypeRegistry, remain valid.
     static void clear();
 
     TypeDesc typeDesc() const { return _typedesc; }
@@ -281,6 +303,58 @@ class MX_GENSHADER_API StructTypeDescRegistry
     StructTypeDescRegistry();
 };
 
+/// @class StructTypeRegistry
+/// A registry of the struct types loaded from documents for a single shader
+/// generator, overlaying the process-wide registry of standard and custom types.
+///
+/// A registry is made active on the calling thread through a
+/// StructTypeRegistry::Scope, during which TypeDesc::get will find its types
+/// by name.  As each thread activates only the registry of the generator it is
+/// using, generators with distinct struct types may run concurrently.
+class MX_GENSHADER_API StructTypeRegistry
+{
+  public:
+    /// @class Scope
+    /// An RAII class that activates a registry on the calling thread, restoring
+    /// the previously active registry when destroyed.
+    class MX_GENSHADER_API Scope
+    {
+      public:
+        explicit Scope(const StructTypeRegistry* registry);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+      private:
+        const StructTypeRegistry* _previous;
+    };
+
+    /// Register a struct type under the given name, replacing any existing
+    /// struct type of the same name.
+    void registerType(TypeDesc type, const string& name);
+
+    /// Return the struct type with the given name, or Type::NONE if no such
+    /// type has been registered.
+    TypeDesc getType(const string& name) const;
+
+    /// Return the names of all registered struct types, in registration order.
+    const vector<string>& getTypeNames() const
+    {
+        return _typeNames;
+    }
+
+    /// Remove all registered struct types.
+    void clear();
+
+    /// Return the registry that is active on the calling thread, if any.
+    static const StructTypeRegistry* getActive();
+
+  private:
+    std::unordered_map<string, TypeDesc> _types;
+    vector<string> _typeNames;
+};
+
 MATERIALX_NAMESPACE_END
 
 #endif
@@ -5,8 +5,13 @@
 
 #include <MaterialXGenShader/Util.h>
 
+#include <MaterialXGenShader/GenContext.h>
 #include <MaterialXGenShader/HwShaderGenerator.h>
 
+#include <atomic>
+#include <chrono>
+#include <thread>
+
 MATERIALX_NAMESPACE_BEGIN
 
 namespace
@@ -440,6 +445,93 @@ vector<TypedElementPtr> findRenderableElements(ConstDocumentPtr doc)
     return renderableElements;
 }
 
+vector<BatchShaderResult> generateBatch(const vector<TypedElementPtr>& elements,
+                                         const GenContextFactory& contextFactory,
+                                         unsigned int workerCount)
+{
+    vector<BatchShaderResult> results(elements.size());
+    if (elements.empty())
+    {
+        return results;
+    }
+    if (workerCount == 0)
+    {
+        workerCount = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    workerCount = (unsigned int) std::min((size_t) workerCount, elements.size());
+
+    // Float formatting is thread-local, so workers inherit the formatting of
+    // the calling thread explicitly.
+    const Value::FloatFormat floatFormat = Value::getFloatFormat();
+    const int floatPrecision = Value::getFloatPrecision();
+
+    SourceCodeCachePtr sourceCodeCache = SourceCodeCache::create();
+    std::atomic<size_t> nextElement(0);
+    auto runWorker = [&]()
+    {
+        ScopedFloatFormatting floatFormatting(floatFormat, floatPrecision);
+        GenContextPtr context;
+        string contextError;
+        try
+        {
+            context = contextFactory();
+            if (!context)
+            {
+                contextError = "Generation context factory returned no context";
+            }
+            else if (!context->getSourceCodeCache())
+            {
+                context->setSourceCodeCache(sourceCodeCache);
+            }
+        }
+        catch (std::exception& e)
+        {
+            contextError = e.what();
+        }
+
+        for (size_t index = nextElement++; index < elements.size(); index = nextElement++)
+        {
+            BatchShaderResult& result = results[index];
+            result.element = elements[index];
+            if (!context)
+            {
+                result.error = contextError;
+                continue;
+            }
+
+            auto startTime = std::chrono::steady_clock::now();
+            try
+            {
+                const string name = createValidName(result.element->getNamePath());
+                result.shader = context->getShaderGenerator().generate(name, result.element, *context);
+            }
+            catch (std::exception& e)
+            {
+                result.error = e.what();
+            }
+            std::chrono::duration<double> duration = std::chrono::steady_clock::now() - startTime;
+            result.generationTime = duration.count();
+        }
+    };
+
+    if (workerCount <= 1)
+    {
+        runWorker();
+        return results;
+    }
+
+    vector<std::thread> workers;
+    for (unsigned int i = 0; i < workerCount; i++)
+    {
+        workers.emplace_back(runWorker);
+    }
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+    return results;
+}
+
 InputPtr getNodeDefInput(InputPtr nodeInput, const string& target)
 {
     ElementPtr parent = nodeInput ? nodeInput->getParent() : nullptr;
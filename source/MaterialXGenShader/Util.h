@@ -13,12 +13,32 @@
 
 #include <MaterialXCore/Document.h>
 
+#include <functional>
 #include <unordered_set>
 
 MATERIALX_NAMESPACE_BEGIN
 
 class ShaderGenerator;
 
+/// A function returning a new generation context for a batch worker.
+using GenContextFactory = std::function<GenContextPtr()>;
+
+/// The result of generating a shader for a single element of a batch.
+struct BatchShaderResult
+{
+    /// The element for which the shader was generated.
+    TypedElementPtr element;
+
+    /// The generated shader, or nullptr if generation failed.
+    ShaderPtr shader;
+
+    /// The error message if generation failed.
+    string error;
+
+    /// The time spent generating the shader, in seconds.
+    double generationTime = 0.0;
+};
+
 /// Returns true if the given element is a surface shader with the potential
 /// of being transparent. This can be used by HW shader generators to determine
 /// if a shader will require transparency handling.
@@ -56,6 +76,19 @@ MX_GENSHADER_API vector<TypedElementPtr> findRenderableMaterialNodes(ConstDocume
 /// @return A vector of renderable elements
 MX_GENSHADER_API vector<TypedElementPtr> findRenderableElements(ConstDocumentPtr doc);
 
+/// Generate shaders for the given renderable elements in parallel.
+/// Elements are distributed on demand over the given number of worker threads,
+/// each of which creates its own generation context from the given factory and
+/// reuses it for all elements it processes.  Contexts without a source code
+/// cache are assigned one that is shared between all workers.
+/// @param elements Renderable elements, such as those returned by findRenderableElements
+/// @param contextFactory Function returning a new generation context
+/// @param workerCount Number of worker threads, or zero to use the hardware concurrency
+/// @return A vector of results, in the order of the given elements.
+MX_GENSHADER_API vector<BatchShaderResult> generateBatch(const vector<TypedElementPtr>& elements,
+                                                          const GenContextFactory& contextFactory,
+                                                          unsigned int workerCount = 0);
+
 /// Given a node input, return the corresponding input within its matching nodedef.
 /// The optional target string can be used to guide the selection of nodedef declarations.
 MX_GENSHADER_API InputPtr getNodeDefInput(InputPtr nodeInput, const string& target);
@@ -3305,6 +3305,10 @@ void Graph::propertyEditor()
 
     if (_currUiNode)
     {
+        // Resolve struct input types through the renderer's shader generator.
+        const mx::StructTypeRegistry* structTypes = _renderer ? &_renderer->getGenContext().getShaderGenerator().getStructTypes() : nullptr;
+        mx::StructTypeRegistry::Scope structTypeScope(structTypes);
+
         // Set and edit name
         ImGui::Text("Name: ");
         ImGui::SameLine();
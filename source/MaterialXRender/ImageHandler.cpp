@@ -177,21 +177,17 @@ void ImageHandler::releaseRenderResources(ImagePtr)
 ImageVec ImageHandler::getReferencedImages(ConstDocumentPtr doc)
 {
     ImageVec imageVec;
-    for (ElementPtr elem : doc->traverseTree())
+    for (const auto& pair : resolveFilenames(doc))
     {
-        if (elem->getActiveSourceUri() != doc->getSourceUri())
+        if (!pair.first->isA<Input>() || pair.first->getActiveSourceUri() != doc->getSourceUri())
         {
             continue;
         }
 
-        InputPtr input = elem->asA<Input>();
-        if (input && input->getType() == FILENAME_TYPE_STRING)
+        ImagePtr image = acquireImage(pair.second);
+        if (image)
         {
-            ImagePtr image = acquireImage(input->getResolvedValueString());
-            if (image)
-            {
-                imageVec.push_back(image);
-            }
+            imageVec.push_back(image);
         }
     }
     return imageVec;
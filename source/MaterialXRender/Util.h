@@ -99,6 +99,8 @@ struct MX_RENDER_API UIProperties
 
 /// Get the UI properties for a given input element and target.
 /// Returns the number of properties found.
+/// Struct types are resolved through the active StructTypeRegistry, so callers
+/// should hold a StructTypeRegistry::Scope for the generator that loaded them.
 MX_RENDER_API unsigned int getUIProperties(InputPtr input, const string& target, UIProperties& uiProperties);
 
 /// Interface for holding the UI properties associated shader port
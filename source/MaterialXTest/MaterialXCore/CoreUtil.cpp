@@ -35,6 +35,17 @@ TEST_CASE("String utilities", "[coreutil]")
     REQUIRE(mx::splitString("robot1, robot2", ", ") == (std::vector<std::string>{"robot1", "robot2"}));
     REQUIRE(mx::splitString("[one...two...three]", "[.]") == (std::vector<std::string>{"one", "two", "three"}));
 
+    REQUIRE(mx::replaceSubstrings("<a>/<b>.png", { { "<a>", "x" }, { "<b>", "y" } }) == "x/y.png");
+
+    mx::SubstringReplacer replacer({ { "<UDIM>", "1001" }, { "[id]", "01" }, { "[id2]", "02" }, { "", "empty" } });
+    REQUIRE(replacer.apply("tex_[id]_<UDIM>.png") == "tex_01_1001.png");
+    REQUIRE(replacer.apply("tex_[id2].png") == "tex_02.png");
+    REQUIRE(replacer.apply("tex_[id.png") == "tex_[id.png");
+    REQUIRE(replacer.apply("") == "");
+    replacer.addSubstitution("[id]", "<UDIM>");
+    REQUIRE(replacer.apply("[id][id]") == "<UDIM><UDIM>");
+    REQUIRE(mx::SubstringReplacer().empty());
+
     REQUIRE(mx::stringToLower("testName") == "testname");
     REQUIRE(mx::stringToLower("testName1") == "testname1");
 
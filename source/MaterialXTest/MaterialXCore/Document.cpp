@@ -10,6 +10,9 @@
 #include <MaterialXFormat/Util.h>
 #include <MaterialXFormat/XmlIo.h>
 
+#include <algorithm>
+#include <thread>
+
 namespace mx = MaterialX;
 
 TEST_CASE("Document", "[document]")
@@ -271,3 +274,653 @@ TEST_CASE("Document equivalence", "[document]")
     equivalent = doc->isEquivalent(doc2, options, &message);
     REQUIRE(!equivalent);
 }
+
+TEST_CASE("Content hash", "[document]")
+{
+    // Create two documents that differ only in value formatting, attribute
+    // order, graph child order, and comments.
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::NodeGraphPtr graph = doc->addNodeGraph("graph");
+    mx::InputPtr input1 = graph->addInput("input1", "color3");
+    input1->setValueString("  1.0,   +2.0,  3.0   ");
+    input1->setAttribute(mx::ValueElement::UI_MIN_ATTRIBUTE, " 0.00, 0, 0");
+    mx::InputPtr input2 = graph->addInput("input2", "vector2");
+    input2->setValueString("1.0,   0.012345608");
+    doc->addChildOfCategory(mx::CommentElement::CATEGORY)->setDocString("Comment");
+
+    mx::DocumentPtr doc2 = mx::createDocument();
+    mx::NodeGraphPtr graph2 = doc2->addNodeGraph("graph");
+    mx::InputPtr input2b = graph2->addInput("input2", "vector2");
+    input2b->setValueString("1, 0.012345611");
+    mx::InputPtr input1b = graph2->addInput("input1", "color3");
+    input1b->setAttribute(mx::ValueElement::UI_MIN_ATTRIBUTE, "0, 0, 0");
+    input1b->setValueString("1, 2, 3");
+
+    // Hashes agree with equivalence under each set of criteria.
+    mx::ElementEquivalenceOptions options;
+    REQUIRE(doc->isEquivalent(doc2, options));
+    REQUIRE(doc->getContentHash(options) == doc2->getContentHash(options));
+    options.performValueComparisons = false;
+    REQUIRE(!doc->isEquivalent(doc2, options));
+    REQUIRE(doc->getContentHash(options) != doc2->getContentHash(options));
+    options.performValueComparisons = true;
+    options.floatPrecision = 8;
+    REQUIRE(!doc->isEquivalent(doc2, options));
+    REQUIRE(doc->getContentHash(options) != doc2->getContentHash(options));
+    options = mx::ElementEquivalenceOptions();
+
+    // Excluded attributes do not contribute to hashes.
+    input1b->setAttribute(mx::ValueElement::UI_MIN_ATTRIBUTE, "0.5, 0, 0");
+    REQUIRE(doc->getContentHash(options) != doc2->getContentHash(options));
+    options.attributeExclusionList = { mx::ValueElement::UI_MIN_ATTRIBUTE };
+    REQUIRE(doc->isEquivalent(doc2, options));
+    REQUIRE(doc->getContentHash(options) == doc2->getContentHash(options));
+
+    // Child order is significant in functional graphs.
+    doc->addNodeDef("ND_graph");
+    graph->setNodeDefString("ND_graph");
+    doc2->addNodeDef("ND_graph");
+    graph2->setNodeDefString("ND_graph");
+    REQUIRE(!doc->isEquivalent(doc2, options));
+    REQUIRE(doc->getContentHash(options) != doc2->getContentHash(options));
+    graph2->setChildIndex("input1", 0);
+    REQUIRE(doc->isEquivalent(doc2, options));
+    REQUIRE(doc->getContentHash(options) == doc2->getContentHash(options));
+
+    // Cached hashes follow the addition and removal of graph nodedefs.
+    size_t graphHash = graph->getContentHash(options);
+    doc->removeNodeDef("ND_graph");
+    REQUIRE(graph->getContentHash(options) != graphHash);
+    doc->addNodeDef("ND_graph");
+    REQUIRE(graph->getContentHash(options) == graphHash);
+
+    // Hashes may be computed concurrently on a frozen document.
+    mx::DocumentPtr doc3 = doc->copy();
+    doc3->freeze();
+    const size_t docHash = doc->getContentHash(options);
+    std::vector<size_t> hashes(8);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < hashes.size(); i++)
+    {
+        threads.emplace_back([&doc3, &hashes, &options, i]()
+        {
+            hashes[i] = doc3->getContentHash(options);
+        });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    for (size_t hash : hashes)
+    {
+        REQUIRE(hash == docHash);
+    }
+}
+
+TEST_CASE("Document diff", "[document]")
+{
+    // Load an example document and a copy of it.
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::readFromXmlFile(doc, "resources/Materials/Examples/StandardSurface/standard_surface_marble_solid.mtlx", searchPath);
+    mx::DocumentPtr doc2 = doc->copy();
+    REQUIRE(doc->getContentHash() == doc2->getContentHash());
+    REQUIRE(mx::diffElements(doc, doc2).empty());
+
+    // Cached hashes are invalidated by edits to descendants.
+    mx::NodeGraphPtr graph = doc2->getNodeGraph("NG_marble1");
+    mx::InputPtr input = graph->getNode("scale_noise")->getInput("in2");
+    size_t graphHash = graph->getContentHash();
+    input->setValueString("4.0");
+    REQUIRE(graph->getContentHash() != graphHash);
+    input->setValueString("3.0");
+    REQUIRE(graph->getContentHash() == graphHash);
+
+    // Formatting differences in values are not reported.
+    input->setValueString(" 3 ");
+    REQUIRE(graph->getContentHash() == graphHash);
+    REQUIRE(mx::diffElements(doc, doc2).empty());
+
+    // Report modified, added and removed elements.
+    input->setValueString("4.0");
+    graph->addNode("constant", "added", "float");
+    graph->removeNode("sin");
+    doc->addLook("removed");
+    mx::ElementDiff diff = mx::diffElements(doc, doc2);
+    REQUIRE(diff.modified == mx::StringVec{ "NG_marble1/scale_noise/in2" });
+    REQUIRE(diff.added == mx::StringVec{ "NG_marble1/added" });
+    REQUIRE(diff.removed == mx::StringVec{ "NG_marble1/sin", "removed" });
+
+    // Report reordered children of functional elements.
+    mx::DocumentPtr doc3 = doc->copy();
+    mx::NodePtr node = doc3->getDescendant("NG_marble1/add_xyz")->asA<mx::Node>();
+    node->setChildIndex("in2", 0);
+    diff = mx::diffElements(doc, doc3);
+    REQUIRE(diff.modified == mx::StringVec{ "NG_marble1/add_xyz" });
+    REQUIRE(diff.added.empty());
+    REQUIRE(diff.removed.empty());
+}
+
+TEST_CASE("Document cache", "[document]")
+{
+    // Create a document with a chain of connected nodes.
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph();
+    mx::NodePtr constant = nodeGraph->addNode("constant", "constant1", "float");
+    mx::NodePtr add = nodeGraph->addNode("add", "add1", "float");
+    mx::NodePtr multiply = nodeGraph->addNode("multiply", "multiply1", "float");
+    add->addInput("in1", "float")->setConnectedNode(constant);
+    multiply->addInput("in1", "float")->setConnectedNode(add);
+    mx::OutputPtr output = nodeGraph->addOutput("out", "float");
+    output->setConnectedNode(multiply);
+
+    // Populate the cache.
+    REQUIRE(constant->getDownstreamPorts().size() == 1);
+    REQUIRE(add->getDownstreamPorts().size() == 1);
+    REQUIRE(multiply->getDownstreamPorts().size() == 1);
+
+    // Reconnect ports, and verify incremental updates of the cache.
+    multiply->getInput("in1")->setConnectedNode(constant);
+    REQUIRE(constant->getDownstreamPorts().size() == 2);
+    REQUIRE(add->getDownstreamPorts().empty());
+    output->removeAttribute(mx::PortElement::NODE_NAME_ATTRIBUTE);
+    REQUIRE(multiply->getDownstreamPorts().empty());
+    output->setConnectedNode(add);
+    REQUIRE(add->getDownstreamPorts().size() == 1);
+
+    // Remove and add elements, and verify incremental updates of the cache.
+    nodeGraph->removeNode(multiply->getName());
+    REQUIRE(constant->getDownstreamPorts().size() == 1);
+    mx::NodePtr subtract = nodeGraph->addNode("subtract", "subtract1", "float");
+    subtract->addInput("in1", "float")->setConnectedNode(constant);
+    subtract->addInput("in2", "float")->setConnectedNode(add);
+    REQUIRE(constant->getDownstreamPorts().size() == 2);
+    REQUIRE(add->getDownstreamPorts().size() == 2);
+
+    // Edit elements of a removed subtree, and verify that the cache is unaffected.
+    mx::NodeGraphPtr detachedGraph = doc->addNodeGraph();
+    mx::NodePtr detachedNode = detachedGraph->addNode("add", "add1", "float");
+    doc->removeNodeGraph(detachedGraph->getName());
+    detachedNode->addInput("in1", "float")->setNodeName(add->getName());
+    REQUIRE(add->getDownstreamPorts().size() == 2);
+
+    // Add nodedefs and implementations, and verify incremental updates of the cache.
+    mx::NodeDefPtr nodeDef = doc->addNodeDef("ND_custom", "float", "custom");
+    REQUIRE(doc->getMatchingNodeDefs("custom").size() == 1);
+    mx::ImplementationPtr impl = doc->addImplementation("IM_custom");
+    REQUIRE(doc->getMatchingImplementations("ND_custom").empty());
+    impl->setNodeDef(nodeDef);
+    REQUIRE(doc->getMatchingImplementations("ND_custom").size() == 1);
+    nodeDef->setNodeString("custom2");
+    REQUIRE(doc->getMatchingNodeDefs("custom").empty());
+    REQUIRE(doc->getMatchingNodeDefs("custom2").size() == 1);
+
+    // Apply a namespace, and verify that the cache is rebuilt.
+    doc->setNamespace("ns");
+    REQUIRE(doc->getMatchingNodeDefs("custom2").empty());
+    REQUIRE(doc->getMatchingNodeDefs("ns:custom2").size() == 1);
+    REQUIRE(constant->getDownstreamPorts().size() == 2);
+
+    // Verify that incremental updates match a full rebuild of the cache.
+    std::vector<size_t> portCounts;
+    for (mx::NodePtr node : nodeGraph->getNodes())
+    {
+        portCounts.push_back(node->getDownstreamPorts().size());
+    }
+    doc->invalidateCache();
+    for (size_t i = 0; i < portCounts.size(); i++)
+    {
+        REQUIRE(nodeGraph->getNodes()[i]->getDownstreamPorts().size() == portCounts[i]);
+    }
+
+    // Freeze the document, and verify that lookups succeed and edits are rejected.
+    doc->freeze();
+    REQUIRE(doc->isFrozen());
+    REQUIRE(constant->getDownstreamPorts().size() == 2);
+    REQUIRE(doc->getMatchingNodeDefs("ns:custom2").size() == 1);
+    REQUIRE_THROWS_AS(constant->setName("constant2"), mx::Exception);
+    REQUIRE_THROWS_AS(add->setInputValue("in2", 1.0f), mx::Exception);
+    REQUIRE_THROWS_AS(nodeGraph->removeNode(subtract->getName()), mx::Exception);
+    REQUIRE_THROWS_AS(doc->invalidateCache(), mx::Exception);
+    REQUIRE_THROWS_AS(constant->setCategory("image"), mx::Exception);
+    REQUIRE_THROWS_AS(constant->setSourceUri("edited.mtlx"), mx::Exception);
+    REQUIRE_THROWS_AS(nodeGraph->setChildIndex(constant->getName(), 0), mx::Exception);
+    REQUIRE(add->getInput("in2") == nullptr);
+    REQUIRE(constant->getCategory() == "constant");
+    REQUIRE(nodeGraph->getNode(subtract->getName()) != nullptr);
+    doc->unfreeze();
+    REQUIRE(!doc->isFrozen());
+    REQUIRE_NOTHROW(add->setInputValue("in2", 1.0f));
+}
+
+TEST_CASE("Layered data libraries", "[document]")
+{
+    // Create two library layers with an overlapping definition.
+    mx::DocumentPtr baseLibrary = mx::createDocument();
+    mx::NodeDefPtr baseNodeDef = baseLibrary->addNodeDef("ND_layered", "float", "layered");
+    baseNodeDef->setInputValue("in", 0.0f);
+    baseLibrary->addNodeDef("ND_base", "float", "base");
+    mx::DocumentPtr overrideLibrary = mx::createDocument();
+    mx::NodeDefPtr overrideNodeDef = overrideLibrary->addNodeDef("ND_layered", "float", "layered");
+    overrideNodeDef->setInputValue("in", 1.0f);
+    baseLibrary->freeze();
+    overrideLibrary->freeze();
+
+    // Reference both layers from a document, in priority order.
+    mx::DocumentPtr doc = mx::createDocument();
+    doc->setDataLibraries({ overrideLibrary, baseLibrary });
+    REQUIRE(doc->getDataLibraries().size() == 2);
+    REQUIRE(doc->getDataLibrary() == overrideLibrary);
+    REQUIRE(doc->getChildren().empty());
+
+    // Lookups see through the layers, with earlier layers shadowing later ones.
+    REQUIRE(doc->getNodeDef("ND_layered") == overrideNodeDef);
+    REQUIRE(doc->getNodeDef("ND_base") != nullptr);
+    REQUIRE(doc->getNodeDefs().size() == 2);
+    REQUIRE(doc->getMatchingNodeDefs("layered").size() == 1);
+    mx::NodePtr node = doc->addNode("layered", "node1", "float");
+    REQUIRE(node->getNodeDef() == overrideNodeDef);
+
+    // Editing a layer element copies it into the document, leaving the
+    // shared layer untouched.
+    mx::NodeDefPtr editedNodeDef = doc->getEditableChild("ND_layered")->asA<mx::NodeDef>();
+    REQUIRE(editedNodeDef);
+    REQUIRE(editedNodeDef->getDocument() == doc);
+    editedNodeDef->setInputValue("in", 2.0f);
+    REQUIRE(overrideNodeDef->getInputValue("in")->asA<float>() == 1.0f);
+    REQUIRE(doc->getNodeDef("ND_layered") == editedNodeDef);
+    REQUIRE(doc->getNodeDefs().size() == 2);
+    REQUIRE(doc->getMatchingNodeDefs("layered").size() == 1);
+    REQUIRE(node->getNodeDef() == editedNodeDef);
+    REQUIRE(doc->getEditableChild("ND_layered") == editedNodeDef);
+    REQUIRE(doc->getEditableChild("ND_missing") == nullptr);
+    REQUIRE(doc->validate());
+
+    // Copies of the document share its layers.
+    mx::DocumentPtr copy = doc->copy();
+    REQUIRE(copy->getDataLibraries() == doc->getDataLibraries());
+
+    // Clear the layers.
+    doc->setDataLibrary(nullptr);
+    REQUIRE(!doc->hasDataLibrary());
+    REQUIRE(doc->getNodeDef("ND_base") == nullptr);
+
+    // The layers of a frozen document cannot be replaced.
+    REQUIRE_THROWS_AS(baseLibrary->setDataLibrary(overrideLibrary), mx::Exception);
+    REQUIRE_THROWS_AS(baseLibrary->addDataLibrary(overrideLibrary), mx::Exception);
+    REQUIRE_THROWS_AS(baseLibrary->setDataLibraries({ overrideLibrary }), mx::Exception);
+
+    // XInclude references provided by a layer are not imported when reading,
+    // and are written again when serializing.
+    const std::string href = "libraries/stdlib/stdlib_defs.mtlx";
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::DocumentPtr stdlib = mx::createDocument();
+    mx::readFromXmlFile(stdlib, href, searchPath);
+    stdlib->freeze();
+    mx::DocumentPtr asset = mx::createDocument();
+    asset->setDataLibrary(stdlib);
+    mx::readFromXmlString(asset, "<materialx version=\"1.39\" xmlns:xi=\"http://www.w3.org/2001/XInclude\">"
+                                 "<xi:include href=\"" + href + "\" /><constant name=\"constant1\" type=\"float\" /></materialx>", searchPath);
+    REQUIRE(asset->getChildren().size() == 1);
+    REQUIRE(asset->getLayerXIncludes() == mx::StringVec{ href });
+    std::string written = mx::writeToXmlString(asset);
+    REQUIRE(written.find("<xi:include href=\"" + href + "\" />") != std::string::npos);
+    mx::DocumentPtr reread = mx::createDocument();
+    reread->setDataLibrary(stdlib);
+    mx::readFromXmlString(reread, written, searchPath);
+    REQUIRE(reread->getChildren().size() == 1);
+    REQUIRE(mx::writeToXmlString(reread) == written);
+}
+
+TEST_CASE("Parallel validation", "[document]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::DocumentPtr libraries = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, libraries);
+
+    // Add an invalid document to the test suite documents.
+    std::vector<mx::DocumentPtr> docs;
+    mx::StringVec docPaths;
+    mx::loadDocuments(searchPath.find("resources/Materials/TestSuite"), searchPath, {}, {}, docs, docPaths);
+    REQUIRE(!docs.empty());
+    mx::DocumentPtr invalidDoc = mx::createDocument();
+    invalidDoc->addNodeGraph("graph1")->addNode("image", "image1", "color3")->addInput("file", "float");
+    invalidDoc->addNodeGraph("graph2")->addOutput("out", "float")->setNodeName("missing");
+    invalidDoc->addNodeDef("ND_invalid", "float", "invalid")->setInheritString("ND_missing");
+    docs.push_back(invalidDoc);
+
+    mx::ValidationOptions serialOptions;
+    mx::ValidationOptions parallelOptions;
+    parallelOptions.workerCount = 4;
+    size_t invalidCount = 0;
+    for (mx::DocumentPtr doc : docs)
+    {
+        doc->setDataLibrary(libraries);
+
+        // Compare the serial validator with structured results on one and
+        // many workers.
+        std::string message;
+        bool serialRes = doc->validate(&message);
+        mx::ValidationDiagnostics serialDiagnostics, parallelDiagnostics;
+        REQUIRE(doc->validate(serialOptions, &serialDiagnostics) == serialRes);
+        REQUIRE(doc->validate(parallelOptions, &parallelDiagnostics) == serialRes);
+        REQUIRE(serialDiagnostics == parallelDiagnostics);
+        std::string diagnosticMessage;
+        for (const mx::ValidationDiagnostic& diagnostic : parallelDiagnostics)
+        {
+            REQUIRE(doc->getDescendant(diagnostic.elementPath));
+            REQUIRE(diagnostic.message.compare(0, diagnostic.rule.size(), diagnostic.rule) == 0);
+            diagnosticMessage += diagnostic.message + "\n";
+        }
+        REQUIRE(diagnosticMessage == message);
+
+        // Stopping at the first error reports the same prefix of findings on
+        // any number of workers.
+        if (!serialRes)
+        {
+            invalidCount++;
+            mx::ValidationOptions stopOptions;
+            stopOptions.stopAtFirstError = true;
+            mx::ValidationDiagnostics serialStop, parallelStop;
+            REQUIRE(!doc->validate(stopOptions, &serialStop));
+            stopOptions.workerCount = 4;
+            REQUIRE(!doc->validate(stopOptions, &parallelStop));
+            REQUIRE(!serialStop.empty());
+            REQUIRE(serialStop == parallelStop);
+            REQUIRE(serialStop.size() <= serialDiagnostics.size());
+            REQUIRE(std::equal(serialStop.begin(), serialStop.end(), serialDiagnostics.begin()));
+        }
+    }
+    REQUIRE(invalidCount > 0);
+
+    // Findings for the invalid document identify their elements and rules.
+    mx::ValidationDiagnostics diagnostics;
+    REQUIRE(!invalidDoc->validate(parallelOptions, &diagnostics));
+    REQUIRE(diagnostics.size() >= 3);
+    REQUIRE(diagnostics[0].elementPath.compare(0, 6, "graph1") == 0);
+    REQUIRE(diagnostics.back().elementPath == "ND_invalid");
+    REQUIRE(diagnostics.back().rule == "Invalid element inheritance");
+
+    // Findings for the document element itself match those of the serial
+    // validator.
+    mx::DocumentPtr futureDoc = mx::createDocument();
+    futureDoc->setVersionString("99.0");
+    futureDoc->addNodeGraph("graph")->setInheritString("graph");
+    std::string futureMessage;
+    REQUIRE(!futureDoc->validate(&futureMessage));
+    diagnostics.clear();
+    REQUIRE(!futureDoc->validate(parallelOptions, &diagnostics));
+    REQUIRE(diagnostics.size() == 2);
+    REQUIRE(diagnostics[0].rule == "Future document version");
+    REQUIRE(diagnostics[1].rule == "Cycle in element inheritance chain");
+    REQUIRE(diagnostics[0].message + "\n" + diagnostics[1].message + "\n" == futureMessage);
+}
+
+TEST_CASE("Shallow clone", "[document]")
+{
+    // Create a base document with a custom definition, two graphs, and a
+    // material with its shader.
+    mx::DocumentPtr base = mx::createDocument();
+    base->setColorSpace("lin_rec709");
+    mx::NodeDefPtr nodeDef = base->addNodeDef("ND_custom", "float", "custom");
+    nodeDef->setInputValue("in", 0.0f);
+    mx::NodeGraphPtr graph1 = base->addNodeGraph("graph1");
+    mx::NodePtr node1 = graph1->addNode("custom", "node1", "float");
+    node1->setInputValue("in", 1.0f);
+    mx::NodeGraphPtr graph2 = base->addNodeGraph("graph2");
+    graph2->addNode("custom", "node2", "float");
+    mx::NodeDefPtr shaderDef = base->addNodeDef("ND_shader", mx::SURFACE_SHADER_TYPE_STRING, "shader");
+    shaderDef->setInputValue("in", 0.0f);
+    mx::NodePtr shader = base->addNode("shader", "SR_1", mx::SURFACE_SHADER_TYPE_STRING);
+    shader->setInputValue("in", 0.5f);
+    mx::NodePtr material = base->addMaterialNode("M_1", shader);
+
+    // Only frozen documents may be cloned.
+    REQUIRE_THROWS_AS(base->createShallowClone(), mx::Exception);
+    base->freeze();
+
+    // The clone shares the content of the base document.
+    mx::DocumentPtr clone = base->createShallowClone();
+    REQUIRE(clone->getColorSpace() == "lin_rec709");
+    REQUIRE(clone->getChildren() == base->getChildren());
+    REQUIRE(clone->getNodeGraph("graph1") == graph1);
+    REQUIRE(clone->getNodeGraphs().size() == 2);
+    REQUIRE(clone->getNodeDef("ND_custom") == nodeDef);
+    REQUIRE(clone->getMatchingPorts("SR_1").size() == 1);
+
+    // Shared elements belong to the frozen base, and cannot be edited in place.
+    REQUIRE(clone->getNodeGraph("graph2")->getDocument() == base);
+    REQUIRE_THROWS_AS(clone->getNodeGraph("graph2")->addNode("custom"), mx::Exception);
+    REQUIRE(graph2->getNodes().size() == 1);
+
+    // Editing a descendant copies only its top-level ancestor, in place.
+    mx::InputPtr input = clone->getEditableDescendant("graph1/node1/in")->asA<mx::Input>();
+    REQUIRE(input);
+    REQUIRE(input->getDocument() == clone);
+    input->setValue(2.0f);
+    REQUIRE(node1->getInputValue("in")->asA<float>() == 1.0f);
+    REQUIRE(clone->getNodeGraph("graph1") != graph1);
+    REQUIRE(clone->getNodeGraph("graph2") == graph2);
+    REQUIRE(clone->getNodeGraphs().size() == 2);
+    REQUIRE(clone->getChildIndex("graph1") == base->getChildIndex("graph1"));
+    REQUIRE(clone->getDescendant("graph1/node1/in") == input);
+    REQUIRE(clone->getEditableDescendant("graph1/node1/in") == input);
+    REQUIRE(clone->getEditableDescendant("graph1/missing") == nullptr);
+    REQUIRE(clone->getEditableDescendant("missing") == nullptr);
+
+    // Edited copies resolve definitions within the clone.
+    mx::NodePtr cloneNode = clone->getNodeGraph("graph1")->getNode("node1");
+    REQUIRE(cloneNode->getNodeDef() == nodeDef);
+
+    // Editing a shader copies the material connected to it, so that the
+    // override is visible downstream.
+    mx::NodePtr cloneShader = clone->getEditableChild("SR_1")->asA<mx::Node>();
+    cloneShader->setInputValue("in", 3.0f);
+    mx::NodePtr cloneMaterial = clone->getNode("M_1");
+    REQUIRE(cloneMaterial != material);
+    REQUIRE(cloneMaterial->getDocument() == clone);
+    REQUIRE(mx::getShaderNodes(cloneMaterial) == std::vector<mx::NodePtr>{ cloneShader });
+    REQUIRE(mx::getShaderNodes(material) == std::vector<mx::NodePtr>{ shader });
+    REQUIRE(clone->getMatchingPorts("SR_1").size() == 1);
+    REQUIRE(clone->getNodeDef("ND_custom") == nodeDef);
+
+    // The clone traverses, validates and serializes its full content.
+    size_t baseCount = 0;
+    for (mx::ElementPtr elem : base->traverseTree())
+    {
+        baseCount++;
+    }
+    size_t cloneCount = 0;
+    for (mx::ElementPtr elem : clone->traverseTree())
+    {
+        cloneCount++;
+    }
+    REQUIRE(cloneCount == baseCount);
+    REQUIRE(clone->validate());
+    REQUIRE(clone->getChildren().size() == base->getChildren().size());
+    mx::DocumentPtr written = mx::createDocument();
+    mx::readFromXmlString(written, mx::writeToXmlString(clone));
+    REQUIRE(written->getChildren().size() == base->getChildren().size());
+    REQUIRE(written->getNodeGraph("graph1")->getNode("node1")->getInputValue("in")->asA<float>() == 2.0f);
+    REQUIRE(written->getNode("SR_1")->getInputValue("in")->asA<float>() == 3.0f);
+
+    // Clones of the same base are independent.
+    mx::DocumentPtr clone2 = base->createShallowClone();
+    REQUIRE(clone2->getNodeGraph("graph1") == graph1);
+    REQUIRE(clone2->getNode("M_1") == material);
+    clone2->getEditableDescendant("graph2/node2")->asA<mx::Node>()->setInputValue("in", 4.0f);
+
+    // Clones sharing elements may be hashed concurrently, and match their
+    // deep copies.
+    std::vector<mx::DocumentPtr> clones = { clone, clone2 };
+    std::vector<size_t> expectedHashes = { clone->copy()->getContentHash(), clone2->copy()->getContentHash() };
+    REQUIRE(expectedHashes[0] != expectedHashes[1]);
+    std::vector<size_t> hashes(8, 0);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < hashes.size(); i++)
+    {
+        threads.emplace_back([&clones, &hashes, i]()
+        {
+            hashes[i] = clones[i % 2]->getContentHash();
+        });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    for (size_t i = 0; i < hashes.size(); i++)
+    {
+        REQUIRE(hashes[i] == expectedHashes[i % 2]);
+    }
+    REQUIRE(clone->getContentHash() == expectedHashes[0]);
+}
+
+#ifdef MATERIALX_BUILD_BENCHMARK_TESTS
+TEST_CASE("Document cache performance", "[document]")
+{
+    // Create a large document of chained nodes.
+    const int NODE_COUNT = 10000;
+    const int EDIT_COUNT = 100;
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph();
+    mx::NodePtr prevNode = nodeGraph->addNode("constant", "node0", "float");
+    for (int i = 1; i < NODE_COUNT; i++)
+    {
+        mx::NodePtr node = nodeGraph->addNode("add", "node" + std::to_string(i), "float");
+        node->addInput("in1", "float")->setConnectedNode(prevNode);
+        node->setInputValue("in2", 1.0f);
+        prevNode = node;
+    }
+
+    BENCHMARK("Edit inputs and query downstream ports")
+    {
+        size_t portCount = 0;
+        for (int i = 1; i <= EDIT_COUNT; i++)
+        {
+            mx::NodePtr node = nodeGraph->getNode("node" + std::to_string(i));
+            node->setInputValue("in2", (float) i);
+            node->getInput("in1")->setConnectedNode(nodeGraph->getNode("node0"));
+            portCount += node->getDownstreamPorts().size();
+        }
+        return portCount;
+    };
+}
+
+TEST_CASE("Document lookup concurrency", "[document]")
+{
+    // Load the standard libraries, and instantiate a node for each nodedef.
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, mx::getDefaultDataSearchPath(), doc);
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph();
+    std::vector<mx::NodePtr> nodes;
+    for (mx::NodeDefPtr nodeDef : doc->getNodeDefs())
+    {
+        nodes.push_back(nodeGraph->addNode(nodeDef->getNodeString(), mx::EMPTY_STRING, nodeDef->getType()));
+    }
+    doc->freeze();
+
+    // Resolve nodedefs for all nodes from an increasing number of threads.
+    const unsigned int maxThreadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    for (unsigned int threadCount = 1; threadCount <= maxThreadCount; threadCount *= 2)
+    {
+        BENCHMARK("Resolve nodedefs on " + std::to_string(threadCount) + " threads")
+        {
+            std::vector<std::thread> threads;
+            std::vector<size_t> resolvedCounts(threadCount, 0);
+            for (unsigned int i = 0; i < threadCount; i++)
+            {
+                threads.emplace_back([&nodes, &resolvedCounts, i]()
+                {
+                    for (mx::NodePtr node : nodes)
+                    {
+                        resolvedCounts[i] += node->getNodeDef() ? 1 : 0;
+                    }
+                });
+            }
+            for (std::thread& thread : threads)
+            {
+                thread.join();
+            }
+            return resolvedCounts[0];
+        };
+    }
+}
+
+TEST_CASE("Layered data library performance", "[document]")
+{
+    // Load the standard libraries once, as a shared layer.
+    mx::DocumentPtr library = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, mx::getDefaultDataSearchPath(), library);
+    library->freeze();
+
+    // Load an asset many times against the shared layer.
+    const int ASSET_COUNT = 1000;
+    mx::FilePath assetPath = mx::getDefaultDataSearchPath().find("resources/Materials/Examples/StandardSurface/standard_surface_brass_tiled.mtlx");
+    BENCHMARK("Load assets against a shared library layer")
+    {
+        std::vector<mx::DocumentPtr> assets;
+        for (int i = 0; i < ASSET_COUNT; i++)
+        {
+            mx::DocumentPtr asset = mx::createDocument();
+            asset->setDataLibrary(library);
+            mx::readFromXmlFile(asset, assetPath);
+            assets.push_back(asset);
+        }
+        return assets.size();
+    };
+}
+
+TEST_CASE("Parallel validation performance", "[document]")
+{
+    // Load the standard libraries as a single document.
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, mx::getDefaultDataSearchPath(), doc);
+    doc->freeze();
+
+    // Validate the document on an increasing number of workers.
+    const unsigned int maxWorkerCount = std::max(std::thread::hardware_concurrency(), 1u);
+    for (unsigned int workerCount = 1; workerCount <= maxWorkerCount; workerCount *= 2)
+    {
+        mx::ValidationOptions options;
+        options.workerCount = workerCount;
+        BENCHMARK("Validate on " + std::to_string(workerCount) + " workers")
+        {
+            return doc->validate(options);
+        };
+    }
+}
+
+TEST_CASE("Shallow clone performance", "[document]")
+{
+    // Create a base document of 20,000 elements across many graphs.
+    const int GRAPH_COUNT = 100;
+    const int NODE_COUNT = 100;
+    const int OVERRIDE_COUNT = 10;
+    mx::DocumentPtr base = mx::createDocument();
+    for (int i = 0; i < GRAPH_COUNT; i++)
+    {
+        mx::NodeGraphPtr graph = base->addNodeGraph("graph" + std::to_string(i));
+        for (int j = 0; j < NODE_COUNT; j++)
+        {
+            graph->addNode("constant", "node" + std::to_string(j), "float")->setInputValue("value", 0.0f);
+        }
+    }
+    base->freeze();
+
+    // Apply overrides to a deep copy and to a shallow clone.
+    for (bool shallow : { false, true })
+    {
+        BENCHMARK(shallow ? "Apply overrides to a shallow clone" : "Apply overrides to a deep copy")
+        {
+            mx::DocumentPtr variant = shallow ? base->createShallowClone() : base->copy();
+            for (int i = 0; i < OVERRIDE_COUNT; i++)
+            {
+                std::string path = "graph" + std::to_string(i * GRAPH_COUNT / OVERRIDE_COUNT) + "/node0/value";
+                mx::ElementPtr elem = shallow ? variant->getEditableDescendant(path) : variant->getDescendant(path);
+                elem->asA<mx::Input>()->setValue((float) i);
+            }
+            return variant;
+        };
+    }
+}
+#endif
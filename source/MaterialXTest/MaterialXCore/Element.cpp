@@ -40,6 +40,18 @@ TEST_CASE("Element", "[element]")
     REQUIRE(elem1->getTypedAttribute<bool>("customColor") == false);
     REQUIRE(elem1->getTypedAttribute<mx::Color3>("customFlag") == mx::Color3(0.0f));
 
+    // Modify and remove attributes, and verify that attribute order is maintained.
+    elem1->setAttribute("customString", "value1");
+    elem1->setTypedAttribute<bool>("customFlag", false);
+    REQUIRE(elem1->getAttributeNames() == mx::StringVec{ "customFlag", "customColor", "customString" });
+    REQUIRE(elem1->getAttribute("customFlag") == "false");
+    elem1->removeAttribute("customColor");
+    REQUIRE(elem1->getAttributeNames() == mx::StringVec{ "customFlag", "customString" });
+    REQUIRE(!elem1->hasAttribute("customColor"));
+    REQUIRE(elem1->getAttribute("customString") == "value1");
+    elem1->removeAttribute("customString");
+    elem1->setTypedAttribute<mx::Color3>("customColor", mx::Color3(1.0f));
+
     // Modify element names.
     elem1->setName("elem1");
     elem2->setName("elem2");
@@ -69,3 +81,90 @@ TEST_CASE("Element", "[element]")
     }
     REQUIRE_THROWS_AS(orphan->getDocument(), mx::ExceptionOrphanedElement);
 }
+
+#ifdef MATERIALX_BUILD_BENCHMARK_TESTS
+TEST_CASE("Element attribute performance", "[element]")
+{
+    // Create a large document of typed nodes with connected inputs.
+    const int NODE_COUNT = 10000;
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph();
+    for (int i = 0; i < NODE_COUNT; i++)
+    {
+        mx::NodePtr node = nodeGraph->addNode("add", "node" + std::to_string(i), "float");
+        node->setInputValue("in1", 1.0f);
+        node->setInputValue("in2", 2.0f);
+    }
+
+    BENCHMARK("Query attributes")
+    {
+        size_t attrCount = 0;
+        for (mx::ElementPtr elem : doc->traverseTree())
+        {
+            attrCount += elem->hasAttribute(mx::TypedElement::TYPE_ATTRIBUTE) ? 1 : 0;
+            attrCount += elem->getAttribute(mx::ValueElement::VALUE_ATTRIBUTE).size();
+        }
+        return attrCount;
+    };
+
+    BENCHMARK("Copy document")
+    {
+        return doc->copy();
+    };
+
+    BENCHMARK("Query values")
+    {
+        float sum = 0.0f;
+        for (mx::NodePtr node : nodeGraph->getNodes())
+        {
+            sum += node->getInputValue("in1")->asA<float>();
+            sum += node->getInputValue("in2")->asA<float>();
+        }
+        return sum;
+    };
+}
+#endif
+
+TEST_CASE("Element value cache", "[element]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph();
+    mx::NodePtr node = nodeGraph->addNode("constant", "node1", "color3");
+    mx::InputPtr input = node->setInputValue("value", mx::Color3(0.1f, 0.2f, 0.3f));
+
+    // Each query returns an independent copy of the parsed value.
+    mx::ValuePtr value = input->getValue();
+    REQUIRE(value->asA<mx::Color3>() == mx::Color3(0.1f, 0.2f, 0.3f));
+    REQUIRE(input->getValue() != value);
+    REQUIRE(input->getResolvedValue() != value);
+    REQUIRE(input->getValue()->asA<mx::Color3>() == mx::Color3(0.1f, 0.2f, 0.3f));
+
+    // Modifying a returned value does not affect the element.
+    std::static_pointer_cast<mx::TypedValue<mx::Color3>>(value)->setData(mx::Color3(1.0f));
+    REQUIRE(input->getValue()->asA<mx::Color3>() == mx::Color3(0.1f, 0.2f, 0.3f));
+    REQUIRE(input->getValueString() == "0.1, 0.2, 0.3");
+
+    // Edits to the value or type invalidate the cached value.
+    input->setValueString("0.4, 0.5, 0.6");
+    REQUIRE(input->getValue()->asA<mx::Color3>() == mx::Color3(0.4f, 0.5f, 0.6f));
+    input->setType("vector3");
+    REQUIRE(input->getValue()->asA<mx::Vector3>() == mx::Vector3(0.4f, 0.5f, 0.6f));
+    input->setValue(2.0f);
+    REQUIRE(input->getValue()->asA<float>() == 2.0f);
+    input->removeAttribute(mx::ValueElement::VALUE_ATTRIBUTE);
+    REQUIRE(!input->getValue());
+
+    // Copied content replaces the cached value.
+    mx::NodePtr node2 = nodeGraph->addNode("constant", "node2", "float");
+    mx::InputPtr input2 = node2->setInputValue("value", 3.0f);
+    REQUIRE(input2->getValue()->asA<float>() == 3.0f);
+    input2->copyContentFrom(node->setInputValue("value", 4.0f));
+    REQUIRE(input2->getValue()->asA<float>() == 4.0f);
+
+    // Filename values are resolved in the context of each query.
+    mx::NodePtr image = nodeGraph->addNode("image", "image1");
+    mx::InputPtr file = image->setInputValue("file", "image.png", mx::FILENAME_TYPE_STRING);
+    nodeGraph->setFilePrefix("folder/");
+    REQUIRE(file->getValue()->asA<std::string>() == "image.png");
+    REQUIRE(file->getResolvedValue()->asA<std::string>() == "folder/image.png");
+}
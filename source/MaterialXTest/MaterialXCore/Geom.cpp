@@ -68,6 +68,24 @@ TEST_CASE("Geom elements", "[geom]")
     REQUIRE(fileInput->getResolvedValue(resolver1)->asA<std::string>() == "folder/robot01_diffuse_1001.tif");
     REQUIRE(fileInput->getResolvedValue(resolver2)->asA<std::string>() == "folder/robot02_diffuse_1002.tif");
 
+    // Test batch filename resolution.
+    std::vector<std::pair<mx::ValueElementPtr, std::string>> resolved = mx::resolveFilenames(doc, "/robot2");
+    REQUIRE(resolved.size() == 1);
+    REQUIRE(resolved[0].first == fileInput);
+    REQUIRE(resolved[0].second == "folder/robot02_diffuse_<UDIM>.tif");
+
+    // Test overlapping and chained substitutions, which are applied in a
+    // single pass with the longest key taking precedence.
+    mx::StringResolverPtr resolver3 = mx::StringResolver::create();
+    resolver3->setFilenameSubstitution("ab", "2");
+    resolver3->setFilenameSubstitution("abc", "1");
+    resolver3->setFilenameSubstitution("d", "e");
+    resolver3->setFilenameSubstitution("e", "f");
+    REQUIRE(resolver3->resolve("abcd_abd_e", mx::FILENAME_TYPE_STRING) == "1e_2e_f");
+    resolver3->setGeomNameSubstitution("a", "b");
+    resolver3->setGeomNameSubstitution("b", "c");
+    REQUIRE(resolver3->resolve("ab", mx::GEOMNAME_TYPE_STRING) == "bc");
+
     // Create a geominfo with an attribute.
     mx::GeomInfoPtr geominfo4 = doc->addGeomInfo("geominfo4", "/robot1");
     mx::StringVec udimSet = {"1001", "1002", "1003", "1004"};
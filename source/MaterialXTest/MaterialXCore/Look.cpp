@@ -5,7 +5,7 @@
 
 #include <MaterialXTest/External/Catch/catch.hpp>
 
-#include <MaterialXCore/Document.h>
+#include <MaterialXCore/GeomBinding.h>
 
 namespace mx = MaterialX;
 
@@ -121,3 +121,191 @@ TEST_CASE("LookGroup", "[look]")
     lookGroups = doc->getLookGroups();
     REQUIRE(lookGroups.size() == 0);
 }
+
+namespace
+{
+
+// Return the material assignments that match the given geometry, using
+// brute-force evaluation of geometry strings and collections.
+std::vector<mx::MaterialAssignPtr> getMatchingMaterialAssigns(mx::DocumentPtr doc, const std::string& geom)
+{
+    std::vector<mx::MaterialAssignPtr> matAssigns;
+    for (mx::LookPtr look : doc->getLooks())
+    {
+        for (mx::MaterialAssignPtr matAssign : look->getMaterialAssigns())
+        {
+            mx::CollectionPtr collection = matAssign->getCollection();
+            if (mx::geomStringsMatch(matAssign->getActiveGeom(), geom, true) ||
+                (collection && collection->matchesGeomString(geom)))
+            {
+                matAssigns.push_back(matAssign);
+            }
+        }
+    }
+    return matAssigns;
+}
+
+} // anonymous namespace
+
+TEST_CASE("Geometry binding resolver", "[look]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::NodePtr shaderNode = doc->addNode("standard_surface", "", mx::SURFACE_SHADER_TYPE_STRING);
+    mx::NodePtr materialNode = doc->addMaterialNode("", shaderNode);
+
+    // Create a chain of nested collections with includes and excludes.
+    mx::CollectionPtr arms = doc->addCollection("arms");
+    arms->setIncludeGeom("/robot1/left_arm, /robot2/left_arm, /robot2/right_arm");
+    arms->setExcludeGeom("/robot2/right_arm/hand");
+    mx::CollectionPtr legs = doc->addCollection("legs");
+    legs->setGeomPrefix("/robot1");
+    legs->setIncludeGeom("/left_leg,/right_leg");
+    legs->setIncludeCollection(arms);
+    mx::CollectionPtr limbs = doc->addCollection("limbs");
+    limbs->setIncludeCollection(legs);
+    limbs->setExcludeGeom("/robot1/right_leg/foot");
+    mx::CollectionPtr everything = doc->addCollection("everything");
+    everything->setIncludeGeom("/");
+    everything->setExcludeGeom("/robot3");
+
+    // Assign materials, properties, and visibilities in two looks.
+    mx::LookPtr look1 = doc->addLook("look1");
+    look1->addMaterialAssign("", materialNode->getName())->setGeom("/robot1");
+    look1->addMaterialAssign("", materialNode->getName())->setCollection(limbs);
+    look1->addMaterialAssign("", materialNode->getName())->setGeom("/robot2/torso,/robot3/head");
+    mx::MaterialAssignPtr prefixAssign = look1->addMaterialAssign("", materialNode->getName());
+    prefixAssign->setGeomPrefix("/robot2");
+    prefixAssign->setGeom("/right_arm");
+    prefixAssign->addVariantAssign("damage");
+    mx::LookPtr look2 = doc->addLook("look2");
+    look2->setInheritsFrom(look1);
+    look2->addMaterialAssign("", materialNode->getName())->setCollection(everything);
+    look2->addMaterialAssign("", materialNode->getName())->setGeom("/");
+    mx::PropertyAssignPtr propertyAssign = look2->addPropertyAssign();
+    propertyAssign->setGeom("/robot2");
+    mx::PropertySetAssignPtr propertySetAssign = look2->addPropertySetAssign();
+    propertySetAssign->setCollection(arms);
+    mx::VisibilityPtr visibility = look2->addVisibility();
+    visibility->setGeom("/robot1/left_leg");
+
+    // Verify that the resolver agrees with brute-force evaluation.
+    mx::GeomBindingResolverPtr resolver = mx::GeomBindingResolver::create(doc);
+    mx::StringVec geoms;
+    for (const std::string& robot : mx::StringVec{ "", "/robot1", "/robot2", "/robot3", "/robot4" })
+    {
+        for (const std::string& part : mx::StringVec{ "", "/left_arm", "/right_arm", "/left_leg", "/right_leg", "/torso", "/head" })
+        {
+            for (const std::string& child : mx::StringVec{ "", "/hand", "/foot", "/hand/finger" })
+            {
+                geoms.push_back(robot + part + child);
+            }
+        }
+    }
+    geoms.push_back("/");
+    geoms.push_back("//robot1//left_arm/");
+    geoms.push_back("/robot2/torso/nested,/robot3/head");
+    std::vector<mx::GeomBindings> batch = resolver->resolve(geoms);
+    REQUIRE(batch.size() == geoms.size());
+    for (size_t i = 0; i < geoms.size(); i++)
+    {
+        const std::string& geom = geoms[i];
+        INFO(geom);
+        mx::GeomBindings bindings = resolver->resolve(geom);
+        REQUIRE(bindings.materialAssigns == getMatchingMaterialAssigns(doc, geom));
+        REQUIRE(batch[i].materialAssigns == bindings.materialAssigns);
+        REQUIRE((bindings.propertyAssigns.size() == 1) == mx::geomStringsMatch(propertyAssign->getGeom(), geom, true));
+        REQUIRE((bindings.propertySetAssigns.size() == 1) == arms->matchesGeomString(geom));
+        REQUIRE((bindings.visibilities.size() == 1) == mx::geomStringsMatch(visibility->getGeom(), geom, true));
+        bool prefixMatch = std::find(bindings.materialAssigns.begin(), bindings.materialAssigns.end(), prefixAssign) != bindings.materialAssigns.end();
+        REQUIRE(bindings.variantAssigns.size() == (prefixMatch ? 1 : 0));
+    }
+    REQUIRE(resolver->resolve("").materialAssigns.empty());
+
+    // Restrict the resolver to the active assignments of a single look.
+    mx::GeomBindingResolverPtr lookResolver = mx::GeomBindingResolver::create(doc, look1);
+    REQUIRE(lookResolver->resolve("/robot1/left_arm").materialAssigns.size() == 2);
+    REQUIRE(lookResolver->resolve("/robot1/left_arm").propertySetAssigns.empty());
+    REQUIRE(lookResolver->resolve("/robot2/right_arm").materialAssigns.size() == 2);
+    REQUIRE(lookResolver->resolve("/robot2/right_arm/hand").materialAssigns.size() == 1);
+    REQUIRE(mx::GeomBindingResolver::create(doc, look2)->resolve("/robot1/right_leg/foot").materialAssigns.size() == 3);
+
+    // Collections that are included along more than one path are supported.
+    limbs->setIncludeCollections({ legs, arms });
+    resolver = mx::GeomBindingResolver::create(doc);
+    REQUIRE(resolver->resolve("/robot2/left_arm").materialAssigns.size() == 3);
+
+    // Cycles in the include chain of a collection are detected.
+    arms->setIncludeCollection(limbs);
+    REQUIRE_THROWS_AS(mx::GeomBindingResolver::create(doc), mx::ExceptionFoundCycle);
+}
+
+#ifdef MATERIALX_BUILD_BENCHMARK_TESTS
+namespace
+{
+
+// Create a look with material assignments to a synthetic geometry hierarchy,
+// and return the paths of its leaf geometry.
+mx::StringVec createGeometryBindings(mx::DocumentPtr doc, size_t branchCount, size_t depth)
+{
+    mx::StringVec paths = { "" };
+    for (size_t level = 0; level < depth; level++)
+    {
+        mx::StringVec children;
+        for (const std::string& path : paths)
+        {
+            for (size_t i = 0; i < branchCount; i++)
+            {
+                children.push_back(path + "/node" + std::to_string(i));
+            }
+        }
+        paths = children;
+    }
+
+    mx::NodePtr shaderNode = doc->addNode("standard_surface", "", mx::SURFACE_SHADER_TYPE_STRING);
+    mx::NodePtr materialNode = doc->addMaterialNode("", shaderNode);
+    mx::LookPtr look = doc->addLook();
+    for (size_t i = 0; i < paths.size(); i += 7)
+    {
+        mx::MaterialAssignPtr matAssign = look->addMaterialAssign("", materialNode->getName());
+        matAssign->setGeom(paths[i]);
+    }
+    for (size_t i = 0; i < branchCount; i++)
+    {
+        mx::CollectionPtr collection = doc->addCollection();
+        collection->setIncludeGeom("/node" + std::to_string(i));
+        collection->setExcludeGeom("/node" + std::to_string(i) + "/node0");
+        mx::MaterialAssignPtr matAssign = look->addMaterialAssign("", materialNode->getName());
+        matAssign->setCollection(collection);
+    }
+    return paths;
+}
+
+} // anonymous namespace
+
+TEST_CASE("Geometry binding resolver performance", "[look]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::StringVec paths = createGeometryBindings(doc, 8, 4);
+
+    // Compare brute-force evaluation with a compiled resolver.
+    BENCHMARK("Resolve bindings with geometry strings")
+    {
+        size_t count = 0;
+        for (size_t i = 0; i < paths.size(); i += 16)
+        {
+            count += getMatchingMaterialAssigns(doc, paths[i]).size();
+        }
+        return count;
+    };
+    BENCHMARK("Resolve bindings with resolver")
+    {
+        mx::GeomBindingResolverPtr resolver = mx::GeomBindingResolver::create(doc);
+        size_t count = 0;
+        for (size_t i = 0; i < paths.size(); i += 16)
+        {
+            count += resolver->resolve(paths[i]).materialAssigns.size();
+        }
+        return count;
+    };
+}
+#endif
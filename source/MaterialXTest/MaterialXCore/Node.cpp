@@ -32,6 +32,38 @@ bool isTopologicalOrder(const std::vector<mx::ElementPtr>& elems)
     return true;
 }
 
+// Create a document containing a chain of instances of a graph-defined node.
+mx::DocumentPtr createInstancedGraph(size_t instanceCount)
+{
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::NodeDefPtr nodeDef = doc->addNodeDef("ND_scaleoffset_float", "float", "scaleoffset");
+    nodeDef->setInputValue("in", 0.0f);
+    nodeDef->setInputValue("scale", 2.0f);
+    mx::NodeGraphPtr implGraph = doc->addNodeGraph("NG_scaleoffset_float");
+    implGraph->setNodeDef(nodeDef);
+    mx::NodePtr multiply = implGraph->addNode("multiply", "multiply1", "float");
+    multiply->addInput("in1", "float")->setInterfaceName("in");
+    multiply->addInput("in2", "float")->setInterfaceName("scale");
+    mx::NodePtr add = implGraph->addNode("add", "add1", "float");
+    add->addInput("in1", "float")->setConnectedNode(multiply);
+    add->setInputValue("in2", 1.0f);
+    implGraph->addOutput("out", "float")->setConnectedNode(add);
+
+    mx::NodeGraphPtr graph = doc->addNodeGraph("graph");
+    mx::NodePtr prevNode;
+    for (size_t i = 0; i < instanceCount; i++)
+    {
+        mx::NodePtr node = graph->addNode("scaleoffset", "scaleoffset" + std::to_string(i + 1), "float");
+        if (prevNode)
+        {
+            node->addInput("in", "float")->setConnectedNode(prevNode);
+        }
+        prevNode = node;
+    }
+    graph->addOutput("out", "float")->setConnectedNode(prevNode);
+    return doc;
+}
+
 TEST_CASE("Interface Input Validation", "[node]")
 {
     std::string validationErrors;
@@ -117,6 +149,24 @@ TEST_CASE("Node", "[node]")
     REQUIRE(constant->getDownstreamPorts()[0] == output1);
     REQUIRE(image->getDownstreamPorts()[0] == output2);
 
+    // Upstream edges follow the order of node inputs as they are edited.
+    mx::NodePtr mix = doc->addNode("mix", "mix1", "color3");
+    mix->addInput("fg", "color3")->setConnectedNode(constant);
+    mix->addInput("bg", "color3")->setConnectedNode(image);
+    REQUIRE(mix->getUpstreamEdgeCount() == 2);
+    REQUIRE(mix->getUpstreamElement(0) == constant);
+    REQUIRE(mix->getUpstreamElement(1) == image);
+    mix->setChildIndex("bg", 0);
+    REQUIRE(mix->getUpstreamElement(0) == image);
+    REQUIRE(mix->getUpstreamElement(1) == constant);
+    mix->removeInput("bg");
+    REQUIRE(mix->getUpstreamEdgeCount() == 1);
+    REQUIRE(mix->getUpstreamElement(0) == constant);
+    mix->clearContent();
+    REQUIRE(mix->getUpstreamEdgeCount() == 0);
+    REQUIRE(mix->getUpstreamElement(0) == nullptr);
+    doc->removeNode(mix->getName());
+
     // Create a custom nodedef.
     mx::NodeDefPtr customNodeDef = doc->addNodeDef("ND_turbulence3d", "float", "turbulence3d");
     customNodeDef->setNodeGroup(mx::NodeDef::PROCEDURAL_NODE_GROUP);
@@ -205,6 +255,66 @@ TEST_CASE("Node inputCount repro", "[node]")
     CHECK(doc->validate());
 }
 
+TEST_CASE("Node definition memoization", "[node]")
+{
+    mx::DocumentPtr library = mx::createDocument();
+    mx::NodeDefPtr floatNodeDef = library->addNodeDef("ND_blend_float", "float", "blend");
+    floatNodeDef->addInput("amount", "float");
+    mx::NodeDefPtr colorNodeDef = library->addNodeDef("ND_blend_color3", "color3", "blend");
+    colorNodeDef->addInput("amount", "float");
+
+    mx::DocumentPtr doc = mx::createDocument();
+    doc->setDataLibrary(library);
+    mx::NodePtr floatNode = doc->addNode("blend", "floatNode", "float");
+    mx::NodePtr colorNode = doc->addNode("blend", "colorNode", "color3");
+    REQUIRE(floatNode->getNodeDef() == floatNodeDef);
+    REQUIRE(colorNode->getNodeDef() == colorNodeDef);
+
+    // Edits to the node signature are reflected in its resolved nodedef.
+    floatNode->setInputValue("amount", 0.5f);
+    REQUIRE(floatNode->getNodeDef() == floatNodeDef);
+    floatNode->getInput("amount")->setType("integer");
+    REQUIRE(floatNode->getNodeDef() == nullptr);
+    REQUIRE(floatNode->getNodeDef(mx::EMPTY_STRING, true) == floatNodeDef);
+    floatNode->getInput("amount")->setType("float");
+    REQUIRE(floatNode->getNodeDef() == floatNodeDef);
+
+    // Edits to the data library invalidate memoized nodedefs.
+    floatNodeDef->getInput("amount")->setName("weight");
+    REQUIRE(floatNode->getNodeDef() == nullptr);
+    floatNodeDef->getInput("weight")->setName("amount");
+    REQUIRE(floatNode->getNodeDef() == floatNodeDef);
+    floatNodeDef->setTarget("genglsl");
+    REQUIRE(floatNode->getNodeDef("genosl") == nullptr);
+    REQUIRE(floatNode->getNodeDef("genglsl") == floatNodeDef);
+    library->removeNodeDef(floatNodeDef->getName());
+    REQUIRE(floatNode->getNodeDef("genglsl") == nullptr);
+    REQUIRE(colorNode->getNodeDef() == colorNodeDef);
+
+    // Edits to the definitions of the document invalidate memoized nodedefs.
+    mx::NodeDefPtr localNodeDef = doc->addNodeDef("ND_blend_float", "float", "blend");
+    REQUIRE(floatNode->getNodeDef() == nullptr);
+    localNodeDef->addInput("amount", "float");
+    REQUIRE(floatNode->getNodeDef() == localNodeDef);
+    localNodeDef->setNamespace("custom");
+    REQUIRE(floatNode->getNodeDef() == nullptr);
+    floatNode->setNamespace("custom");
+    REQUIRE(floatNode->getNodeDef() == localNodeDef);
+
+    // Replacing the data library invalidates memoized nodedefs.
+    REQUIRE(colorNode->getNodeDef() == colorNodeDef);
+    doc->setDataLibrary(mx::createDocument());
+    REQUIRE(colorNode->getNodeDef() == nullptr);
+    doc->setDataLibrary(library);
+    REQUIRE(colorNode->getNodeDef() == colorNodeDef);
+
+    // Frozen documents return memoized nodedefs.
+    doc->freeze();
+    REQUIRE(colorNode->getNodeDef() == colorNodeDef);
+    REQUIRE(floatNode->getNodeDef() == localNodeDef);
+    doc->unfreeze();
+}
+
 TEST_CASE("Flatten", "[nodegraph]")
 {
     // Read an example containing graph-based custom nodes.
@@ -242,6 +352,42 @@ TEST_CASE("Flatten", "[nodegraph]")
     REQUIRE(newRootNodes == expectedRootNodes);
 }
 
+TEST_CASE("Flatten instances", "[nodegraph]")
+{
+    const size_t INSTANCE_COUNT = 50;
+    mx::DocumentPtr doc = createInstancedGraph(INSTANCE_COUNT);
+    mx::NodeGraphPtr graph = doc->getNodeGraph("graph");
+    REQUIRE(doc->validate());
+
+    // Flatten the chain of instances.
+    graph->flattenSubgraphs();
+    REQUIRE(doc->validate());
+    std::vector<mx::NodePtr> nodes = graph->getNodes();
+    REQUIRE(nodes.size() == 2 * INSTANCE_COUNT);
+
+    // Each instance is replaced in place by its subnodes, with unique names,
+    // internal connections, and interface bindings.
+    std::set<std::string> names;
+    for (size_t i = 0; i < INSTANCE_COUNT; i++)
+    {
+        mx::NodePtr multiply = nodes[2 * i];
+        mx::NodePtr add = nodes[2 * i + 1];
+        names.insert(multiply->getName());
+        names.insert(add->getName());
+        REQUIRE(multiply->getCategory() == "multiply");
+        REQUIRE(add->getCategory() == "add");
+        REQUIRE(add->getConnectedNode("in1") == multiply);
+        REQUIRE(multiply->getInputValue("in2")->asA<float>() == 2.0f);
+        REQUIRE(!multiply->getInput("in1")->hasInterfaceName());
+        if (i > 0)
+        {
+            REQUIRE(multiply->getConnectedNode("in1") == nodes[2 * i - 1]);
+        }
+    }
+    REQUIRE(names.size() == nodes.size());
+    REQUIRE(graph->getOutput("out")->getConnectedNode() == nodes.back());
+}
+
 TEST_CASE("Inheritance", "[nodedef]")
 {
     mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
@@ -777,3 +923,17 @@ TEST_CASE("Node Definition Creation", "[nodedef]")
     
     REQUIRE(doc->validate());
 }
+
+#ifdef MATERIALX_BUILD_BENCHMARK_TESTS
+TEST_CASE("Flatten performance", "[nodegraph]")
+{
+    const size_t INSTANCE_COUNT = 1000;
+    BENCHMARK("Create and flatten a graph of graph-defined nodes")
+    {
+        mx::DocumentPtr doc = createInstancedGraph(INSTANCE_COUNT);
+        mx::NodeGraphPtr graph = doc->getNodeGraph("graph");
+        graph->flattenSubgraphs();
+        return graph->getChildren().size();
+    };
+}
+#endif
@@ -191,3 +191,125 @@ TEST_CASE("InterGraph Traversal", "[traversal]")
         }
     }
 }
+
+TEST_CASE("Deep Traversal", "[traversal]")
+{
+    // Create a chain of nodes, each connected to its predecessor and to a
+    // node halfway back along the chain.
+    const size_t NODE_COUNT = 1000;
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph();
+    std::vector<mx::NodePtr> nodes;
+    nodes.push_back(nodeGraph->addNode("constant", "node0", "float"));
+    for (size_t i = 1; i < NODE_COUNT; i++)
+    {
+        mx::NodePtr node = nodeGraph->addNode("add", "node" + std::to_string(i), "float");
+        node->setConnectedNode("in1", nodes[i - 1]);
+        node->setConnectedNode("in2", nodes[i / 2]);
+        nodes.push_back(node);
+    }
+    mx::OutputPtr output = nodeGraph->addOutput("out", "float");
+    output->setConnectedNode(nodes.back());
+
+    // Each edge is visited exactly once, and the deepest path follows the
+    // full chain.
+    size_t edgeCount = 0;
+    size_t maxNodeDepth = 0;
+    for (mx::GraphIterator it = output->traverseGraph().begin(); it != mx::GraphIterator::end(); ++it)
+    {
+        edgeCount++;
+        maxNodeDepth = std::max(maxNodeDepth, it.getNodeDepth());
+    }
+    REQUIRE(edgeCount == 2 * (NODE_COUNT - 1) + 1);
+    REQUIRE(maxNodeDepth == NODE_COUNT);
+
+    // Each element of the document is visited exactly once.
+    size_t elemCount = 0;
+    for (mx::ElementPtr elem : doc->traverseTree())
+    {
+        elemCount += elem ? 1 : 0;
+    }
+    REQUIRE(elemCount == 1 + 1 + NODE_COUNT + 2 * (NODE_COUNT - 1) + 1);
+
+    // Close the chain into a cycle, which is detected at any depth.
+    nodes[0]->setConnectedNode("in", nodes.back());
+    REQUIRE(output->hasUpstreamCycle());
+
+    // Removing an ancestor of the current element during tree traversal
+    // leaves the path valid, and traversal continues within the removed
+    // subtree.
+    mx::DocumentPtr treeDoc = mx::createDocument();
+    treeDoc->addNodeGraph("graph1")->addNode("constant", "node1", "float")->setInputValue("value", 1.0f);
+    treeDoc->addNodeGraph("graph2");
+    mx::StringVec visited;
+    for (mx::ElementPtr elem : treeDoc->traverseTree())
+    {
+        if (elem == treeDoc)
+        {
+            continue;
+        }
+        visited.push_back(elem->getName());
+        if (elem->getName() == "node1")
+        {
+            treeDoc->removeNodeGraph("graph1");
+        }
+    }
+    REQUIRE(visited == mx::StringVec{ "graph1", "node1", "value" });
+}
+
+#ifdef MATERIALX_BUILD_BENCHMARK_TESTS
+TEST_CASE("Traversal performance", "[traversal]")
+{
+    // Create a graph of 10k nodes, each connected to its predecessor and to
+    // a node halfway back along the chain.
+    const int NODE_COUNT = 10000;
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph();
+    std::vector<mx::NodePtr> nodes;
+    nodes.push_back(nodeGraph->addNode("constant", "node0", "float"));
+    for (int i = 1; i < NODE_COUNT; i++)
+    {
+        mx::NodePtr node = nodeGraph->addNode("add", "node" + std::to_string(i), "float");
+        node->setConnectedNode("in1", nodes[i - 1]);
+        node->setConnectedNode("in2", nodes[i / 2]);
+        nodes.push_back(node);
+    }
+    mx::OutputPtr output = nodeGraph->addOutput("out", "float");
+    output->setConnectedNode(nodes.back());
+
+    BENCHMARK("Traverse upstream graph")
+    {
+        size_t edgeCount = 0;
+        for (mx::Edge edge : output->traverseGraph())
+        {
+            edgeCount += edge ? 1 : 0;
+        }
+        return edgeCount;
+    };
+
+    BENCHMARK("Traverse element tree")
+    {
+        size_t elemCount = 0;
+        for (mx::ElementPtr elem : doc->traverseTree())
+        {
+            elemCount += elem ? 1 : 0;
+        }
+        return elemCount;
+    };
+
+    BENCHMARK("Query downstream ports")
+    {
+        size_t portCount = 0;
+        for (mx::NodePtr node : nodes)
+        {
+            portCount += node->getDownstreamPorts().size();
+        }
+        return portCount;
+    };
+
+    BENCHMARK("Topological sort")
+    {
+        return nodeGraph->topologicalSort().size();
+    };
+}
+#endif
@@ -73,11 +73,29 @@ TEST_CASE("Value strings", "[value]")
     REQUIRE(mx::fromValueString<mx::Color3>("1, 1, 1") == mx::Color3(1.0f));
     REQUIRE(mx::fromValueString<std::string>("text") == "text");
 
+    REQUIRE(mx::fromValueString<mx::Matrix33>("1, 2, 3, 4, 5, 6, 7, 8, 9") ==
+            mx::Matrix33(1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f));
+
+    // Verify the conventions of classic-locale stream input.
+    REQUIRE(mx::fromValueString<int>("+2") == 2);
+    REQUIRE(mx::fromValueString<int>("\t-2") == -2);
+    REQUIRE(mx::fromValueString<int>("2.5") == 2);
+    REQUIRE(mx::fromValueString<float>(".5") == 0.5f);
+    REQUIRE(mx::fromValueString<float>("5e-1x") == 0.5f);
+    REQUIRE(mx::fromValueString<mx::Vector3>(",1,,2 3,") == mx::Vector3(1.0f, 2.0f, 3.0f));
+    REQUIRE(mx::fromValueString<mx::FloatVec>("1.5, 2.5") == mx::FloatVec{ 1.5f, 2.5f });
+
     // Verify that invalid conversions throw exceptions.
     REQUIRE_THROWS_AS(mx::fromValueString<int>("text"), mx::ExceptionTypeError);
     REQUIRE_THROWS_AS(mx::fromValueString<float>("text"), mx::ExceptionTypeError);
     REQUIRE_THROWS_AS(mx::fromValueString<bool>("1"), mx::ExceptionTypeError);
     REQUIRE_THROWS_AS(mx::fromValueString<mx::Color3>("1"), mx::ExceptionTypeError);
+    REQUIRE_THROWS_AS(mx::fromValueString<mx::Color3>("1, 2, 3, 4"), mx::ExceptionTypeError);
+    REQUIRE_THROWS_AS(mx::fromValueString<int>("+-2"), mx::ExceptionTypeError);
+    REQUIRE_THROWS_AS(mx::fromValueString<int>("99999999999"), mx::ExceptionTypeError);
+    REQUIRE_THROWS_AS(mx::fromValueString<float>("1e"), mx::ExceptionTypeError);
+    REQUIRE_THROWS_AS(mx::fromValueString<float>("inf"), mx::ExceptionTypeError);
+    REQUIRE_THROWS_AS(mx::fromValueString<float>("1e40"), mx::ExceptionTypeError);
 
     // Parse value strings using structure syntax features.
     REQUIRE(mx::parseStructValueString("{{1;2;3};4}") == (std::vector<std::string>{"{1;2;3}","4"}));
@@ -89,6 +107,66 @@ TEST_CASE("Value strings", "[value]")
     REQUIRE(mx::parseStructValueString("{1;2;{3};4}") == (std::vector<std::string>{"1","2","{3}","4"}));
 }
 
+#ifdef MATERIALX_BUILD_BENCHMARK_TESTS
+TEST_CASE("Value string performance", "[value]")
+{
+    BENCHMARK("Parse integer")
+    {
+        return mx::fromValueString<int>("12345");
+    };
+    BENCHMARK("Parse float")
+    {
+        return mx::fromValueString<float>("0.12345");
+    };
+    BENCHMARK("Parse color3")
+    {
+        return mx::fromValueString<mx::Color3>("0.1, 0.2, 0.3");
+    };
+    BENCHMARK("Parse vector4")
+    {
+        return mx::fromValueString<mx::Vector4>("0.1, 0.2, 0.3, 0.4");
+    };
+    BENCHMARK("Parse matrix44")
+    {
+        return mx::fromValueString<mx::Matrix44>("1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0.1, 0.2, 0.3, 1");
+    };
+    BENCHMARK("Parse floatarray")
+    {
+        return mx::fromValueString<mx::FloatVec>("0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7, 0.8");
+    };
+
+    BENCHMARK("Format integer")
+    {
+        return mx::toValueString(12345);
+    };
+    BENCHMARK("Format float")
+    {
+        return mx::toValueString(0.12345f);
+    };
+    BENCHMARK("Format color3")
+    {
+        return mx::toValueString(mx::Color3(0.1f, 0.2f, 0.3f));
+    };
+    BENCHMARK("Format vector4")
+    {
+        return mx::toValueString(mx::Vector4(0.1f, 0.2f, 0.3f, 0.4f));
+    };
+    BENCHMARK("Format matrix44")
+    {
+        return mx::toValueString(mx::Matrix44::IDENTITY);
+    };
+    BENCHMARK("Format floatarray")
+    {
+        return mx::toValueString(mx::FloatVec{ 0.1f, 0.2f, 0.3f, 0.4f, 0.5f, 0.6f, 0.7f, 0.8f });
+    };
+    BENCHMARK("Format color3 with fixed precision")
+    {
+        mx::ScopedFloatFormatting fmt(mx::Value::FloatFormatFixed, 3);
+        return mx::toValueString(mx::Color3(0.1f, 0.2f, 0.3f));
+    };
+}
+#endif
+
 TEST_CASE("Typed values", "[value]")
 {
     // Base types
@@ -0,0 +1,79 @@
+//
+// Copyright Contributors to the MaterialX Project
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <MaterialXTest/External/Catch/catch.hpp>
+
+#include <MaterialXFormat/BinaryIo.h>
+#include <MaterialXFormat/Util.h>
+
+#include <cstdio>
+
+namespace mx = MaterialX;
+
+TEST_CASE("Binary snapshot", "[binaryio]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::ElementEquivalenceOptions options;
+
+    // Round-trip the data libraries through a binary snapshot.
+    mx::DocumentPtr libs = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, libs);
+    std::string snapshot = mx::writeToBinaryString(libs);
+    mx::DocumentPtr libsCopy = mx::createDocument();
+    mx::readFromBinaryString(libsCopy, snapshot);
+    REQUIRE(libsCopy->isEquivalent(libs, options));
+    REQUIRE(*libsCopy == *libs);
+    REQUIRE(libsCopy->getNodeDefs().size() == libs->getNodeDefs().size());
+    REQUIRE(libsCopy->getNodeDef("ND_standard_surface_surfaceshader")->getSourceUri() ==
+            libs->getNodeDef("ND_standard_surface_surfaceshader")->getSourceUri());
+
+    // Round-trip each example document through a binary snapshot file.
+    mx::FilePath examplesPath = searchPath.find("resources/Materials/Examples/StandardSurface");
+    for (const mx::FilePath& filename : examplesPath.getFilesInDirectory(mx::MTLX_EXTENSION))
+    {
+        mx::DocumentPtr doc = mx::createDocument();
+        mx::readFromXmlFile(doc, examplesPath / filename, searchPath);
+
+        mx::FilePath snapshotPath = filename.getBaseName() + "." + mx::MTLX_BINARY_EXTENSION;
+        mx::writeToBinaryFile(doc, snapshotPath);
+        mx::DocumentPtr docCopy = mx::createDocument();
+        mx::readFromBinaryFile(docCopy, snapshotPath);
+        std::remove(snapshotPath.asString().c_str());
+
+        REQUIRE(docCopy->isEquivalent(doc, options));
+        REQUIRE(mx::writeToXmlString(docCopy) == mx::writeToXmlString(doc));
+        REQUIRE(docCopy->validate());
+    }
+
+    // Verify that invalid snapshots are rejected.
+    mx::DocumentPtr invalid = mx::createDocument();
+    REQUIRE_THROWS_AS(mx::readFromBinaryString(invalid, mx::writeToXmlString(libs)), mx::ExceptionParseError);
+    REQUIRE_THROWS_AS(mx::readFromBinaryString(invalid, snapshot.substr(0, snapshot.size() / 2)), mx::ExceptionParseError);
+    REQUIRE_THROWS_AS(mx::readFromBinaryFile(invalid, "nonexistent." + mx::MTLX_BINARY_EXTENSION), mx::ExceptionFileMissing);
+}
+
+#ifdef MATERIALX_BUILD_BENCHMARK_TESTS
+TEST_CASE("Binary snapshot performance", "[binaryio]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::DocumentPtr libs = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, libs);
+    std::string snapshot = mx::writeToBinaryString(libs);
+
+    // Compare data library load times from XML and from a binary snapshot.
+    BENCHMARK("Load libraries from XML")
+    {
+        mx::DocumentPtr doc = mx::createDocument();
+        mx::loadLibraries({ "libraries" }, searchPath, doc);
+        return doc->getChildren().size();
+    };
+    BENCHMARK("Load libraries from binary snapshot")
+    {
+        mx::DocumentPtr doc = mx::createDocument();
+        mx::readFromBinaryString(doc, snapshot);
+        return doc->getChildren().size();
+    };
+}
+#endif
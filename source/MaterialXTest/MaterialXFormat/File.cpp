@@ -135,6 +135,100 @@ TEST_CASE("Flatten filenames", "[file]")
     REQUIRE(resolvedPathString == (rootPath / TEST_FILE_PREFIX_STRING / TEST_IMAGE_STRING2).asString(mx::FilePath::FormatPosix));
 }
 
+TEST_CASE("Resolve filenames", "[file]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    std::vector<mx::DocumentPtr> docs;
+    mx::StringVec docPaths;
+    mx::loadDocuments(searchPath.find("resources/Materials/TestSuite"), searchPath, {}, {}, docs, docPaths);
+    REQUIRE(!docs.empty());
+
+    // Batch resolution matches the resolution of each filename element.
+    size_t filenameCount = 0;
+    for (mx::DocumentPtr doc : docs)
+    {
+        for (const auto& pair : mx::resolveFilenames(doc))
+        {
+            REQUIRE(pair.first->getType() == mx::FILENAME_TYPE_STRING);
+            REQUIRE(pair.second == pair.first->getResolvedValueString());
+            filenameCount++;
+        }
+    }
+    REQUIRE(filenameCount > 0);
+
+    // Tokens of the nearest scope take precedence.
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph("graph");
+    nodeGraph->setFilePrefix("textures/");
+    nodeGraph->setTokenValue("res", "2k");
+    nodeGraph->setTokenValue("ext", "png");
+    mx::NodePtr image1 = nodeGraph->addNode("image", "image1");
+    image1->setInputValue("file", "color_[res].[ext]", mx::FILENAME_TYPE_STRING);
+    mx::NodePtr image2 = nodeGraph->addNode("image", "image2");
+    image2->setTokenValue("res", "4k");
+    mx::InputPtr input2 = image2->setInputValue("file", "color_[res].[ext]", mx::FILENAME_TYPE_STRING);
+    input2->setFilePrefix("override/");
+    std::vector<std::pair<mx::ValueElementPtr, std::string>> resolved = mx::resolveFilenames(doc);
+    REQUIRE(resolved.size() == 2);
+    REQUIRE(resolved[0].second == "textures/color_2k.png");
+    REQUIRE(resolved[1].second == "override/color_4k.png");
+    for (const auto& pair : resolved)
+    {
+        REQUIRE(pair.second == pair.first->getResolvedValueString());
+    }
+
+    // Resolution may begin below the document root.
+    resolved = mx::resolveFilenames(image2);
+    REQUIRE(resolved.size() == 1);
+    REQUIRE(resolved[0].second == "override/color_4k.png");
+}
+
+#ifdef MATERIALX_BUILD_BENCHMARK_TESTS
+TEST_CASE("Resolve filenames performance", "[file]")
+{
+    // Create a document of 1k graphs, each with tokenized image filenames.
+    const int GRAPH_COUNT = 1000;
+    const int IMAGE_COUNT = 8;
+    mx::DocumentPtr doc = mx::createDocument();
+    for (int i = 0; i < GRAPH_COUNT; i++)
+    {
+        mx::NodeGraphPtr nodeGraph = doc->addNodeGraph("graph" + std::to_string(i));
+        nodeGraph->setFilePrefix("assets/asset" + std::to_string(i) + "/");
+        nodeGraph->setTokenValue("res", "4k");
+        nodeGraph->setTokenValue("ext", "exr");
+        for (int j = 0; j < IMAGE_COUNT; j++)
+        {
+            mx::NodePtr image = nodeGraph->addNode("image", "image" + std::to_string(j));
+            image->setInputValue("file", "map" + std::to_string(j) + "_[res].<UDIM>.[ext]", mx::FILENAME_TYPE_STRING);
+        }
+    }
+
+    BENCHMARK("Resolve each filename")
+    {
+        size_t length = 0;
+        for (mx::ElementPtr elem : doc->traverseTree())
+        {
+            mx::ValueElementPtr valueElem = elem->asA<mx::ValueElement>();
+            if (valueElem && valueElem->getType() == mx::FILENAME_TYPE_STRING)
+            {
+                length += valueElem->getResolvedValueString().size();
+            }
+        }
+        return length;
+    };
+
+    BENCHMARK("Resolve filenames in batch")
+    {
+        size_t length = 0;
+        for (const auto& pair : mx::resolveFilenames(doc))
+        {
+            length += pair.second.size();
+        }
+        return length;
+    };
+}
+#endif
+
 TEST_CASE("Path normalization test", "[file]")
 {
     const mx::FilePath REFERENCE_REL_PATH("a/b");
@@ -9,6 +9,9 @@
 #include <MaterialXFormat/Util.h>
 #include <MaterialXFormat/XmlIo.h>
 
+#include <cstdio>
+#include <thread>
+
 namespace mx = MaterialX;
 
 TEST_CASE("Load content", "[xmlio]")
@@ -239,6 +242,279 @@ TEST_CASE("Load content", "[xmlio]")
     REQUIRE_THROWS_AS(mx::readFromXmlFile(nonExistentDoc, "NonExistent.mtlx", mx::FileSearchPath(), &readOptions), mx::ExceptionFileMissing);
 }
 
+TEST_CASE("Memory-mapped loading", "[xmlio]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::FilePath examplesPath = searchPath.find("resources/Materials/Examples/StandardSurface");
+    mx::XmlReadOptions readOptions;
+    readOptions.readComments = true;
+    readOptions.readNewlines = true;
+    mx::XmlReadOptions mappedReadOptions = readOptions;
+    mappedReadOptions.memoryMapFiles = true;
+
+    // Verify that memory-mapped and buffered reads are identical.
+    for (const mx::FilePath& filename : examplesPath.getFilesInDirectory(mx::MTLX_EXTENSION))
+    {
+        mx::DocumentPtr doc = mx::createDocument();
+        mx::readFromXmlFile(doc, examplesPath / filename, searchPath, &readOptions);
+        mx::DocumentPtr mappedDoc = mx::createDocument();
+        mx::readFromXmlFile(mappedDoc, examplesPath / filename, searchPath, &mappedReadOptions);
+        REQUIRE(*mappedDoc == *doc);
+        REQUIRE(mx::writeToXmlString(mappedDoc) == mx::writeToXmlString(doc));
+    }
+
+    // Verify that memory mapping leaves the file on disk unmodified.
+    mx::FilePath testPath = examplesPath / "standard_surface_default.mtlx";
+    std::string origXml = mx::readFile(testPath);
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::readFromXmlFile(doc, testPath, searchPath, &mappedReadOptions);
+    REQUIRE(mx::readFile(testPath) == origXml);
+
+    // Verify that missing files are reported.
+    REQUIRE_THROWS_AS(mx::readFromXmlFile(doc, "nonexistent.mtlx", mx::FileSearchPath(), &mappedReadOptions), mx::ExceptionFileMissing);
+}
+
+TEST_CASE("Parallel loading", "[xmlio]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::FilePathVec libraryFolders = { "libraries" };
+
+    // Load data libraries serially and in parallel, and verify that the
+    // results are identical.
+    mx::DocumentPtr serialLibs = mx::createDocument();
+    mx::StringSet serialFiles = mx::loadLibraries(libraryFolders, searchPath, serialLibs);
+    mx::DocumentPtr parallelLibs = mx::createDocument();
+    mx::ParseTimeMap parseTimes;
+    mx::StringSet parallelFiles = mx::loadLibraries(libraryFolders, searchPath, parallelLibs, mx::StringSet(), nullptr, 4, &parseTimes);
+    REQUIRE(serialFiles == parallelFiles);
+    REQUIRE(*serialLibs == *parallelLibs);
+    REQUIRE(parseTimes.size() == parallelFiles.size());
+
+    // Load example documents serially and in parallel, and verify that
+    // documents and errors are returned in the same order.
+    mx::FilePath rootPath = searchPath.find("resources/Materials/TestSuite");
+    std::vector<mx::DocumentPtr> serialDocs, parallelDocs;
+    mx::StringVec serialPaths, parallelPaths;
+    mx::StringVec serialErrors, parallelErrors;
+    mx::loadDocuments(rootPath, searchPath, {}, {}, serialDocs, serialPaths, nullptr, &serialErrors);
+    mx::loadDocuments(rootPath, searchPath, {}, {}, parallelDocs, parallelPaths, nullptr, &parallelErrors, 0);
+    REQUIRE(!serialDocs.empty());
+    REQUIRE(serialPaths == parallelPaths);
+    REQUIRE(serialErrors == parallelErrors);
+    REQUIRE(serialDocs.size() == parallelDocs.size());
+    for (size_t i = 0; i < serialDocs.size(); i++)
+    {
+        REQUIRE(*serialDocs[i] == *parallelDocs[i]);
+    }
+}
+
+#ifdef MATERIALX_BUILD_BENCHMARK_TESTS
+TEST_CASE("Load content performance", "[xmlio]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::FilePath materialsPath = searchPath.find("resources/Materials");
+    mx::FilePathVec filenames;
+    for (const mx::FilePath& dir : materialsPath.getSubDirectories())
+    {
+        for (const mx::FilePath& filename : dir.getFilesInDirectory(mx::MTLX_EXTENSION))
+        {
+            filenames.push_back(dir / filename);
+        }
+    }
+
+    // Load and destroy each document of the materials corpus.
+    BENCHMARK("Load and destroy documents")
+    {
+        size_t elementCount = 0;
+        for (const mx::FilePath& filename : filenames)
+        {
+            mx::DocumentPtr doc = mx::createDocument();
+            try
+            {
+                mx::readFromXmlFile(doc, filename, searchPath);
+            }
+            catch (mx::Exception&)
+            {
+                continue;
+            }
+            elementCount += doc->getChildren().size();
+        }
+        return elementCount;
+    };
+}
+
+TEST_CASE("Load libraries performance", "[xmlio]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::FilePathVec libraryFolders = { "libraries" };
+
+    // Load the data libraries with increasing worker counts.
+    unsigned int maxWorkerCount = std::max(std::thread::hardware_concurrency(), 4u);
+    for (unsigned int workerCount = 1; workerCount <= maxWorkerCount; workerCount *= 2)
+    {
+        BENCHMARK("Load libraries with " + std::to_string(workerCount) + " worker(s)")
+        {
+            mx::DocumentPtr libs = mx::createDocument();
+            mx::loadLibraries(libraryFolders, searchPath, libs, mx::StringSet(), nullptr, workerCount);
+            return libs->getChildren().size();
+        };
+    }
+}
+
+TEST_CASE("Memory-mapped load performance", "[xmlio]")
+{
+    // Generate a large synthetic document of chained nodes.
+    const size_t GRAPH_COUNT = 1000;
+    const size_t NODE_COUNT = 100;
+    mx::DocumentPtr doc = mx::createDocument();
+    for (size_t i = 0; i < GRAPH_COUNT; i++)
+    {
+        mx::NodeGraphPtr graph = doc->addNodeGraph("NG_synthetic" + std::to_string(i));
+        mx::NodePtr prevNode;
+        for (size_t j = 0; j < NODE_COUNT; j++)
+        {
+            mx::NodePtr node = graph->addNode("add", "add" + std::to_string(j), "color3");
+            mx::InputPtr in1 = node->addInput("in1", "color3");
+            if (prevNode)
+            {
+                in1->setConnectedNode(prevNode);
+            }
+            else
+            {
+                in1->setValue(mx::Color3(0.1f, 0.2f, 0.3f));
+            }
+            node->setInputValue("in2", mx::Color3(0.4f, 0.5f, 0.6f));
+            prevNode = node;
+        }
+        graph->addOutput("out", "color3")->setConnectedNode(prevNode);
+    }
+    mx::FilePath filename = "synthetic_document.mtlx";
+    mx::writeToXmlFile(doc, filename);
+    doc = nullptr;
+
+    // Compare buffered and memory-mapped reads of the synthetic document.
+    for (bool memoryMapFiles : { false, true })
+    {
+        mx::XmlReadOptions readOptions;
+        readOptions.memoryMapFiles = memoryMapFiles;
+        BENCHMARK(memoryMapFiles ? "Read synthetic document with memory mapping" : "Read synthetic document")
+        {
+            mx::DocumentPtr readDoc = mx::createDocument();
+            mx::readFromXmlFile(readDoc, filename, mx::FileSearchPath(), &readOptions);
+            return readDoc->getChildren().size();
+        };
+    }
+    std::remove(filename.asString().c_str());
+}
+
+TEST_CASE("Write content performance", "[xmlio]")
+{
+    // Generate a large synthetic document of chained nodes.
+    mx::DocumentPtr doc = mx::createDocument();
+    for (size_t i = 0; i < 1000; i++)
+    {
+        mx::NodeGraphPtr graph = doc->addNodeGraph("NG_synthetic" + std::to_string(i));
+        mx::NodePtr prevNode;
+        for (size_t j = 0; j < 100; j++)
+        {
+            mx::NodePtr node = graph->addNode("add", "add" + std::to_string(j), "color3");
+            node->setInputValue("in1", mx::Color3(0.1f, 0.2f, 0.3f));
+            if (prevNode)
+            {
+                node->addInput("in2", "color3")->setConnectedNode(prevNode);
+            }
+            prevNode = node;
+        }
+    }
+
+    BENCHMARK("Write synthetic document")
+    {
+        return mx::writeToXmlString(doc).size();
+    };
+}
+#endif
+
+TEST_CASE("Write content", "[xmlio]")
+{
+    // Verify the serialized form of escaped attributes, XIncludes, comments,
+    // newlines and empty elements.
+    mx::DocumentPtr doc = mx::createDocument();
+    doc->setSourceUri("main.mtlx");
+    mx::NodeGraphPtr graph = doc->addNodeGraph("graph");
+    graph->setAttribute("label", "a&b \"c\" <d>\ne");
+    graph->addNode("add", "add1", "float")->setSourceUri("include.mtlx");
+    graph->addNode("add", "add2", "float")->setSourceUri("include.mtlx");
+    doc->addChildOfCategory(mx::CommentElement::CATEGORY)->setDocString("a -- b-");
+    doc->addChildOfCategory(mx::NewlineElement::CATEGORY);
+    doc->addNodeGraph("empty");
+    std::string expected =
+        "<?xml version=\"1.0\"?>\n"
+        "<materialx version=\"" + doc->getVersionString() + "\">\n"
+        "  <nodegraph name=\"graph\" label=\"a&amp;b &quot;c&quot; <d>&#10;e\" xmlns:xi=\"http://www.w3.org/2001/XInclude\">\n"
+        "    <xi:include href=\"include.mtlx\" />\n"
+        "  </nodegraph>\n"
+        "  <!--a - - b- -->\n"
+        "\n"
+        "  <nodegraph name=\"empty\" />\n"
+        "</materialx>\n";
+    REQUIRE(mx::writeToXmlString(doc) == expected);
+
+    // Verify that filtered children are omitted, and that XIncludes may be
+    // written as explicit data.
+    mx::XmlWriteOptions writeOptions;
+    writeOptions.writeXIncludeEnable = false;
+    writeOptions.elementPredicate = [](mx::ConstElementPtr elem)
+    {
+        return elem->getName() != "add2" && !elem->isA<mx::CommentElement>();
+    };
+    expected =
+        "<?xml version=\"1.0\"?>\n"
+        "<materialx version=\"" + doc->getVersionString() + "\">\n"
+        "  <nodegraph name=\"graph\" label=\"a&amp;b &quot;c&quot; <d>&#10;e\">\n"
+        "    <add name=\"add1\" type=\"float\" />\n"
+        "  </nodegraph>\n"
+        "\n"
+        "  <nodegraph name=\"empty\" />\n"
+        "</materialx>\n";
+    REQUIRE(mx::writeToXmlString(doc, &writeOptions) == expected);
+
+    // Verify that attribute values end at an embedded null character.
+    graph->setAttribute("label", std::string("a\0b", 3));
+    std::string written = mx::writeToXmlString(doc);
+    REQUIRE(written.find("label=\"a\"") != std::string::npos);
+    mx::DocumentPtr writtenDoc = mx::createDocument();
+    mx::readFromXmlString(writtenDoc, written);
+    REQUIRE(writtenDoc->getNodeGraph("graph")->getAttribute("label") == "a");
+
+    // Verify that written documents round-trip across the example corpus.
+    writeOptions = mx::XmlWriteOptions();
+    writeOptions.writeXIncludeEnable = false;
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::FilePath materialsPath = searchPath.find("resources/Materials");
+    mx::XmlReadOptions readOptions;
+    readOptions.readComments = true;
+    readOptions.readNewlines = true;
+    for (const mx::FilePath& dir : materialsPath.getSubDirectories())
+    {
+        for (const mx::FilePath& filename : dir.getFilesInDirectory(mx::MTLX_EXTENSION))
+        {
+            mx::DocumentPtr origDoc = mx::createDocument();
+            try
+            {
+                mx::readFromXmlFile(origDoc, dir / filename, searchPath, &readOptions);
+            }
+            catch (mx::Exception&)
+            {
+                continue;
+            }
+            std::string xml = mx::writeToXmlString(origDoc, &writeOptions);
+            mx::DocumentPtr newDoc = mx::createDocument();
+            mx::readFromXmlString(newDoc, xml, searchPath, &readOptions);
+            REQUIRE(mx::writeToXmlString(newDoc, &writeOptions) == xml);
+        }
+    }
+}
+
 TEST_CASE("Comments and newlines", "[xmlio]")
 {
     mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
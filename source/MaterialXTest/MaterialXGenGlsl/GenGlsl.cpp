@@ -14,6 +14,8 @@
 #include <MaterialXGenGlsl/GlslResourceBindingContext.h>
 #include <MaterialXGenGlsl/VkShaderGenerator.h>
 
+#include <MaterialXGenShader/Shader.h>
+
 namespace mx = MaterialX;
 
 TEST_CASE("GenShader: GLSL Syntax Check", "[genglsl]")
@@ -124,6 +126,54 @@ TEST_CASE("GenShader: GLSL Performance Test", "[genglsl]")
         return GenShaderUtil::shaderGenPerformanceTest(context);
     };
 }
+
+TEST_CASE("GenShader: GLSL NodeDef Resolution Performance", "[genglsl]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::DocumentPtr libraries = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, libraries);
+
+    mx::GenContext context(mx::GlslShaderGenerator::create());
+    context.registerSourceCodeSearchPath(searchPath);
+
+    std::vector<mx::DocumentPtr> docs;
+    mx::StringVec docPaths;
+    mx::loadDocuments(searchPath.find("resources/Materials/Examples/StandardSurface"), searchPath, {}, {}, docs, docPaths);
+    std::vector<mx::TypedElementPtr> renderables;
+    for (mx::DocumentPtr doc : docs)
+    {
+        doc->setDataLibrary(libraries);
+        for (mx::TypedElementPtr elem : mx::findRenderableElements(doc))
+        {
+            renderables.push_back(elem);
+        }
+    }
+    REQUIRE(!renderables.empty());
+
+    // Compare shader generation with nodedef resolutions discarded before
+    // each document, and with resolutions retained from previous passes.
+    BENCHMARK("Generate shaders with cold nodedef resolution")
+    {
+        size_t length = 0;
+        for (mx::TypedElementPtr elem : renderables)
+        {
+            elem->getDocument()->setDataLibrary(libraries);
+            mx::ShaderPtr shader = context.getShaderGenerator().generate(elem->getName(), elem, context);
+            length += shader->getSourceCode(mx::Stage::PIXEL).length();
+        }
+        return length;
+    };
+    BENCHMARK("Generate shaders with warm nodedef resolution")
+    {
+        size_t length = 0;
+        for (mx::TypedElementPtr elem : renderables)
+        {
+            mx::ShaderPtr shader = context.getShaderGenerator().generate(elem->getName(), elem, context);
+            length += shader->getSourceCode(mx::Stage::PIXEL).length();
+        }
+        return length;
+    };
+}
 #endif
 
 enum class GlslType
@@ -12,6 +12,7 @@
 #include <MaterialXFormat/Util.h>
 
 #include <MaterialXGenShader/HwShaderGenerator.h>
+#include <MaterialXGenShader/ShaderCache.h>
 #include <MaterialXGenShader/ShaderTranslator.h>
 #include <MaterialXGenShader/Util.h>
 
@@ -28,10 +29,14 @@
 #include <MaterialXGenMsl/MslShaderGenerator.h>
 #endif
 
+#include <cstdio>
 #include <cstdlib>
 #include <iostream>
+#include <regex>
+#include <sstream>
 #include <vector>
 #include <set>
+#include <thread>
 
 namespace mx = MaterialX;
 
@@ -104,6 +109,125 @@ TEST_CASE("GenShader: TypeDesc Check", "[genshader]")
     REQUIRE(mx::TypeDesc::get("bar") == mx::Type::NONE);
 }
 
+#ifdef MATERIALX_BUILD_GEN_GLSL
+TEST_CASE("GenShader: Concurrent Struct Types", "[genshader]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::DocumentPtr libraries = mx::createDocument();
+    mx::loadLibraries({ "libraries/targets", "libraries/stdlib" }, searchPath, libraries);
+
+    // Each thread defines a struct type of the same name but with distinct
+    // members, and generates a shader with its own generator and context.
+    const unsigned int threadCount = std::max(std::thread::hardware_concurrency(), 4u);
+    std::vector<std::string> errors(threadCount);
+    std::vector<std::thread> threads;
+    for (unsigned int i = 0; i < threadCount; i++)
+    {
+        threads.emplace_back([&libraries, &searchPath, &errors, threadCount, i]()
+        {
+            try
+            {
+                const std::string memberName = "member" + std::to_string(i);
+
+                mx::DocumentPtr doc = mx::createDocument();
+                doc->setDataLibrary(libraries);
+                mx::TypeDefPtr typeDef = doc->addTypeDef("concurrent_struct");
+                typeDef->addMember(memberName)->setType("float");
+                typeDef->addMember("color")->setType("color3");
+
+                // Define a node that takes the struct as input, with an inline
+                // implementation that extracts one of its members.
+                mx::NodeDefPtr nodeDef = doc->addNodeDef("ND_struct_color", "color3", "struct_color");
+                nodeDef->addInput("in", "concurrent_struct")->setValueString("{0.0;0.0,0.0,0.0}");
+                mx::ImplementationPtr impl = doc->addImplementation("IM_struct_color_genglsl");
+                impl->setNodeDef(nodeDef);
+                impl->setTarget(mx::GlslShaderGenerator::TARGET);
+                impl->setAttribute("sourcecode", "{{in}}.color");
+
+                const std::string structValue = std::to_string(static_cast<float>(i) / threadCount) + ";0.1,0.2,0.3";
+                mx::NodeGraphPtr nodeGraph = doc->addNodeGraph();
+                mx::NodePtr structNode = nodeGraph->addNode("struct_color", "struct1", "color3");
+                structNode->addInput("in", "concurrent_struct")->setValueString("{" + structValue + "}");
+                mx::OutputPtr output = nodeGraph->addOutput("out", "color3");
+                output->setConnectedNode(structNode);
+
+                mx::GenContext context(mx::GlslShaderGenerator::create());
+                context.registerSourceCodeSearchPath(searchPath);
+                mx::ShaderGenerator& generator = context.getShaderGenerator();
+                generator.loadStructTypeDefs(doc);
+
+                for (int iteration = 0; iteration < 8; iteration++)
+                {
+                    std::string definition;
+                    {
+                        mx::StructTypeRegistry::Scope scope(&generator.getStructTypes());
+                        mx::TypeDesc structType = mx::TypeDesc::get("concurrent_struct");
+                        if (!structType.isStruct())
+                        {
+                            errors[i] = "Struct type not found";
+                            return;
+                        }
+                        const mx::StructTypeDesc& structTypeDesc = mx::StructTypeDesc::get(structType.getStructIndex());
+                        if (structTypeDesc.getMembers().size() != 2 ||
+                            structTypeDesc.getMembers()[0]._name != memberName)
+                        {
+                            errors[i] = "Struct type has unexpected members";
+                            return;
+                        }
+                        definition = generator.getSyntax().getTypeDefinition(structType);
+                        if (definition.find(memberName) == std::string::npos)
+                        {
+                            errors[i] = "Struct syntax has unexpected members: " + definition;
+                            return;
+                        }
+                        mx::ValuePtr value = structType.createValueFromStrings("{1.0;0.1,0.2,0.3}");
+                        if (!value || value->getTypeString() != "concurrent_struct")
+                        {
+                            errors[i] = "Struct value could not be created";
+                            return;
+                        }
+                    }
+
+                    // The generated shader must use this thread's struct definition.
+                    mx::ShaderPtr shader = generator.generate("shader" + std::to_string(i), output, context);
+                    if (!shader || shader->getSourceCode(mx::Stage::PIXEL).empty())
+                    {
+                        errors[i] = "Shader generation failed";
+                        return;
+                    }
+                    const std::string& pixelSource = shader->getSourceCode(mx::Stage::PIXEL);
+                    if (pixelSource.find(definition) == std::string::npos)
+                    {
+                        errors[i] = "Shader has unexpected struct definition: " + pixelSource;
+                        return;
+                    }
+                    if (pixelSource.find(".color") == std::string::npos)
+                    {
+                        errors[i] = "Shader does not read the struct input: " + pixelSource;
+                        return;
+                    }
+                }
+            }
+            catch (std::exception& e)
+            {
+                errors[i] = e.what();
+            }
+        });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    for (const std::string& error : errors)
+    {
+        CHECK(error.empty());
+    }
+
+    // Struct types are only visible within the scope of a registry.
+    REQUIRE(mx::TypeDesc::get("concurrent_struct") == mx::Type::NONE);
+}
+#endif
+
 TEST_CASE("GenShader: Shader Translation", "[translate]")
 {
     mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
@@ -264,6 +388,391 @@ TEST_CASE("GenShader: Deterministic Generation", "[genshader]")
 #endif
 }
 
+void testStripUnusedCode(mx::DocumentPtr libraries, mx::GenContext& context)
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::readFromXmlFile(doc, searchPath.find("resources/Materials/Examples/StandardSurface/standard_surface_brass_tiled.mtlx"));
+    doc->setDataLibrary(libraries);
+    std::vector<mx::TypedElementPtr> elements = mx::findRenderableElements(doc);
+    REQUIRE(!elements.empty());
+
+    context.getOptions().stripUnusedCode = false;
+    mx::ShaderPtr shader = context.getShaderGenerator().generate("shader", elements[0], context);
+    context.getOptions().stripUnusedCode = true;
+    mx::ShaderPtr stripped = context.getShaderGenerator().generate("shader", elements[0], context);
+    context.getOptions().stripUnusedCode = false;
+    REQUIRE(shader);
+    REQUIRE(stripped);
+
+    const std::regex functionRegex("^[ \\t]*\\w+[ \\t]+(\\w+)[ \\t]*\\(");
+    size_t numRemoved = 0;
+    for (size_t i = 0; i < shader->numStages(); ++i)
+    {
+        const std::string& source = shader->getStage(i).getSourceCode();
+        const std::string& strippedSource = stripped->getStage(i).getSourceCode();
+        REQUIRE(strippedSource.size() <= source.size());
+
+        // Functions that were removed must not be referenced by the stripped code.
+        std::set<std::string> remaining;
+        std::istringstream strippedStream(strippedSource);
+        for (std::string line; std::getline(strippedStream, line);)
+        {
+            std::smatch match;
+            if (std::regex_search(line, match, functionRegex))
+            {
+                remaining.insert(match[1]);
+            }
+        }
+        std::istringstream stream(source);
+        for (std::string line; std::getline(stream, line);)
+        {
+            std::smatch match;
+            if (std::regex_search(line, match, functionRegex) && !remaining.count(match[1]))
+            {
+                INFO("Function " + match[1].str() + " was removed but is referenced");
+                REQUIRE(!std::regex_search(strippedSource, std::regex("\\b" + match[1].str() + "\\b")));
+                numRemoved++;
+            }
+        }
+    }
+    REQUIRE(numRemoved > 0);
+}
+
+TEST_CASE("GenShader: Strip Unused Code", "[genshader]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::DocumentPtr libraries = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, libraries);
+
+#ifdef MATERIALX_BUILD_GEN_GLSL
+    {
+        mx::GenContext context(mx::GlslShaderGenerator::create());
+        context.registerSourceCodeSearchPath(searchPath);
+        testStripUnusedCode(libraries, context);
+    }
+#endif
+#ifdef MATERIALX_BUILD_GEN_OSL
+    {
+        mx::GenContext context(mx::OslShaderGenerator::create());
+        context.registerSourceCodeSearchPath(searchPath);
+        testStripUnusedCode(libraries, context);
+    }
+#endif
+#ifdef MATERIALX_BUILD_GEN_MSL
+    {
+        mx::GenContext context(mx::MslShaderGenerator::create());
+        context.registerSourceCodeSearchPath(searchPath);
+        testStripUnusedCode(libraries, context);
+    }
+#endif
+}
+
+#if defined(MATERIALX_BUILD_BENCHMARK_TESTS) && defined(MATERIALX_BUILD_GEN_GLSL)
+TEST_CASE("GenShader: Shader graph performance", "[genshader]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::DocumentPtr libraries = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, libraries);
+
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::readFromXmlFile(doc, searchPath.find("resources/Materials/Examples/StandardSurface/standard_surface_brass_tiled.mtlx"));
+    doc->setDataLibrary(libraries);
+    std::vector<mx::TypedElementPtr> elements = mx::findRenderableElements(doc);
+    REQUIRE(!elements.empty());
+
+    mx::GenContext context(mx::GlslShaderGenerator::create());
+    context.registerSourceCodeSearchPath(searchPath);
+
+    BENCHMARK("Create shader graph")
+    {
+        return mx::ShaderGraph::create(nullptr, "graph", elements[0], context);
+    };
+
+    BENCHMARK("Generate shader")
+    {
+        return context.getShaderGenerator().generate("shader", elements[0], context);
+    };
+}
+#endif
+
+#ifdef MATERIALX_BUILD_GEN_GLSL
+TEST_CASE("GenShader: Batch Generation", "[genshader]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::DocumentPtr libraries = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, libraries);
+
+    std::vector<mx::DocumentPtr> documents;
+    mx::StringVec documentPaths;
+    mx::loadDocuments(searchPath.find("resources/Materials/Examples/StandardSurface"), searchPath, {}, {}, documents, documentPaths);
+    REQUIRE(!documents.empty());
+
+    std::vector<mx::TypedElementPtr> elements;
+    for (mx::DocumentPtr doc : documents)
+    {
+        doc->setDataLibrary(libraries);
+        for (mx::TypedElementPtr elem : mx::findRenderableElements(doc))
+        {
+            elements.push_back(elem);
+        }
+    }
+
+    mx::GenContextFactory contextFactory = [&searchPath]()
+    {
+        mx::GenContextPtr context = std::make_shared<mx::GenContext>(mx::GlslShaderGenerator::create());
+        context->registerSourceCodeSearchPath(searchPath);
+        return context;
+    };
+
+    // Results are returned in input order, and match serial generation.
+    std::vector<mx::BatchShaderResult> serialResults = mx::generateBatch(elements, contextFactory, 1);
+    std::vector<mx::BatchShaderResult> parallelResults = mx::generateBatch(elements, contextFactory, 4);
+    REQUIRE(serialResults.size() == elements.size());
+    REQUIRE(parallelResults.size() == elements.size());
+    for (size_t i = 0; i < elements.size(); i++)
+    {
+        REQUIRE(serialResults[i].element == elements[i]);
+        REQUIRE(parallelResults[i].element == elements[i]);
+        REQUIRE(serialResults[i].error.empty());
+        REQUIRE(parallelResults[i].error.empty());
+        REQUIRE(serialResults[i].shader);
+        REQUIRE(parallelResults[i].shader);
+        REQUIRE(serialResults[i].shader->getSourceCode(mx::Stage::PIXEL) ==
+                parallelResults[i].shader->getSourceCode(mx::Stage::PIXEL));
+    }
+
+    // Workers use the float formatting of the calling thread.
+    {
+        mx::ScopedFloatFormatting fmt(mx::Value::FloatFormatFixed, 3);
+        mx::BatchShaderResult serialResult = mx::generateBatch({ elements[0] }, contextFactory, 1)[0];
+        mx::BatchShaderResult parallelResult = mx::generateBatch({ elements[0], elements[0] }, contextFactory, 2)[1];
+        REQUIRE(serialResult.shader);
+        REQUIRE(parallelResult.shader);
+        REQUIRE(serialResult.shader->getSourceCode(mx::Stage::PIXEL) != serialResults[0].shader->getSourceCode(mx::Stage::PIXEL));
+        REQUIRE(serialResult.shader->getSourceCode(mx::Stage::PIXEL) ==
+                parallelResult.shader->getSourceCode(mx::Stage::PIXEL));
+    }
+
+    // Errors are reported per element.
+    mx::DocumentPtr invalidDoc = mx::createDocument();
+    mx::NodePtr invalidNode = invalidDoc->addNode("unknown_shader", "invalid", "surfaceshader");
+    std::vector<mx::BatchShaderResult> invalidResults = mx::generateBatch({ elements[0], invalidNode }, contextFactory, 2);
+    REQUIRE(invalidResults[0].shader);
+    REQUIRE(invalidResults[0].error.empty());
+    REQUIRE(!invalidResults[1].shader);
+    REQUIRE(!invalidResults[1].error.empty());
+}
+
+TEST_CASE("GenShader: Graph Optimization", "[genshader]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::DocumentPtr libraries = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, libraries);
+
+    // A constant math chain, and a texture lookup duplicated twice.
+    mx::DocumentPtr doc = mx::createDocument();
+    doc->setDataLibrary(libraries);
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph("optimize_graph");
+    mx::NodePtr multiply1 = nodeGraph->addNode("multiply", "multiply1", "float");
+    multiply1->setInputValue("in1", 2.0f);
+    multiply1->setInputValue("in2", 3.0f);
+    mx::NodePtr add1 = nodeGraph->addNode("add", "add1", "float");
+    add1->setConnectedNode("in1", multiply1);
+    add1->setInputValue("in2", 1.0f);
+    mx::NodePtr combine1 = nodeGraph->addNode("combine3", "combine1", "color3");
+    combine1->setConnectedNode("in1", add1);
+    combine1->setInputValue("in2", 0.5f);
+    combine1->setInputValue("in3", 0.25f);
+    mx::NodePtr image1, image2;
+    for (mx::NodePtr* image : { &image1, &image2 })
+    {
+        const std::string suffix = image == &image1 ? "1" : "2";
+        mx::NodePtr texcoord = nodeGraph->addNode("texcoord", "texcoord" + suffix, "vector2");
+        *image = nodeGraph->addNode("image", "image" + suffix, "color3");
+        (*image)->setInputValue("file", std::string("resources/Images/grid.png"), mx::FILENAME_TYPE_STRING);
+        (*image)->setConnectedNode("texcoord", texcoord);
+    }
+    mx::NodePtr add2 = nodeGraph->addNode("add", "add2", "color3");
+    add2->setConnectedNode("in1", image1);
+    add2->setConnectedNode("in2", image2);
+    mx::NodePtr multiply2 = nodeGraph->addNode("multiply", "multiply2", "color3");
+    multiply2->setConnectedNode("in1", add2);
+    multiply2->setConnectedNode("in2", combine1);
+    mx::OutputPtr output = nodeGraph->addOutput("out", "color3");
+    output->setConnectedNode(multiply2);
+
+    mx::GenContext context(mx::GlslShaderGenerator::create());
+    context.registerSourceCodeSearchPath(searchPath);
+
+    // With a reduced interface, constant nodes are evaluated and
+    // duplicated nodes are merged.
+    context.getOptions().shaderInterfaceType = mx::SHADER_INTERFACE_REDUCED;
+    mx::ShaderPtr shader = context.getShaderGenerator().generate("reduced", output, context);
+    REQUIRE(shader);
+    const mx::ShaderGraph& reducedGraph = shader->getGraph();
+    REQUIRE(!reducedGraph.getNode("multiply1"));
+    REQUIRE(!reducedGraph.getNode("add1"));
+    REQUIRE(!reducedGraph.getNode("combine1"));
+    REQUIRE(reducedGraph.getNode("image1"));
+    REQUIRE(!reducedGraph.getNode("image2"));
+    REQUIRE(!reducedGraph.getNode("texcoord2"));
+    const mx::ShaderInput* folded = reducedGraph.getNode("multiply2")->getInput("in2");
+    REQUIRE(!folded->getConnection());
+    REQUIRE(folded->getValue()->asA<mx::Color3>() == mx::Color3(7.0f, 0.5f, 0.25f));
+
+    // With a complete interface, inputs are published and must be kept.
+    context.getOptions().shaderInterfaceType = mx::SHADER_INTERFACE_COMPLETE;
+    shader = context.getShaderGenerator().generate("complete", output, context);
+    REQUIRE(shader);
+    const mx::ShaderGraph& completeGraph = shader->getGraph();
+    REQUIRE(completeGraph.getNode("multiply1"));
+    REQUIRE(completeGraph.getNode("add1"));
+    REQUIRE(completeGraph.getNode("image1"));
+    REQUIRE(completeGraph.getNode("image2"));
+}
+
+TEST_CASE("GenShader: Shader Cache", "[genshader]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::DocumentPtr libraries = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, libraries);
+
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::readFromXmlFile(doc, searchPath.find("resources/Materials/Examples/StandardSurface/standard_surface_default.mtlx"));
+    doc->setDataLibrary(libraries);
+    std::vector<mx::TypedElementPtr> elements = mx::findRenderableElements(doc);
+    REQUIRE(!elements.empty());
+    mx::TypedElementPtr element = elements[0];
+    mx::NodePtr shaderNode = doc->getNode("SR_default");
+    REQUIRE(shaderNode);
+
+    auto createContext = [&searchPath]()
+    {
+        mx::GenContextPtr context = std::make_shared<mx::GenContext>(mx::GlslShaderGenerator::create());
+        context->registerSourceCodeSearchPath(searchPath);
+        return context;
+    };
+
+    // Cached shaders must match freshly generated shaders.
+    auto validateShader = [&](mx::ShaderPtr shader)
+    {
+        REQUIRE(shader);
+        mx::GenContextPtr context = createContext();
+        mx::ShaderPtr expected = context->getShaderGenerator().generate("test", element, *context);
+        for (const std::string& stage : { mx::Stage::VERTEX, mx::Stage::PIXEL })
+        {
+            REQUIRE(shader->getSourceCode(stage) == expected->getSourceCode(stage));
+        }
+    };
+
+    mx::FilePath cacheDirectory = mx::FilePath::getCurrentPath() / "shadercache";
+    for (const mx::FilePath& file : cacheDirectory.getFilesInDirectory("mxshader"))
+    {
+        std::remove((cacheDirectory / file).asString().c_str());
+    }
+
+    mx::ShaderCachePtr cache = mx::ShaderCache::create();
+    cache->setCacheDirectory(cacheDirectory);
+    mx::GenContextPtr context = createContext();
+
+    // The first request generates the shader.
+    validateShader(cache->generate("test", element, *context));
+    REQUIRE(cache->getStatistics().misses == 1);
+    REQUIRE(cache->size() == 1);
+
+    // A change in uniform value is served from the in-memory tier.
+    shaderNode->setInputValue("base_color", mx::Color3(0.25f, 0.5f, 0.75f));
+    mx::ShaderPtr shader = cache->generate("test", element, *context);
+    validateShader(shader);
+    REQUIRE(cache->getStatistics().memoryHits == 1);
+    mx::ShaderPort* uniform = shader->getStage(mx::Stage::PIXEL).getUniformBlock(mx::HW::PUBLIC_UNIFORMS).find("SR_default_base_color");
+    REQUIRE(uniform);
+    REQUIRE(uniform->getValue()->asA<mx::Color3>() == mx::Color3(0.25f, 0.5f, 0.75f));
+
+    // A new cache is served from the on-disk tier.
+    mx::ShaderCachePtr diskCache = mx::ShaderCache::create();
+    diskCache->setCacheDirectory(cacheDirectory);
+    validateShader(diskCache->generate("test", element, *createContext()));
+    REQUIRE(diskCache->getStatistics().diskHits == 1);
+
+    // A change in generation options requires a new shader.
+    context->getOptions().hwTransparency = true;
+    cache->generate("test", element, *context);
+    context->getOptions().hwTransparency = false;
+    REQUIRE(cache->getStatistics().misses == 2);
+
+    // A change in structure requires a new shader.
+    mx::NodePtr constant = doc->addNode("constant", "base_color_constant", mx::Type::COLOR3.getName());
+    constant->setInputValue("value", mx::Color3(1.0f, 0.0f, 0.0f));
+    shaderNode->getInput("base_color")->setConnectedNode(constant);
+    validateShader(cache->generate("test", element, *context));
+    mx::ShaderCache::Statistics statistics = cache->getStatistics();
+    REQUIRE(statistics.misses == 3);
+    REQUIRE(cache->size() == 3);
+
+    // The in-memory tier evicts the least recently used shaders.
+    cache->setCapacity(1);
+    REQUIRE(cache->size() == 1);
+    REQUIRE(statistics.getHitRate() == 0.25);
+}
+#endif
+
+#ifdef MATERIALX_BUILD_BENCHMARK_TESTS
+TEST_CASE("GenShader: Batch generation performance", "[genshader]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::DocumentPtr libraries = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, libraries);
+
+    std::vector<mx::DocumentPtr> documents;
+    mx::StringVec documentPaths;
+    mx::loadDocuments(searchPath.find("resources/Materials"), searchPath, {}, {}, documents, documentPaths);
+
+    std::vector<mx::TypedElementPtr> elements;
+    for (mx::DocumentPtr doc : documents)
+    {
+        doc->setDataLibrary(libraries);
+        for (mx::TypedElementPtr elem : mx::findRenderableElements(doc))
+        {
+            elements.push_back(elem);
+        }
+    }
+    REQUIRE(!elements.empty());
+
+    std::vector<std::pair<std::string, std::function<mx::ShaderGeneratorPtr()>>> generators;
+#ifdef MATERIALX_BUILD_GEN_GLSL
+    generators.emplace_back("GLSL", []() { return mx::GlslShaderGenerator::create(); });
+#endif
+#ifdef MATERIALX_BUILD_GEN_OSL
+    generators.emplace_back("OSL", []() { return mx::OslShaderGenerator::create(); });
+#endif
+#ifdef MATERIALX_BUILD_GEN_MDL
+    generators.emplace_back("MDL", []() { return mx::MdlShaderGenerator::create(); });
+#endif
+
+    const unsigned int maxWorkerCount = std::max(std::thread::hardware_concurrency(), 1u);
+    for (const auto& generator : generators)
+    {
+        mx::GenContextFactory contextFactory = [&searchPath, &generator]()
+        {
+            mx::GenContextPtr context = std::make_shared<mx::GenContext>(generator.second());
+            context->registerSourceCodeSearchPath(searchPath);
+            context->registerSourceCodeSearchPath(searchPath.find("libraries/stdlib/genosl/include"));
+            return context;
+        };
+
+        for (unsigned int workerCount = 1; workerCount <= maxWorkerCount; workerCount *= 2)
+        {
+            BENCHMARK("Generate " + generator.first + " on " + std::to_string(workerCount) + " threads")
+            {
+                return mx::generateBatch(elements, contextFactory, workerCount);
+            };
+        }
+    }
+}
+#endif
+
 void checkPixelDependencies(mx::DocumentPtr libraries, mx::GenContext& context)
 {
     mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
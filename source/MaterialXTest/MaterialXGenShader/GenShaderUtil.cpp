@@ -16,6 +16,7 @@
 #include <MaterialXGenShader/Util.h>
 #include <MaterialXGenShader/TypeDesc.h>
 
+#include <chrono>
 #include <iostream>
 
 namespace mx = MaterialX;
@@ -24,6 +25,7 @@ namespace GenShaderUtil
 {
 
 const std::string LAYOUT_SUFFIX("_layout");
+const std::string STRIPPED_SUFFIX("_stripped");
 const std::string SOURCE_CODE_STRING("sourcecode");
 
 namespace
@@ -611,6 +613,63 @@ void ShaderGeneratorTester::registerLights(mx::DocumentPtr doc, const std::vecto
     context.getOptions().hwMaxActiveLightSources = lightSourceCount;
 }
 
+double ShaderGeneratorTester::writeAndCompileSource(mx::DocumentPtr doc, const std::string& elementName,
+                                                    const std::string& elementNameSuffix, const mx::StringVec& sourceCode)
+{
+    mx::FilePath path = doc->getSourceUri();
+    if (!path.isEmpty())
+    {
+        std::string testFileName = path[path.size() - 1];
+        size_t pos = testFileName.rfind('.');
+        if (pos != std::string::npos)
+            testFileName = testFileName.substr(0, pos);
+
+        path = path.getParentPath() / testFileName;
+        if (!path.exists())
+        {
+            path.createDirectory();
+        }
+    }
+    else
+    {
+        mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+        path = searchPath.isEmpty() ? mx::FilePath() : searchPath[0];
+    }
+
+    std::vector<mx::FilePath> sourceCodePaths;
+    if (sourceCode.size() > 1)
+    {
+        for (size_t i=0; i<sourceCode.size(); ++i)
+        {
+            const mx::FilePath filename = path / (elementName + elementNameSuffix + "." + _testStages[i] + "." + getFileExtensionForTarget(_shaderGenerator->getTarget()));
+            sourceCodePaths.push_back(filename);
+            std::ofstream file(filename.asString());
+            _logFile << "Write source code: " << filename.asString() << std::endl;
+            file << sourceCode[i];
+            file.close();
+        }
+    }
+    else
+    {
+        path = path / (elementName + "."  
+            + _shaderGenerator->getTarget() 
+            + "." + getFileExtensionForTarget(_shaderGenerator->getTarget())
+            );
+        sourceCodePaths.push_back(path);
+        std::ofstream file(path.asString());
+        _logFile << "Write source code: " << path.asString() << std::endl;
+        std::cout << "Write source code: " << path.asString() << std::endl;
+        file << sourceCode[0];
+        file.close();
+    }
+
+    // Run compile test
+    auto startTime = std::chrono::steady_clock::now();
+    compileSource(sourceCodePaths);
+    std::chrono::duration<double> compileTime = std::chrono::steady_clock::now() - startTime;
+    return compileTime.count();
+}
+
 void ShaderGeneratorTester::validate(const mx::GenOptions& generateOptions, const std::string& optionsFilePath)
 {
     // Start logging
@@ -697,6 +756,12 @@ void ShaderGeneratorTester::validate(const mx::GenOptions& generateOptions, cons
     mx::StringMap filenameRemap;
     filenameRemap[":"] = "_";
 
+    // Shaders are also validated with unused code stripped, unless stripping
+    // is already enabled for the unstripped pass.
+    const bool validateStrippedCode = options.validateStrippedCode && !generateOptions.stripUnusedCode;
+    double validationTime = 0.0;
+    double strippedValidationTime = 0.0;
+
     size_t documentIndex = 0;
     for (const auto& doc : _documents)
     {
@@ -821,56 +886,26 @@ void ShaderGeneratorTester::validate(const mx::GenOptions& generateOptions, cons
                     else if (_writeShadersToDisk && sourceCode.size())
                     {
                         const std::string elementNameSuffix(bindingContextUsed ? LAYOUT_SUFFIX : mx::EMPTY_STRING);
+                        validationTime += writeAndCompileSource(doc, elementName, elementNameSuffix, sourceCode);
 
-                        mx::FilePath path = doc->getSourceUri();
-                        if (!path.isEmpty())
+                        // Run the same compile test on the shader with unused code stripped.
+                        if (validateStrippedCode)
                         {
-                            std::string testFileName = path[path.size() - 1];
-                            size_t pos = testFileName.rfind('.');
-                            if (pos != std::string::npos)
-                                testFileName = testFileName.substr(0, pos);
-
-                            path = path.getParentPath() / testFileName;
-                            if (!path.exists())
+                            const std::string strippedName = elementName + STRIPPED_SUFFIX;
+                            mx::StringVec strippedCode;
+                            context.getOptions().stripUnusedCode = true;
+                            const bool generatedStrippedCode = generateCode(context, strippedName, element, _logFile, _testStages, strippedCode);
+                            context.getOptions().stripUnusedCode = false;
+                            if (!generatedStrippedCode)
                             {
-                                path.createDirectory();
+                                _logFile << ">> Failed to generate stripped code for nodedef: " << nodeDefName << std::endl;
+                                codeGenerationFailures++;
                             }
-                        }
-                        else
-                        {
-                            mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
-                            path = searchPath.isEmpty() ? mx::FilePath() : searchPath[0];
-                        }
-
-                        std::vector<mx::FilePath> sourceCodePaths;
-                        if (sourceCode.size() > 1)
-                        {
-                            for (size_t i=0; i<sourceCode.size(); ++i)
+                            else
                             {
-                                const mx::FilePath filename = path / (elementName + elementNameSuffix + "." + _testStages[i] + "." + getFileExtensionForTarget(_shaderGenerator->getTarget()));
-                                sourceCodePaths.push_back(filename);
-                                std::ofstream file(filename.asString());
-                                _logFile << "Write source code: " << filename.asString() << std::endl;
-                                file << sourceCode[i];
-                                file.close();
+                                strippedValidationTime += writeAndCompileSource(doc, strippedName, elementNameSuffix, strippedCode);
                             }
                         }
-                        else
-                        {
-                            path = path / (elementName + "."  
-                                + _shaderGenerator->getTarget() 
-                                + "." + getFileExtensionForTarget(_shaderGenerator->getTarget())
-                                );
-                            sourceCodePaths.push_back(path);
-                            std::ofstream file(path.asString());
-                            _logFile << "Write source code: " << path.asString() << std::endl;
-                            std::cout << "Write source code: " << path.asString() << std::endl;
-                            file << sourceCode[0];
-                            file.close();
-                        }
-
-                        // Run compile test
-                        compileSource(sourceCodePaths);
                     }
                 }
                 else
@@ -891,6 +926,15 @@ void ShaderGeneratorTester::validate(const mx::GenOptions& generateOptions, cons
         CHECK(codeGenerationFailures == 0);
     }
 
+    if (_writeShadersToDisk)
+    {
+        _logFile << "Compile time: " << validationTime << " seconds" << std::endl;
+        if (validateStrippedCode)
+        {
+            _logFile << "Compile time with unused code stripped: " << strippedValidationTime << " seconds" << std::endl;
+        }
+    }
+
     if (options.checkImplCount)
     {
         _logFile << "---------------------------------------------------" << std::endl;
@@ -919,6 +963,7 @@ void TestSuiteOptions::print(std::ostream& output) const
         output << "Target: " << t << std::endl;
     }
     output << "\tCheck Implementation Usage Count: " << checkImplCount << std::endl;
+    output << "\tValidate Stripped Code: " << validateStrippedCode << std::endl;
     output << "\tDump Generated Code: " << dumpGeneratedCode << std::endl;
     output << "\tShader Interfaces: " << shaderInterfaces << std::endl;
     output << "\tRender Size: " << renderSize[0] << "," << renderSize[1] << std::endl;
@@ -946,6 +991,7 @@ bool TestSuiteOptions::readOptions(const std::string& optionFile)
     const std::string RENDER_SIZE_STRING("renderSize");
     const std::string DUMP_UNIFORMS_AND_ATTRIBUTES_STRING("dumpUniformsAndAttributes");
     const std::string CHECK_IMPL_COUNT_STRING("checkImplCount");
+    const std::string VALIDATE_STRIPPED_CODE_STRING("validateStrippedCode");
     const std::string DUMP_GENERATED_CODE_STRING("dumpGeneratedCode");
     const std::string RENDER_GEOMETRY_STRING("renderGeometry");
     const std::string ENABLE_DIRECT_LIGHTING("enableDirectLighting");
@@ -1010,6 +1056,10 @@ bool TestSuiteOptions::readOptions(const std::string& optionFile)
                     {
                         checkImplCount = val->asA<bool>();
                     }
+                    else if (name == VALIDATE_STRIPPED_CODE_STRING)
+                    {
+                        validateStrippedCode = val->asA<bool>();
+                    }
                     else if (name == DUMP_GENERATED_CODE_STRING)
                     {
                         dumpGeneratedCode = val->asA<bool>();
@@ -82,6 +82,9 @@ class TestSuiteOptions
     // Check the count of number of implementations used
     bool checkImplCount = true;
 
+    // Also generate and compile each shader with unused code stripped
+    bool validateStrippedCode = true;
+
     // Run using a set of interfaces:
     // - 3 = run complete + reduced.
     // - 2 = run complete only (default)
@@ -207,6 +210,11 @@ class ShaderGeneratorTester
     // Compile generated source code. Default implementation does nothing.
     virtual void compileSource(const std::vector<mx::FilePath>& /*sourceCodePaths*/) {};
 
+    // Write generated source code for the given element name to disk and compile it,
+    // returning the time in seconds spent compiling.
+    double writeAndCompileSource(mx::DocumentPtr doc, const std::string& elementName,
+                                 const std::string& elementNameSuffix, const mx::StringVec& sourceCode);
+
   protected:
     // Check to see that all implementations have been tested for a given
     // language.
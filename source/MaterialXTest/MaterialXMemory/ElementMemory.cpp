@@ -0,0 +1,127 @@
+//
+// Copyright Contributors to the MaterialX Project
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#define CATCH_CONFIG_MAIN
+
+// The replacement allocation functions below are implemented with malloc and
+// free, which GCC reports as mismatched once they are inlined.
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+    #pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+#include <MaterialXTest/External/Catch/catch.hpp>
+
+#include <MaterialXFormat/Util.h>
+#include <MaterialXFormat/XmlIo.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace mx = MaterialX;
+
+namespace
+{
+
+// Running totals of heap allocations, for the measurement of memory usage.
+std::atomic<size_t> heapAllocationCount(0);
+std::atomic<size_t> heapAllocationBytes(0);
+
+} // anonymous namespace
+
+// The global allocation functions are replaced for this executable only, so
+// that the allocations made by element trees can be counted.
+void* operator new(size_t size)
+{
+    heapAllocationCount.fetch_add(1, std::memory_order_relaxed);
+    heapAllocationBytes.fetch_add(size, std::memory_order_relaxed);
+    void* ptr = std::malloc(size ? size : 1);
+    if (!ptr)
+    {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+TEST_CASE("Element memory", "[memory]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+
+    // Load the data libraries and the materials corpus.
+    std::vector<mx::DocumentPtr> docs;
+    mx::DocumentPtr libs = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, libs);
+    docs.push_back(libs);
+    mx::FilePath materialsPath = searchPath.find("resources/Materials");
+    for (const mx::FilePath& dir : materialsPath.getSubDirectories())
+    {
+        for (const mx::FilePath& filename : dir.getFilesInDirectory(mx::MTLX_EXTENSION))
+        {
+            mx::DocumentPtr doc = mx::createDocument();
+            try
+            {
+                mx::readFromXmlFile(doc, dir / filename, searchPath);
+            }
+            catch (mx::Exception&)
+            {
+                continue;
+            }
+            docs.push_back(doc);
+        }
+    }
+
+    // Copy each document and report the heap allocations made per element.
+    // Copies allocate little beyond the elements themselves, so the totals
+    // approximate the memory held by the element trees.
+    std::vector<mx::DocumentPtr> copies;
+    const size_t startCount = heapAllocationCount.load();
+    const size_t startBytes = heapAllocationBytes.load();
+    for (mx::DocumentPtr doc : docs)
+    {
+        mx::DocumentPtr copy = mx::createDocument();
+        copy->copyContentFrom(doc);
+        copies.push_back(copy);
+    }
+    const size_t allocationCount = heapAllocationCount.load() - startCount;
+    const size_t allocationBytes = heapAllocationBytes.load() - startBytes;
+
+    size_t elementCount = 0;
+    for (mx::DocumentPtr copy : copies)
+    {
+        for (mx::ElementPtr elem : copy->traverseTree())
+        {
+            elementCount++;
+        }
+    }
+    REQUIRE(elementCount > 0);
+    WARN(std::to_string(elementCount) + " elements, " +
+         std::to_string((double) allocationBytes / elementCount) + " bytes per element, " +
+         std::to_string((double) allocationCount / elementCount) + " allocations per element");
+}
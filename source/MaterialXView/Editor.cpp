@@ -643,6 +643,7 @@ void PropertyEditor::updateContents(Viewer* viewer)
         mx::UIPropertyGroup groups;
         mx::UIPropertyGroup unnamedGroups;
         const std::string pathSeparator(":");
+        mx::StructTypeRegistry::Scope structTypeScope(&viewer->getGenContext().getShaderGenerator().getStructTypes());
         mx::createUIPropertyGroups(elem->getDocument(), *publicUniforms, groups, unnamedGroups, pathSeparator);
 
         // First add items with named groups.
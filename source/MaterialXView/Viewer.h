@@ -200,6 +200,12 @@ class Viewer : public ng::Screen
         return nullptr;
     }
 
+    // Return the generator context for the primary shading language.
+    mx::GenContext& getGenContext()
+    {
+        return _genContext;
+    }
+
     // Return the selected mesh partition.
     mx::MeshPartitionPtr getSelectedGeometry() const
     {
@@ -29,9 +29,17 @@ void bindPyDocument(py::module& mod)
     py::class_<mx::Document, mx::DocumentPtr, mx::GraphElement>(mod, "Document")
         .def("initialize", &mx::Document::initialize)
         .def("copy", &mx::Document::copy)
+        .def("createShallowClone", &mx::Document::createShallowClone)
         .def("setDataLibrary", &mx::Document::setDataLibrary)
         .def("getDataLibrary", &mx::Document::getDataLibrary)
         .def("hasDataLibrary", &mx::Document::hasDataLibrary)
+        .def("addDataLibrary", &mx::Document::addDataLibrary)
+        .def("setDataLibraries", &mx::Document::setDataLibraries)
+        .def("getDataLibraries", &mx::Document::getDataLibraries)
+        .def("addLayerXInclude", &mx::Document::addLayerXInclude)
+        .def("getLayerXIncludes", &mx::Document::getLayerXIncludes)
+        .def("getEditableChild", &mx::Document::getEditableChild)
+        .def("getEditableDescendant", &mx::Document::getEditableDescendant)
         .def("importLibrary", &mx::Document::importLibrary)
         .def("getReferencedSourceUris", &mx::Document::getReferencedSourceUris)
         .def("addNodeGraph", &mx::Document::addNodeGraph,
@@ -119,5 +127,32 @@ void bindPyDocument(py::module& mod)
         .def("getColorManagementSystem", &mx::Document::getColorManagementSystem)
         .def("setColorManagementConfig", &mx::Document::setColorManagementConfig)
         .def("hasColorManagementConfig", &mx::Document::hasColorManagementConfig)
-        .def("getColorManagementConfig", &mx::Document::getColorManagementConfig);
+        .def("getColorManagementConfig", &mx::Document::getColorManagementConfig)
+        .def("validate", [](const mx::Document& doc)
+            {
+                std::string message;
+                bool res = doc.validate(&message);
+                return std::pair<bool, std::string>(res, message);
+            })
+        .def("validate", [](const mx::Document& doc, const mx::ValidationOptions& options)
+            {
+                mx::ValidationDiagnostics diagnostics;
+                bool res = doc.validate(options, &diagnostics);
+                return std::pair<bool, mx::ValidationDiagnostics>(res, diagnostics);
+            })
+        .def("invalidateCache", &mx::Document::invalidateCache)
+        .def("freeze", &mx::Document::freeze)
+        .def("unfreeze", &mx::Document::unfreeze)
+        .def("isFrozen", &mx::Document::isFrozen);
+
+    py::class_<mx::ValidationOptions>(mod, "ValidationOptions")
+        .def_readwrite("workerCount", &mx::ValidationOptions::workerCount)
+        .def_readwrite("stopAtFirstError", &mx::ValidationOptions::stopAtFirstError)
+        .def(py::init<>());
+
+    py::class_<mx::ValidationDiagnostic>(mod, "ValidationDiagnostic")
+        .def_readwrite("elementPath", &mx::ValidationDiagnostic::elementPath)
+        .def_readwrite("rule", &mx::ValidationDiagnostic::rule)
+        .def_readwrite("message", &mx::ValidationDiagnostic::message)
+        .def(py::init<>());
 }
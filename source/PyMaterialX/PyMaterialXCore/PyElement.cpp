@@ -35,6 +35,8 @@ void bindPyElement(py::module& mod)
             bool res = elem.isEquivalent(rhs, options, &message);
             return std::pair<bool, std::string>(res, message);
         })        
+        .def("getContentHash", static_cast<size_t (mx::Element::*)(const mx::ElementEquivalenceOptions&) const>(&mx::Element::getContentHash))
+        .def("getContentHash", static_cast<size_t (mx::Element::*)() const>(&mx::Element::getContentHash))
         .def("setCategory", &mx::Element::setCategory)
         .def("getCategory", &mx::Element::getCategory)
         .def("setName", &mx::Element::setName)
@@ -218,6 +220,13 @@ void bindPyElement(py::module& mod)
         .def_readwrite("attributeExclusionList", &mx::ElementEquivalenceOptions::attributeExclusionList)
         .def(py::init<>());
 
+    py::class_<mx::ElementDiff>(mod, "ElementDiff")
+        .def_readwrite("added", &mx::ElementDiff::added)
+        .def_readwrite("removed", &mx::ElementDiff::removed)
+        .def_readwrite("modified", &mx::ElementDiff::modified)
+        .def("empty", &mx::ElementDiff::empty)
+        .def(py::init<>());
+
     py::class_<mx::StringResolver, mx::StringResolverPtr>(mod, "StringResolver")
         .def("setFilePrefix", &mx::StringResolver::setFilePrefix)
         .def("getFilePrefix", &mx::StringResolver::getFilePrefix)
@@ -237,4 +246,8 @@ void bindPyElement(py::module& mod)
 
     mod.def("targetStringsMatch", &mx::targetStringsMatch);
     mod.def("prettyPrint", &mx::prettyPrint);
+    mod.def("diffElements", &mx::diffElements,
+        py::arg("lhs"), py::arg("rhs"), py::arg("options") = mx::ElementEquivalenceOptions());
+    mod.def("resolveFilenames", &mx::resolveFilenames,
+        py::arg("root"), py::arg("geom") = mx::EMPTY_STRING);
 }
@@ -5,6 +5,7 @@
 
 #include <PyMaterialX/PyMaterialX.h>
 
+#include <MaterialXCore/GeomBinding.h>
 #include <MaterialXCore/Look.h>
 
 namespace py = pybind11;
@@ -83,4 +84,17 @@ void bindPyLook(py::module& mod)
 
     mod.def("getGeometryBindings", &mx::getGeometryBindings,
         py::arg("materialNode") , py::arg("geom") = mx::UNIVERSAL_GEOM_NAME);
+
+    py::class_<mx::GeomBindings>(mod, "GeomBindings")
+        .def_readonly("materialAssigns", &mx::GeomBindings::materialAssigns)
+        .def_readonly("propertyAssigns", &mx::GeomBindings::propertyAssigns)
+        .def_readonly("propertySetAssigns", &mx::GeomBindings::propertySetAssigns)
+        .def_readonly("visibilities", &mx::GeomBindings::visibilities)
+        .def_readonly("variantAssigns", &mx::GeomBindings::variantAssigns);
+
+    py::class_<mx::GeomBindingResolver, mx::GeomBindingResolverPtr>(mod, "GeomBindingResolver")
+        .def_static("create", &mx::GeomBindingResolver::create,
+            py::arg("doc"), py::arg("look") = nullptr)
+        .def("resolve", static_cast<mx::GeomBindings (mx::GeomBindingResolver::*)(const std::string&) const>(&mx::GeomBindingResolver::resolve))
+        .def("resolve", static_cast<std::vector<mx::GeomBindings> (mx::GeomBindingResolver::*)(const mx::StringVec&) const>(&mx::GeomBindingResolver::resolve));
 }
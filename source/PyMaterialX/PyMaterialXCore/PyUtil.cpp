@@ -23,6 +23,12 @@ void bindPyUtil(py::module& mod)
     mod.def("splitString", &mx::splitString);
     mod.def("joinStrings", &mx::joinStrings);
     mod.def("replaceSubstrings", &mx::replaceSubstrings);
+    py::class_<mx::SubstringReplacer>(mod, "SubstringReplacer")
+        .def(py::init<>())
+        .def(py::init<const mx::StringMap&>())
+        .def("addSubstitution", &mx::SubstringReplacer::addSubstitution)
+        .def("empty", &mx::SubstringReplacer::empty)
+        .def("apply", &mx::SubstringReplacer::apply);
     mod.def("stringStartsWith", &mx::stringStartsWith);
     mod.def("stringEndsWith", &mx::stringEndsWith);
     mod.def("splitNamePath", &mx::splitNamePath);
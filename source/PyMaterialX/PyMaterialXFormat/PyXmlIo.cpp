@@ -19,6 +19,7 @@ void bindPyXmlIo(py::module& mod)
         .def_readwrite("readComments", &mx::XmlReadOptions::readComments)
         .def_readwrite("readNewlines", &mx::XmlReadOptions::readNewlines)
         .def_readwrite("upgradeVersion", &mx::XmlReadOptions::upgradeVersion)        
+        .def_readwrite("memoryMapFiles", &mx::XmlReadOptions::memoryMapFiles)
         .def_readwrite("parentXIncludes", &mx::XmlReadOptions::parentXIncludes);
 
     py::class_<mx::XmlWriteOptions>(mod, "XmlWriteOptions")
@@ -15,6 +15,11 @@ void bindPyGenContext(py::module& mod)
 {
     py::class_<mx::ApplicationVariableHandler>(mod, "ApplicationVariableHandler");
 
+    py::class_<mx::SourceCodeCache, mx::SourceCodeCachePtr>(mod, "SourceCodeCache")
+        .def(py::init<>())
+        .def("getSource", &mx::SourceCodeCache::getSource)
+        .def("clear", &mx::SourceCodeCache::clear);
+
     py::class_<mx::GenContext, mx::GenContextPtr>(mod, "GenContext")
         .def(py::init<mx::ShaderGeneratorPtr>())
         .def("getShaderGenerator", &mx::GenContext::getShaderGenerator)
@@ -22,6 +27,9 @@ void bindPyGenContext(py::module& mod)
         .def("registerSourceCodeSearchPath", static_cast<void (mx::GenContext::*)(const mx::FilePath&)>(&mx::GenContext::registerSourceCodeSearchPath))
         .def("registerSourceCodeSearchPath", static_cast<void (mx::GenContext::*)(const mx::FileSearchPath&)>(&mx::GenContext::registerSourceCodeSearchPath))
         .def("resolveSourceFile", &mx::GenContext::resolveSourceFile)
+        .def("setSourceCodeCache", &mx::GenContext::setSourceCodeCache)
+        .def("getSourceCodeCache", &mx::GenContext::getSourceCodeCache)
+        .def("readSourceFile", &mx::GenContext::readSourceFile)
         .def("pushUserData", &mx::GenContext::pushUserData)
         .def("setApplicationVariableHandler", &mx::GenContext::setApplicationVariableHandler)
         .def("getApplicationVariableHandler", &mx::GenContext::getApplicationVariableHandler);
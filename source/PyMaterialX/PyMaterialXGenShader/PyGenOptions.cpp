@@ -31,6 +31,7 @@ void bindPyGenOptions(py::module& mod)
         .def_readwrite("addUpstreamDependencies", &mx::GenOptions::addUpstreamDependencies)
         .def_readwrite("libraryPrefix", &mx::GenOptions::libraryPrefix)        
         .def_readwrite("emitColorTransforms", &mx::GenOptions::emitColorTransforms)
+        .def_readwrite("stripUnusedCode", &mx::GenOptions::stripUnusedCode)
         .def_readwrite("hwTransparency", &mx::GenOptions::hwTransparency)
         .def_readwrite("hwSpecularEnvironmentMethod", &mx::GenOptions::hwSpecularEnvironmentMethod)
         .def_readwrite("hwSrgbEncodeOutput", &mx::GenOptions::hwSrgbEncodeOutput)
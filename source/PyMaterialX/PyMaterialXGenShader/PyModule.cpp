@@ -10,6 +10,7 @@ namespace py = pybind11;
 void bindPyColorManagement(py::module& mod);
 void bindPyShaderPort(py::module& mod);
 void bindPyShader(py::module& mod);
+void bindPyShaderCache(py::module& mod);
 void bindPyShaderGenerator(py::module& mod);
 void bindPyGenContext(py::module& mod);
 void bindPyHwShaderGenerator(py::module& mod);
@@ -31,6 +32,7 @@ PYBIND11_MODULE(PyMaterialXGenShader, mod)
     bindPyShader(mod);
     bindPyShaderGenerator(mod);
     bindPyGenContext(mod);
+    bindPyShaderCache(mod);
     bindPyHwShaderGenerator(mod);
     bindPyGenOptions(mod);
     bindPyGenUserData(mod);
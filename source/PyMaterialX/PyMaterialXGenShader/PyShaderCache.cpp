@@ -0,0 +1,35 @@
+//
+// Copyright Contributors to the MaterialX Project
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <PyMaterialX/PyMaterialX.h>
+
+#include <MaterialXGenShader/GenContext.h>
+#include <MaterialXGenShader/ShaderCache.h>
+
+namespace py = pybind11;
+namespace mx = MaterialX;
+
+void bindPyShaderCache(py::module& mod)
+{
+    py::class_<mx::ShaderCache::Statistics>(mod, "ShaderCacheStatistics")
+        .def_readonly("memoryHits", &mx::ShaderCache::Statistics::memoryHits)
+        .def_readonly("diskHits", &mx::ShaderCache::Statistics::diskHits)
+        .def_readonly("misses", &mx::ShaderCache::Statistics::misses)
+        .def_readonly("savedTime", &mx::ShaderCache::Statistics::savedTime)
+        .def("getHitRate", &mx::ShaderCache::Statistics::getHitRate);
+
+    py::class_<mx::ShaderCache, mx::ShaderCachePtr>(mod, "ShaderCache")
+        .def_static("create", &mx::ShaderCache::create,
+            py::arg("capacity") = mx::ShaderCache::DEFAULT_CAPACITY)
+        .def("setCapacity", &mx::ShaderCache::setCapacity)
+        .def("getCapacity", &mx::ShaderCache::getCapacity)
+        .def("setCacheDirectory", &mx::ShaderCache::setCacheDirectory)
+        .def("getCacheDirectory", &mx::ShaderCache::getCacheDirectory)
+        .def("generate", &mx::ShaderCache::generate)
+        .def("getStatistics", &mx::ShaderCache::getStatistics)
+        .def("resetStatistics", &mx::ShaderCache::resetStatistics)
+        .def("clear", &mx::ShaderCache::clear)
+        .def("size", &mx::ShaderCache::size);
+}
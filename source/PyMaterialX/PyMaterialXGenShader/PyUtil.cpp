@@ -6,6 +6,8 @@
 #include <PyMaterialX/PyMaterialX.h>
 
 #include <MaterialXGenShader/Util.h>
+#include <MaterialXGenShader/GenContext.h>
+#include <MaterialXGenShader/Shader.h>
 #include <MaterialXGenShader/ShaderGenerator.h>
 
 namespace py = pybind11;
@@ -24,12 +26,21 @@ std::vector<mx::TypedElementPtr> findRenderableElements(mx::ConstDocumentPtr doc
 
 void bindPyUtil(py::module& mod)
 {
+    py::class_<mx::BatchShaderResult>(mod, "BatchShaderResult")
+        .def_readonly("element", &mx::BatchShaderResult::element)
+        .def_readonly("shader", &mx::BatchShaderResult::shader)
+        .def_readonly("error", &mx::BatchShaderResult::error)
+        .def_readonly("generationTime", &mx::BatchShaderResult::generationTime);
+
     mod.def("isTransparentSurface", &mx::isTransparentSurface);
     mod.def("mapValueToColor", &mx::mapValueToColor);
     mod.def("requiresImplementation", &mx::requiresImplementation);
     mod.def("elementRequiresShading", &mx::elementRequiresShading);
     mod.def("findRenderableMaterialNodes", &findRenderableMaterialNodes);
     mod.def("findRenderableElements", &findRenderableElements, py::arg("doc"), py::arg("includeReferencedGraphs") = false);
+    mod.def("generateBatch", &mx::generateBatch,
+        py::arg("elements"), py::arg("contextFactory"), py::arg("workerCount") = 0,
+        py::call_guard<py::gil_scoped_release>());
     mod.def("getNodeDefInput", &mx::getNodeDefInput);
     mod.def("tokenSubstitution", &mx::tokenSubstitution);
     mod.def("getUdimCoordinates", &mx::getUdimCoordinates);